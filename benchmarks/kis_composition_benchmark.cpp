@@ -33,8 +33,11 @@
 #endif
 
 #include <KoOptimizedCompositeOpOver32.h>
+#include <KoOptimizedCompositeOpOver64.h>
 #include <KoOptimizedCompositeOpOver128.h>
 #include <KoOptimizedCompositeOpAlphaDarken32.h>
+#include <KoOptimizedCompositeOpAlphaDarken64.h>
+#include <KoOptimizedCompositeOpGeneric.h>
 #endif
 
 #include "kis_composition_benchmark.h"
@@ -47,6 +50,7 @@
 #include <KoColorSpaceTraits.h>
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
+#include <KoCompositeOpGeneric.h>
 #include "KoOptimizedCompositeOpFactory.h"
 
 // for posix_memalign()
@@ -127,6 +131,27 @@ struct RandomGenerator<quint8>
     boost::mt11213b m_rnd;
 };
 
+template <>
+struct RandomGenerator<quint16>
+{
+    RandomGenerator(int seed)
+        : m_smallint(0,65535),
+          m_rnd(seed)
+    {
+    }
+
+    quint16 operator() () {
+        return m_smallint(m_rnd);
+    }
+
+    quint16 unit() {
+        return KoColorSpaceMathsTraits<quint16>::unitValue;
+    }
+
+    boost::uniform_smallint<int> m_smallint;
+    boost::mt11213b m_rnd;
+};
+
 template <>
 struct RandomGenerator<float>
 {
@@ -255,6 +280,8 @@ QVector<Tile> generateTiles(int size,
 
         if (pixelSize == 4) {
             generateDataLine<quint8>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+        } else if (pixelSize == 8) {
+            generateDataLine<quint16>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
         } else if (pixelSize == 16) {
             generateDataLine<float>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
         } else {
@@ -354,6 +381,9 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     if (pixelSize == 4) {
         compareResult = compareTwoOpsPixels<quint8>(tiles, 10);
     }
+    else if (pixelSize == 8) {
+        compareResult = compareTwoOpsPixels<quint16>(tiles, 256);
+    }
     else if (pixelSize == 16) {
         compareResult = compareTwoOpsPixels<float>(tiles, 2e-7);
     }
@@ -521,6 +551,10 @@ void checkRounding(qreal opacity, qreal flow, qreal averageOpacity = -1, quint32
                     }
                 }
             }
+            else if (pixelSize == 8) {
+                // Vc::round() and the scalar +0.5 may disagree in the last bit
+                compareResult = comparePixels<quint16>(reinterpret_cast<quint16*>(dst1), reinterpret_cast<quint16*>(dst2), 1);
+            }
             else if (pixelSize == 16) {
                 compareResult = comparePixels<float>(reinterpret_cast<float*>(dst1), reinterpret_cast<float*>(dst2), 0);
             }
@@ -624,6 +658,20 @@ void KisCompositionBenchmark::checkRoundingAlphaDarkenF32_05_10_08()
 #endif
 }
 
+void KisCompositionBenchmark::checkRoundingAlphaDarkenU16_05_03()
+{
+#ifdef HAVE_VC
+    checkRounding<AlphaDarkenCompositor64<quint16, quint64> >(0.5, 0.3, -1, 8);
+#endif
+}
+
+void KisCompositionBenchmark::checkRoundingAlphaDarkenU16_05_10_08()
+{
+#ifdef HAVE_VC
+    checkRounding<AlphaDarkenCompositor64<quint16, quint64> >(0.5, 1.0, 0.8, 8);
+#endif
+}
+
 void KisCompositionBenchmark::checkRoundingOver()
 {
 #ifdef HAVE_VC
@@ -638,6 +686,13 @@ void KisCompositionBenchmark::checkRoundingOverRgbaF32()
 #endif
 }
 
+void KisCompositionBenchmark::checkRoundingOverRgbaU16()
+{
+#ifdef HAVE_VC
+    checkRounding<OverCompositor64<quint16, quint64, false, true> >(0.5, 0.3, -1, 8);
+#endif
+}
+
 void KisCompositionBenchmark::compareAlphaDarkenOps()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -662,6 +717,19 @@ void KisCompositionBenchmark::compareRgbF32AlphaDarkenOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbU16AlphaDarkenOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(cs);
+    KoCompositeOp *opExp = new KoCompositeOpAlphaDarken<KoBgrU16Traits>(cs);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+}
+
 void KisCompositionBenchmark::compareAlphaDarkenOpsNoMask()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -710,6 +778,90 @@ void KisCompositionBenchmark::compareRgbF32OverOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbU16OverOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createOverOp64(cs);
+    KoCompositeOp *opExp = new KoCompositeOpOver<KoBgrU16Traits>(cs);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+}
+
+KoCompositeOp* createOptimizedGenericOp(const KoColorSpace *cs, const QString &id)
+{
+    switch (cs->pixelSize()) {
+    case 4:
+        return KoOptimizedCompositeOpFactory::createGenericOp32(cs, id, id, KoCompositeOp::categoryMix());
+    case 8:
+        return KoOptimizedCompositeOpFactory::createGenericOp64(cs, id, id, KoCompositeOp::categoryMix());
+    case 16:
+        return KoOptimizedCompositeOpFactory::createGenericOp128(cs, id, id, KoCompositeOp::categoryMix());
+    default:
+        qFatal("Pixel size %i is not implemented", cs->pixelSize());
+    }
+
+    return 0;
+}
+
+bool haveOptimizedGenericOps(const QString &id)
+{
+    KoCompositeOp *op = createOptimizedGenericOp(KoColorSpaceRegistry::instance()->rgb8(), id);
+    const bool result = op;
+    delete op;
+    return result;
+}
+
+template<class Traits, typename Traits::channels_type compositeFunc(typename Traits::channels_type, typename Traits::channels_type)>
+void compareGenericOps(const KoColorSpace *cs, const QString &id)
+{
+    KoCompositeOp *opAct = createOptimizedGenericOp(cs, id);
+    KoCompositeOp *opExp = new KoCompositeOpGenericSC<Traits, compositeFunc>(cs, id, id, KoCompositeOp::categoryMix());
+
+    QVERIFY(opAct);
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+}
+
+void KisCompositionBenchmark::compareMultiplyOps()
+{
+    if (!haveOptimizedGenericOps(COMPOSITE_MULT)) {
+        QSKIP("Vectorization is not available");
+    }
+
+    compareGenericOps<KoBgrU8Traits, &cfMultiply<quint8> >(KoColorSpaceRegistry::instance()->rgb8(), COMPOSITE_MULT);
+    compareGenericOps<KoBgrU16Traits, &cfMultiply<quint16> >(KoColorSpaceRegistry::instance()->rgb16(), COMPOSITE_MULT);
+    compareGenericOps<KoRgbF32Traits, &cfMultiply<float> >(KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""), COMPOSITE_MULT);
+}
+
+void KisCompositionBenchmark::compareOverlayOps()
+{
+    if (!haveOptimizedGenericOps(COMPOSITE_OVERLAY)) {
+        QSKIP("Vectorization is not available");
+    }
+
+    compareGenericOps<KoBgrU8Traits, &cfOverlay<quint8> >(KoColorSpaceRegistry::instance()->rgb8(), COMPOSITE_OVERLAY);
+    compareGenericOps<KoBgrU16Traits, &cfOverlay<quint16> >(KoColorSpaceRegistry::instance()->rgb16(), COMPOSITE_OVERLAY);
+    compareGenericOps<KoRgbF32Traits, &cfOverlay<float> >(KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""), COMPOSITE_OVERLAY);
+}
+
+void KisCompositionBenchmark::compareColorDodgeOps()
+{
+    if (!haveOptimizedGenericOps(COMPOSITE_DODGE)) {
+        QSKIP("Vectorization is not available");
+    }
+
+    compareGenericOps<KoBgrU8Traits, &cfColorDodge<quint8> >(KoColorSpaceRegistry::instance()->rgb8(), COMPOSITE_DODGE);
+    compareGenericOps<KoBgrU16Traits, &cfColorDodge<quint16> >(KoColorSpaceRegistry::instance()->rgb16(), COMPOSITE_DODGE);
+    compareGenericOps<KoRgbF32Traits, &cfColorDodge<float> >(KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", ""), COMPOSITE_DODGE);
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -742,6 +894,38 @@ void KisCompositionBenchmark::testRgb8CompositeOverOptimized()
     delete op;
 }
 
+void KisCompositionBenchmark::testRgb16CompositeAlphaDarkenLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = new KoCompositeOpAlphaDarken<KoBgrU16Traits>(cs);
+    benchmarkCompositeOp(op, "RGB16 Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb16CompositeAlphaDarkenOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(cs);
+    benchmarkCompositeOp(op, "RGB16 Optimized");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb16CompositeOverLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = new KoCompositeOpOver<KoBgrU16Traits>(cs);
+    benchmarkCompositeOp(op, "RGB16 Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb16CompositeOverOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createOverOp64(cs);
+    benchmarkCompositeOp(op, "RGB16 Optimized");
+    delete op;
+}
+
 void KisCompositionBenchmark::testRgbF32CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
@@ -774,6 +958,57 @@ void KisCompositionBenchmark::testRgbF32CompositeOverOptimized()
     delete op;
 }
 
+void KisCompositionBenchmark::testRgb8CompositeMultiplyLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *op = new KoCompositeOpGenericSC<KoBgrU8Traits, &cfMultiply<quint8> >(cs, COMPOSITE_MULT, "Multiply", KoCompositeOp::categoryArithmetic());
+    benchmarkCompositeOp(op, "Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb8CompositeMultiplyOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createGenericOp32(cs, COMPOSITE_MULT, "Multiply", KoCompositeOp::categoryArithmetic());
+    if (!op) QSKIP("Vectorization is not available");
+    benchmarkCompositeOp(op, "Optimized");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb8CompositeOverlayLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *op = new KoCompositeOpGenericSC<KoBgrU8Traits, &cfOverlay<quint8> >(cs, COMPOSITE_OVERLAY, "Overlay", KoCompositeOp::categoryMix());
+    benchmarkCompositeOp(op, "Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgb8CompositeOverlayOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createGenericOp32(cs, COMPOSITE_OVERLAY, "Overlay", KoCompositeOp::categoryMix());
+    if (!op) QSKIP("Vectorization is not available");
+    benchmarkCompositeOp(op, "Optimized");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeOverlayLegacy()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    KoCompositeOp *op = new KoCompositeOpGenericSC<KoRgbF32Traits, &cfOverlay<float> >(cs, COMPOSITE_OVERLAY, "Overlay", KoCompositeOp::categoryMix());
+    benchmarkCompositeOp(op, "RGBF32 Legacy");
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeOverlayOptimized()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createGenericOp128(cs, COMPOSITE_OVERLAY, "Overlay", KoCompositeOp::categoryMix());
+    if (!op) QSKIP("Vectorization is not available");
+    benchmarkCompositeOp(op, "RGBF32 Optimized");
+    delete op;
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenReal_Aligned()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -36,15 +36,24 @@ private Q_SLOTS:
     void checkRoundingAlphaDarkenF32_05_10();
     void checkRoundingAlphaDarkenF32_05_10_08();
 
+    void checkRoundingAlphaDarkenU16_05_03();
+    void checkRoundingAlphaDarkenU16_05_10_08();
+
     void checkRoundingOver();
+    void checkRoundingOverRgbaU16();
     void checkRoundingOverRgbaF32();
 
     void compareAlphaDarkenOps();
     void compareAlphaDarkenOpsNoMask();
+    void compareRgbU16AlphaDarkenOps();
     void compareRgbF32AlphaDarkenOps();
     void compareOverOps();
     void compareOverOpsNoMask();
+    void compareRgbU16OverOps();
     void compareRgbF32OverOps();
+    void compareMultiplyOps();
+    void compareOverlayOps();
+    void compareColorDodgeOps();
 
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
@@ -52,12 +61,27 @@ private Q_SLOTS:
     void testRgb8CompositeOverLegacy();
     void testRgb8CompositeOverOptimized();
 
+    void testRgb16CompositeAlphaDarkenLegacy();
+    void testRgb16CompositeAlphaDarkenOptimized();
+
+    void testRgb16CompositeOverLegacy();
+    void testRgb16CompositeOverOptimized();
+
     void testRgbF32CompositeAlphaDarkenLegacy();
     void testRgbF32CompositeAlphaDarkenOptimized();
 
     void testRgbF32CompositeOverLegacy();
     void testRgbF32CompositeOverOptimized();
 
+    void testRgb8CompositeMultiplyLegacy();
+    void testRgb8CompositeMultiplyOptimized();
+
+    void testRgb8CompositeOverlayLegacy();
+    void testRgb8CompositeOverlayOptimized();
+
+    void testRgbF32CompositeOverlayLegacy();
+    void testRgbF32CompositeOverlayOptimized();
+
     void testRgb8CompositeAlphaDarkenReal_Aligned();
     void testRgb8CompositeOverReal_Aligned();
 
@@ -327,6 +327,18 @@ void KisStrokeBenchmark::colorsmudgeRL()
     benchmarkStroke(presetFileName);
 }
 
+void KisStrokeBenchmark::sketchSimpleLongStroke()
+{
+    QString presetFileName = "sketch-simple.kpp";
+    benchmarkLongStroke(presetFileName);
+}
+
+void KisStrokeBenchmark::sketchMaskLongStroke()
+{
+    QString presetFileName = "sketch-mask.kpp";
+    benchmarkLongStroke(presetFileName);
+}
+
 /*
 void KisStrokeBenchmark::predefinedBrush()
 {
@@ -487,6 +499,52 @@ void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
 #endif
 }
 
+/**
+ * A scribble of LONG_STROKE_POINTS short segments winding over the
+ * image, so that the paintops keeping the stroke history (e.g. the
+ * sketch one) get a lot of points to look through
+ */
+static const int LONG_STROKE_POINTS = 12000;
+
+void KisStrokeBenchmark::benchmarkLongStroke(QString presetFileName)
+{
+    KisPaintOpPresetSP preset = new KisPaintOpPreset(m_dataPath + presetFileName);
+    bool loadedOk = preset->load();
+    if (!loadedOk){
+        dbgKrita << "The preset was not loaded correctly. Done.";
+        return;
+    } else {
+        dbgKrita << "preset : " << presetFileName;
+    }
+
+    const QPointF center(0.5 * m_image->width(), 0.5 * m_image->height());
+    const qreal maxRadius = 0.45 * qMin(m_image->width(), m_image->height());
+
+    QVector<QPointF> points;
+    srand48(0);
+    for (int i = 0; i < LONG_STROKE_POINTS; i++) {
+        const qreal angle = i * 0.05;
+        const qreal radius = maxRadius * (0.2 + 0.8 * qAbs(sin(i * 0.001))) + 10.0 * drand48();
+        points.append(center + radius * QPointF(cos(angle), sin(angle)));
+    }
+
+    QBENCHMARK{
+        // recreate the paintop to start with an empty stroke history
+        m_painter->setPaintOpPreset(preset, m_layer, m_image);
+
+        KisDistanceInformation currentDistance;
+        for (int i = 1; i < points.size(); i++) {
+            KisPaintInformation pi1(points[i - 1], 0.5);
+            KisPaintInformation pi2(points[i], 0.5);
+            m_painter->paintLine(pi1, pi2, &currentDistance);
+        }
+    }
+
+#ifdef SAVE_OUTPUT
+    m_layer->paintDevice()->convertToQImage(0).save(m_outputPath + presetFileName + "_longStroke" + OUTPUT_FORMAT);
+#endif
+}
+
 static const int COUNT = 1000000;
 void KisStrokeBenchmark::benchmarkRand48()
 {
@@ -62,6 +62,7 @@ private:
         inline void benchmarkStroke(QString presetFileName);
         inline void benchmarkLine(QString presetFileName);
         inline void benchmarkCircle(QString presetFileName);
+        inline void benchmarkLongStroke(QString presetFileName);
 
 private Q_SLOTS:
     void initTestCase();
@@ -120,6 +121,9 @@ private Q_SLOTS:
 
     void colorsmudge();
     void colorsmudgeRL();
+
+    void sketchSimpleLongStroke();
+    void sketchMaskLongStroke();
 /*
     void predefinedBrush();
     void predefinedBrushRL();
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tile_hash_table_benchmark.h"
+
+#include <QTest>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QScopedPointer>
+
+#include <tiles3/kis_tiled_data_manager.h>
+#include <tiles3/kis_tile_data_store.h>
+
+
+/**
+ * 256x256 tiles is a 16k x 16k RGBA image
+ */
+#define NUM_COLS 256
+#define NUM_ROWS 256
+#define PIXEL_SIZE 4
+
+class HashTableAccessJob : public QRunnable
+{
+public:
+    enum AccessType {
+        CREATE,
+        LOOKUP,
+        MIXED
+    };
+
+public:
+    HashTableAccessJob(KisTileHashTable *ht, AccessType type,
+                       qint32 threadIndex, qint32 numThreads)
+        : m_ht(ht),
+          m_type(type),
+          m_threadIndex(threadIndex),
+          m_numThreads(numThreads)
+    {
+    }
+
+    void run() {
+        bool newTile;
+
+        /**
+         * The threads walk interleaved rows, which is the way
+         * the update scheduler splits the dirty areas between
+         * the painting workers
+         */
+        for (qint32 row = m_threadIndex; row < NUM_ROWS; row += m_numThreads) {
+            for (qint32 col = 0; col < NUM_COLS; col++) {
+                switch (m_type) {
+                case CREATE:
+                    m_ht->getTileLazy(col, row, newTile);
+                    break;
+                case LOOKUP:
+                    m_ht->getExistedTile(col, row);
+                    break;
+                case MIXED:
+                    if (col & 0x1) {
+                        m_ht->getTileLazy(col, row, newTile);
+                    } else {
+                        m_ht->getReadOnlyTileLazy(col, row);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    KisTileHashTable *m_ht;
+    AccessType m_type;
+    qint32 m_threadIndex;
+    qint32 m_numThreads;
+};
+
+/**
+ * The benchmarks keep their own reference to the default tile data,
+ * so it is returned to the store when the benchmark finishes, after
+ * the hash table is gone
+ */
+struct TileDataReleaser {
+    static inline void cleanup(KisTileData *td) {
+        if (td) {
+            td->release();
+        }
+    }
+};
+
+typedef QScopedPointer<KisTileData, TileDataReleaser> KisTileDataScopedRef;
+
+KisTileData* createDefaultTileData()
+{
+    quint8 defaultPixel[PIXEL_SIZE];
+    memset(defaultPixel, 0, PIXEL_SIZE);
+
+    KisTileData *td = KisTileDataStore::instance()->createDefaultTileData(PIXEL_SIZE, defaultPixel);
+    td->acquire();
+    return td;
+}
+
+void runAccessJobs(KisTileHashTable *ht,
+                   HashTableAccessJob::AccessType type,
+                   qint32 numThreads)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    for (qint32 i = 0; i < numThreads; i++) {
+        pool.start(new HashTableAccessJob(ht, type, i, numThreads));
+    }
+
+    pool.waitForDone();
+}
+
+void KisTileHashTableBenchmark::addThreadsData()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+}
+
+void KisTileHashTableBenchmark::benchmarkCreateTiles_data()
+{
+    addThreadsData();
+}
+
+void KisTileHashTableBenchmark::benchmarkCreateTiles()
+{
+    QFETCH(int, numThreads);
+
+    KisTileDataScopedRef defaultTileData(createDefaultTileData());
+    KisTileHashTable ht(0);
+    ht.setDefaultTileData(defaultTileData.data());
+
+    QBENCHMARK {
+        ht.clear();
+        runAccessJobs(&ht, HashTableAccessJob::CREATE, numThreads);
+    }
+
+    QCOMPARE(ht.numTiles(), NUM_COLS * NUM_ROWS);
+}
+
+void KisTileHashTableBenchmark::benchmarkLookupTiles_data()
+{
+    addThreadsData();
+}
+
+void KisTileHashTableBenchmark::benchmarkLookupTiles()
+{
+    QFETCH(int, numThreads);
+
+    KisTileDataScopedRef defaultTileData(createDefaultTileData());
+    KisTileHashTable ht(0);
+    ht.setDefaultTileData(defaultTileData.data());
+    runAccessJobs(&ht, HashTableAccessJob::CREATE, 1);
+
+    QBENCHMARK {
+        runAccessJobs(&ht, HashTableAccessJob::LOOKUP, numThreads);
+    }
+}
+
+void KisTileHashTableBenchmark::benchmarkMixedAccess_data()
+{
+    addThreadsData();
+}
+
+void KisTileHashTableBenchmark::benchmarkMixedAccess()
+{
+    QFETCH(int, numThreads);
+
+    KisTileDataScopedRef defaultTileData(createDefaultTileData());
+    KisTileHashTable ht(0);
+    ht.setDefaultTileData(defaultTileData.data());
+
+    QBENCHMARK {
+        ht.clear();
+        runAccessJobs(&ht, HashTableAccessJob::MIXED, numThreads);
+    }
+}
+
+QTEST_MAIN(KisTileHashTableBenchmark)
@@ -0,0 +1,7 @@
+/* config-compression.h.  Generated by cmake from config-compression.h.cmake */
+
+/* Define if you have lz4, the fast LZ77 compression library */
+#cmakedefine HAVE_LZ4 1
+
+/* Define if you have zstd, the Zstandard compression library */
+#cmakedefine HAVE_ZSTD 1
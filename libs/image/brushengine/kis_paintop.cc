@@ -160,6 +160,14 @@ void KisPaintOp::paintAt(const KisPaintInformation& info, KisDistanceInformation
     pi.paintAt(*this, currentDistance);
 }
 
+void KisPaintOp::beginDabBatch()
+{
+}
+
+void KisPaintOp::endDabBatch()
+{
+}
+
 KisPainter* KisPaintOp::painter() const
 {
     return d->painter;
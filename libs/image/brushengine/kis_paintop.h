@@ -84,6 +84,17 @@ public:
                                   KisDistanceInformation *currentDistance);
 
 
+    /**
+     * Dab batching. Between beginDabBatch() and endDabBatch() the
+     * paintop is allowed to render its dabs asynchronously and
+     * composite them later, endDabBatch() composites everything that
+     * is still pending. The stroke strategies wrap every stroke job
+     * into a batch, outside of a batch the dabs must be painted right
+     * away. The default implementation does nothing.
+     */
+    virtual void beginDabBatch();
+    virtual void endDabBatch();
+
     /**
     * Whether this paintop can paint. Can be false in case that some setting isn't read correctly.
     * @return if paintop is ready for painting, default is true
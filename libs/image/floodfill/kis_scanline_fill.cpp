@@ -105,6 +105,10 @@ public:
         return m_colorSpace->difference(m_srcPixelPtr, pixelPtr);
     }
 
+    ALWAYS_INLINE void calculateDifferences(quint8 *pixelPtr, quint8 *diffs, int numPixels) {
+        m_colorSpace->differences(m_srcPixelPtr, pixelPtr, diffs, numPixels);
+    }
+
 private:
     const KoColorSpace *m_colorSpace;
     KoColor m_srcPixel;
@@ -141,6 +145,31 @@ public:
         return result;
     }
 
+    /**
+     * If all the pixels are already cached, take the values from the
+     * hash, otherwise calculate the whole row in one batch
+     */
+    ALWAYS_INLINE void calculateDifferences(quint8 *pixelPtr, quint8 *diffs, int numPixels) {
+        const HashKeyType *keys = reinterpret_cast<const HashKeyType*>(pixelPtr);
+
+        int i = 0;
+        for (; i < numPixels; i++) {
+            typename HashType::const_iterator it = m_differences.constFind(keys[i]);
+            if (it == m_differences.constEnd()) break;
+            diffs[i] = *it;
+        }
+
+        if (i < numPixels) {
+            m_colorSpace->differences(m_srcPixelPtr,
+                                      pixelPtr + i * sizeof(HashKeyType),
+                                      diffs + i, numPixels - i);
+
+            for (; i < numPixels; i++) {
+                m_differences.insert(keys[i], diffs[i]);
+            }
+        }
+    }
+
 private:
     HashType m_differences;
 
@@ -166,8 +195,19 @@ public:
     }
 
     ALWAYS_INLINE quint8 calculateOpacity(quint8* pixelPtr) {
-        quint8 diff = this->calculateDifference(pixelPtr);
+        return differenceToOpacity(this->calculateDifference(pixelPtr));
+    }
+
+    ALWAYS_INLINE void calculateOpacities(quint8 *pixelPtr, quint8 *opacities, int numPixels) {
+        this->calculateDifferences(pixelPtr, opacities, numPixels);
+
+        for (int i = 0; i < numPixels; i++) {
+            opacities[i] = differenceToOpacity(opacities[i]);
+        }
+    }
 
+private:
+    ALWAYS_INLINE quint8 differenceToOpacity(quint8 diff) const {
         if (!useSmoothSelection) {
             return diff <= m_threshold ? MAX_SELECTED : MIN_SELECTED;
         } else {
@@ -200,6 +240,8 @@ struct Q_DECL_HIDDEN KisScanlineFill::Private
     KisFillIntervalMap backwardMap;
     QStack<KisFillInterval> forwardStack;
 
+    QVector<quint8> opacities;
+
 
     inline void swapDirection() {
         rowIncrement *= -1;
@@ -303,6 +345,7 @@ void KisScanlineFill::processLine(KisFillInterval interval, const int rowIncreme
 
     int numPixelsLeft = 0;
     quint8 *dataPtr = 0;
+    quint8 *opacityPtr = 0;
     const int pixelSize = m_d->device->pixelSize();
 
     while(x <= lastX) {
@@ -310,15 +353,28 @@ void KisScanlineFill::processLine(KisFillInterval interval, const int rowIncreme
         // methods too often
         if (numPixelsLeft <= 0) {
             pixelPolicy.m_srcIt->moveTo(x, row);
-            numPixelsLeft = pixelPolicy.m_srcIt->numContiguousColumns(x) - 1;
+            const int numPixels = qMin(pixelPolicy.m_srcIt->numContiguousColumns(x), lastX - x + 1);
+            numPixelsLeft = numPixels - 1;
             dataPtr = const_cast<quint8*>(pixelPolicy.m_srcIt->rawDataConst());
+
+            /**
+             * The pixels of the current row are filled only after they
+             * have been checked, so the opacities of the whole
+             * contiguous chunk can be calculated in one batch
+             */
+            if (m_d->opacities.size() < numPixels) {
+                m_d->opacities.resize(numPixels);
+            }
+            opacityPtr = m_d->opacities.data();
+            pixelPolicy.calculateOpacities(dataPtr, opacityPtr, numPixels);
         } else {
             numPixelsLeft--;
             dataPtr += pixelSize;
+            opacityPtr++;
         }
 
         quint8 *pixelPtr = dataPtr;
-        quint8 opacity = pixelPolicy.calculateOpacity(pixelPtr);
+        quint8 opacity = *opacityPtr;
 
         if (opacity) {
             if (!currentForwardInterval.isValid()) {
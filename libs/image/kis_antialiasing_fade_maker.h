@@ -21,6 +21,8 @@
 
 #include "kis_global.h"
 
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
 template <class BaseFade>
 class KisAntialiasingFadeMaker1D
 {
@@ -83,6 +85,36 @@ public:
         return false;
     }
 
+#if defined HAVE_VC
+    /**
+     * Vectorized version of needFade(). The faded values are written
+     * into \p value normalized into 0...1 range, the returned mask
+     * marks the lanes that have got their final value. The methods
+     * are templated by the implementation to keep the code compiled
+     * for different architectures apart.
+     */
+    template<Vc::Implementation _impl>
+    Vc::float_m needFade(Vc::float_v::AsArg dist, Vc::float_v &value) const {
+        const Vc::float_v vOne(Vc::One);
+
+        Vc::float_m outsideMask = dist > Vc::float_v(m_radius);
+        value(outsideMask) = vOne;
+
+        if (!m_enableAntialiasing) {
+            return outsideMask;
+        }
+
+        Vc::float_m fadeMask = (dist > Vc::float_v(m_antialiasingFadeStart)) && !outsideMask;
+
+        value(fadeMask) =
+            (Vc::float_v(m_fadeStartValue) +
+             (dist - Vc::float_v(m_antialiasingFadeStart)) * Vc::float_v(m_antialiasingFadeCoeff)) *
+            Vc::float_v(1.0f / 255.0f);
+
+        return outsideMask || fadeMask;
+    }
+#endif /* defined HAVE_VC */
+
 private:
     qreal m_radius;
     quint8 m_fadeStartValue;
@@ -174,6 +206,35 @@ public:
         return false;
     }
 
+#if defined HAVE_VC
+    /**
+     * Vectorized version of needFade(). \p x and \p y should be
+     * absolute values. Returns the mask of the lanes lying outside
+     * the limits, the caller should fill them with 1.0.
+     */
+    template<Vc::Implementation _impl>
+    Vc::float_m outsideMask(Vc::float_v::AsArg x, Vc::float_v::AsArg y) const {
+        return x > Vc::float_v(m_xLimit) || y > Vc::float_v(m_yLimit);
+    }
+
+    /**
+     * Applies the antialiasing fade to the base values \p value
+     * normalized into 0...1 range
+     */
+    template<Vc::Implementation _impl>
+    void applyFade(Vc::float_v::AsArg x, Vc::float_v::AsArg y, Vc::float_v &value) const {
+        if (!m_enableAntialiasing) return;
+
+        const Vc::float_v vOne(Vc::One);
+
+        Vc::float_m xFadeMask = x > Vc::float_v(m_xFadeLimitStart);
+        value(xFadeMask) += (vOne - value) * (x - Vc::float_v(m_xFadeLimitStart)) * Vc::float_v(m_xFadeCoeff);
+
+        Vc::float_m yFadeMask = y > Vc::float_v(m_yFadeLimitStart);
+        value(yFadeMask) += (vOne - value) * (y - Vc::float_v(m_yFadeLimitStart)) * Vc::float_v(m_yFadeCoeff);
+    }
+#endif /* defined HAVE_VC */
+
 private:
     qreal m_xLimit;
     qreal m_yLimit;
@@ -28,6 +28,7 @@
 #include "kis_node_visitor.h"
 #include "kis_painter.h"
 #include "kis_layer.h"
+#include "kis_scheduler_tracer.h"
 #include "kis_group_layer.h"
 #include "kis_adjustment_layer.h"
 #include "generator/kis_generator_layer.h"
@@ -220,6 +221,8 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         QRect applyRect = item.m_applyRect;
 
+        KisSchedulerTraceScope traceScope("mergeLeaf", applyRect, walker.levelOfDetail());
+
         if(item.m_position & KisMergeWalker::N_EXTRA) {
             // The type of layers that will not go to projection.
 
@@ -20,6 +20,17 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_circle_mask_generator_p.h"
+#include "kis_rect_mask_generator.h"
+#include "kis_rect_mask_generator_p.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_gauss_circle_mask_generator_p.h"
+#include "kis_gauss_rect_mask_generator.h"
+#include "kis_gauss_rect_mask_generator_p.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_circle_mask_generator_p.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_curve_rect_mask_generator_p.h"
+#include "vc_extra_math.h"
 #include "kis_brush_mask_applicators.h"
 #include "kis_brush_mask_applicator_base.h"
 
@@ -42,6 +53,46 @@ MaskApplicatorFactory<KisCircleMaskGenerator, KisBrushMaskVectorApplicator>::cre
     return new KisBrushMaskVectorApplicator<KisCircleMaskGenerator,Vc::CurrentImplementation::current()>(maskGenerator);
 }
 
+template<>
+template<>
+MaskApplicatorFactory<KisRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<Vc::CurrentImplementation::current()>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisRectangleMaskGenerator,Vc::CurrentImplementation::current()>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisGaussCircleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisGaussCircleMaskGenerator, KisBrushMaskVectorApplicator>::create<Vc::CurrentImplementation::current()>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisGaussCircleMaskGenerator,Vc::CurrentImplementation::current()>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<Vc::CurrentImplementation::current()>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisGaussRectangleMaskGenerator,Vc::CurrentImplementation::current()>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisCurveCircleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisCurveCircleMaskGenerator, KisBrushMaskVectorApplicator>::create<Vc::CurrentImplementation::current()>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisCurveCircleMaskGenerator,Vc::CurrentImplementation::current()>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<Vc::CurrentImplementation::current()>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisCurveRectangleMaskGenerator,Vc::CurrentImplementation::current()>(maskGenerator);
+}
+
 #if defined HAVE_VC
 
 struct KisCircleMaskGenerator::FastRowProcessor
@@ -134,4 +185,390 @@ FastRowProcessor::process<Vc::CurrentImplementation::current()>(float* buffer, i
     }
 }
 
+struct KisRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisRectangleMaskGenerator::Private *d;
+};
+
+struct KisGaussCircleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisGaussCircleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisGaussCircleMaskGenerator::Private *d;
+};
+
+struct KisGaussRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisGaussRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisGaussRectangleMaskGenerator::Private *d;
+};
+
+struct KisCurveCircleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisCurveCircleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisCurveCircleMaskGenerator::Private *d;
+};
+
+struct KisCurveRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisCurveRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisCurveRectangleMaskGenerator::Private *d;
+};
+
+template<> void KisRectangleMaskGenerator::
+FastRowProcessor::process<Vc::CurrentImplementation::current()>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    const bool useSmoothing = d->copyOfAntialiasEdges;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices = Vc::float_v::IndexesFromZero();
+
+    Vc::float_v increment((float)Vc::float_v::size());
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoeff);
+    Vc::float_v vYCoeff(d->ycoeff);
+
+    Vc::float_v vTransformedFadeX(d->transformedFadeX);
+    Vc::float_v vTransformedFadeY(d->transformedFadeY);
+
+    Vc::float_v vOne(Vc::One);
+
+    for (int i=0; i < width; i+= Vc::float_v::size()){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        xr = Vc::abs(xr);
+        yr = Vc::abs(yr);
+
+        Vc::float_v nxr = xr * vXCoeff;
+        Vc::float_v nyr = yr * vYCoeff;
+
+        Vc::float_m outsideMask = (nxr > vOne) || (nyr > vOne);
+
+        if (!outsideMask.isFull()) {
+            if (useSmoothing) {
+                xr += vOne;
+                yr += vOne;
+            }
+
+            Vc::float_v fxr = xr * vTransformedFadeX;
+            Vc::float_v fyr = yr * vTransformedFadeY;
+
+            Vc::float_m fadeXMask = (fxr > vOne) && ((fxr > fyr) || (fyr < vOne));
+            Vc::float_m fadeYMask = !fadeXMask && (fyr > vOne) && ((fyr > fxr) || (fxr < vOne));
+
+            Vc::float_v vValue(Vc::Zero);
+            vValue(fadeXMask) = nxr * (fxr - vOne) / (fxr - nxr);
+            vValue(fadeYMask) = nyr * (fyr - vOne) / (fyr - nyr);
+
+            // Mask out the outer area of the rectangle
+            vValue(outsideMask) = vOne;
+
+            vValue.store(bufferPointer, Vc::Aligned);
+        } else {
+            // Mask out everything outside the rectangle
+            vOne.store(bufferPointer, Vc::Aligned);
+        }
+
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::size();
+    }
+}
+
+template<> void KisGaussCircleMaskGenerator::
+FastRowProcessor::process<Vc::CurrentImplementation::current()>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    typedef VcExtraMath<Vc::CurrentImplementation::current()> Math;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices = Vc::float_v::IndexesFromZero();
+
+    Vc::float_v increment((float)Vc::float_v::size());
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vYCoeff(d->ycoef);
+    Vc::float_v vDistfactor(d->distfactor);
+    Vc::float_v vCenter(d->center);
+    Vc::float_v vAlphafactor(d->alphafactor / 255.0);
+
+    Vc::float_v vOne(Vc::One);
+
+    for (int i=0; i < width; i+= Vc::float_v::size()){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v dist = Vc::sqrt(pow2(xr) + pow2(yr * vYCoeff));
+
+        Vc::float_v vValue;
+        Vc::float_m fadeMask =
+            d->fadeMaker.needFade<Vc::CurrentImplementation::current()>(dist, vValue);
+
+        if (!fadeMask.isFull()) {
+            Vc::float_v vDist = dist * vDistfactor;
+            Vc::float_v vBase = vOne - vAlphafactor * (Math::erf(vDist + vCenter) - Math::erf(vDist - vCenter));
+
+            vBase(fadeMask) = vValue;
+            vValue = vBase;
+        }
+
+        vValue.store(bufferPointer, Vc::Aligned);
+
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::size();
+    }
+}
+
+template<> void KisGaussRectangleMaskGenerator::
+FastRowProcessor::process<Vc::CurrentImplementation::current()>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    typedef VcExtraMath<Vc::CurrentImplementation::current()> Math;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices = Vc::float_v::IndexesFromZero();
+
+    Vc::float_v increment((float)Vc::float_v::size());
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXFade(d->xfade);
+    Vc::float_v vYFade(d->yfade);
+    Vc::float_v vHalfWidth(d->halfWidth);
+    Vc::float_v vHalfHeight(d->halfHeight);
+    Vc::float_v vAlphafactor(d->alphafactor / 255.0);
+
+    Vc::float_v vOne(Vc::One);
+
+    for (int i=0; i < width; i+= Vc::float_v::size()){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        xr = Vc::abs(xr);
+        yr = Vc::abs(yr);
+
+        Vc::float_m outsideMask =
+            d->fadeMaker.outsideMask<Vc::CurrentImplementation::current()>(xr, yr);
+
+        if (!outsideMask.isFull()) {
+            Vc::float_v vValue = vOne - vAlphafactor *
+                (Math::erf((vHalfWidth + xr) * vXFade) + Math::erf((vHalfWidth - xr) * vXFade)) *
+                (Math::erf((vHalfHeight + yr) * vYFade) + Math::erf((vHalfHeight - yr) * vYFade));
+
+            d->fadeMaker.applyFade<Vc::CurrentImplementation::current()>(xr, yr, vValue);
+
+            vValue(outsideMask) = vOne;
+            vValue.store(bufferPointer, Vc::Aligned);
+        } else {
+            vOne.store(bufferPointer, Vc::Aligned);
+        }
+
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::size();
+    }
+}
+
+template<> void KisCurveCircleMaskGenerator::
+FastRowProcessor::process<Vc::CurrentImplementation::current()>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    typedef VcExtraMath<Vc::CurrentImplementation::current()> Math;
+    const float *curveData = d->floatCurveData.constData();
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices = Vc::float_v::IndexesFromZero();
+
+    Vc::float_v increment((float)Vc::float_v::size());
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoef);
+    Vc::float_v vYCoeff(d->ycoef);
+    Vc::float_v vCurveResolution(d->curveResolution);
+
+    Vc::float_v vOne(Vc::One);
+
+    for (int i=0; i < width; i+= Vc::float_v::size()){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v dist = pow2(xr * vXCoeff) + pow2(yr * vYCoeff);
+
+        Vc::float_v vValue;
+        Vc::float_m fadeMask =
+            d->fadeMaker.needFade<Vc::CurrentImplementation::current()>(dist, vValue);
+
+        if (!fadeMask.isFull()) {
+            // clamp the index, the faded lanes may point outside the table
+            Vc::float_v vIndex = Vc::min(dist, vOne) * vCurveResolution;
+            Vc::float_v vBase = vOne - Math::interpolateTable(curveData, vIndex);
+
+            vBase(fadeMask) = vValue;
+            vValue = vBase;
+        }
+
+        vValue.store(bufferPointer, Vc::Aligned);
+
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::size();
+    }
+}
+
+template<> void KisCurveRectangleMaskGenerator::
+FastRowProcessor::process<Vc::CurrentImplementation::current()>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    typedef Vc::float_v::IndexType IndexType;
+    const float *curveData = d->floatCurveData.constData();
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices = Vc::float_v::IndexesFromZero();
+
+    Vc::float_v increment((float)Vc::float_v::size());
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoeff);
+    Vc::float_v vYCoeff(d->ycoeff);
+    Vc::float_v vCurveResolution(d->curveResolution);
+    Vc::float_v vHalf(0.5f);
+
+    const IndexType vCurveResolutionIndex(int(d->curveResolution));
+
+    Vc::float_v vOne(Vc::One);
+
+    for (int i=0; i < width; i+= Vc::float_v::size()){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        xr = Vc::abs(xr);
+        yr = Vc::abs(yr);
+
+        Vc::float_m outsideMask =
+            d->fadeMaker.outsideMask<Vc::CurrentImplementation::current()>(xr, yr);
+
+        if (!outsideMask.isFull()) {
+            // the lanes outside the rectangle may point outside the table,
+            // the indexes are rounded the same way qRound() does
+            const IndexType sIndex = Vc::simd_cast<IndexType>(Vc::min(xr * vXCoeff, vOne) * vCurveResolution + vHalf);
+            const IndexType tIndex = Vc::simd_cast<IndexType>(Vc::min(yr * vYCoeff, vOne) * vCurveResolution + vHalf);
+
+            Vc::float_v blend =
+                Vc::float_v(curveData, sIndex) * (vOne - Vc::float_v(curveData, vCurveResolutionIndex - sIndex)) *
+                Vc::float_v(curveData, tIndex) * (vOne - Vc::float_v(curveData, vCurveResolutionIndex - tIndex));
+
+            Vc::float_v vValue = vOne - blend;
+
+            d->fadeMaker.applyFade<Vc::CurrentImplementation::current()>(xr, yr, vValue);
+
+            vValue(outsideMask) = vOne;
+            vValue.store(bufferPointer, Vc::Aligned);
+        } else {
+            vOne.store(bufferPointer, Vc::Aligned);
+        }
+
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::size();
+    }
+}
+
 #endif /* defined HAVE_VC */
@@ -32,7 +32,8 @@ class QDomDocument;
  */
 class KRITAIMAGE_EXPORT KisCurveRectangleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisCurveRectangleMaskGenerator(qreal radius, qreal ratio, qreal fh, qreal fv, int spikes, const KisCubicCurve& curve, bool antialiasEdges);
@@ -42,6 +43,10 @@ public:
 
     virtual quint8 valueAt(qreal x, qreal y) const;
 
+    virtual bool shouldVectorize() const;
+
+    KisBrushMaskApplicatorBase* applicator();
+
     void setScale(qreal scaleX, qreal scaleY);
 
     virtual void toXML(QDomDocument& , QDomElement&) const;
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2010 Lukáš Tvrdý <lukast.dev@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _KIS_CURVE_RECT_MASK_GENERATOR_P_H_
+#define _KIS_CURVE_RECT_MASK_GENERATOR_P_H_
+
+#include <algorithm>
+
+#include <QScopedPointer>
+#include <QVector>
+#include <QList>
+#include <QPointF>
+
+#include "kis_antialiasing_fade_maker.h"
+
+struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
+{
+    Private(bool enableAntialiasing)
+        : fadeMaker(*this, enableAntialiasing)
+    {
+    }
+
+    Private(const Private &rhs)
+        : xcoeff(rhs.xcoeff),
+        ycoeff(rhs.ycoeff),
+        curveResolution(rhs.curveResolution),
+        curveData(rhs.curveData),
+        floatCurveData(rhs.floatCurveData),
+        curvePoints(rhs.curvePoints),
+        dirty(rhs.dirty),
+        fadeMaker(rhs.fadeMaker, *this)
+    {
+    }
+
+    qreal xcoeff, ycoeff;
+    qreal curveResolution;
+    QVector<qreal> curveData;
+
+    /**
+     * A float copy of curveData used by the vectorized row processor
+     */
+    QVector<float> floatCurveData;
+
+    QList<QPointF> curvePoints;
+    bool dirty;
+
+    KisAntialiasingFadeMaker2D<Private> fadeMaker;
+    QScopedPointer<KisBrushMaskApplicatorBase> applicator;
+
+    quint8 value(qreal xr, qreal yr) const;
+
+    void updateFloatCurveData() {
+        floatCurveData.resize(curveData.size());
+        std::copy(curveData.constBegin(), curveData.constEnd(), floatCurveData.begin());
+    }
+};
+
+#endif /* _KIS_CURVE_RECT_MASK_GENERATOR_P_H_ */
@@ -29,7 +29,8 @@
  */
 class KRITAIMAGE_EXPORT KisGaussRectangleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisGaussRectangleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges);
@@ -38,6 +39,10 @@ public:
     KisMaskGenerator* clone() const;
 
     virtual quint8 valueAt(qreal x, qreal y) const;
+
+    virtual bool shouldVectorize() const;
+
+    KisBrushMaskApplicatorBase* applicator();
     void setScale(qreal scaleX, qreal scaleY);
 
 private:
@@ -27,6 +27,7 @@
 #include "KoColorSpace.h"
 #include "kis_debug.h"
 #include "kis_iterator_ng.h"
+#include "kis_tile_histogram_cache.h"
 
 KisHistogram::KisHistogram(const KisPaintLayerSP layer,
                            KoHistogramProducer *producer,
@@ -63,6 +64,24 @@ KisHistogram::KisHistogram(const KisPaintDeviceSP paintdev,
     updateHistogram();
 }
 
+KisHistogram::KisHistogram(KisTileHistogramCacheSP cache,
+                           KoHistogramProducer *producer,
+                           const enumHistogramType type)
+    : m_paintDevice(cache->device()),
+      m_cache(cache)
+{
+    Q_ASSERT(producer);
+
+    m_bounds = cache->bounds();
+    m_producer = producer;
+    m_type = type;
+
+    m_selection = false;
+    m_channel = 0;
+
+    updateHistogram();
+}
+
 KisHistogram::~KisHistogram()
 {
     delete m_producer;
@@ -70,6 +89,10 @@ KisHistogram::~KisHistogram()
 
 void KisHistogram::updateHistogram()
 {
+    if (m_cache) {
+        m_bounds = m_cache->bounds();
+    }
+
     if (m_bounds.isEmpty()) {
         int numChannels = m_producer->channels().count();
 
@@ -82,6 +105,12 @@ void KisHistogram::updateHistogram()
         return;
     }
 
+    if (m_cache) {
+        m_cache->update(m_producer);
+        computeHistogram();
+        return;
+    }
+
     KisSequentialConstIterator srcIt(m_paintDevice, m_bounds);
     const KoColorSpace* cs = m_paintDevice->colorSpace();
 
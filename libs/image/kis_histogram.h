@@ -114,6 +114,15 @@ public:
                  KoHistogramProducer *producer,
                  const enumHistogramType type);
 
+    /**
+     * Reads the histogram from \p cache. Only the dirty parts of the
+     * cache are rescanned on updateHistogram(). \p producer should be
+     * of the same type as the producers created by the cache.
+     */
+    KisHistogram(KisTileHistogramCacheSP cache,
+                 KoHistogramProducer *producer,
+                 const enumHistogramType type);
+
     virtual ~KisHistogram();
 
     /** Updates the information in the producer */
@@ -180,6 +189,7 @@ private:
     Calculations calculateSingleRange(int channel, double from, double to);
 
     const KisPaintDeviceSP m_paintDevice;
+    KisTileHistogramCacheSP m_cache;
     QRect m_bounds;
     KoHistogramProducer *m_producer;
     enumHistogramType m_type;
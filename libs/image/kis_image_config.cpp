@@ -160,6 +160,72 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+bool KisImageConfig::swapWholeFileMapping(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapWholeFileMapping", true) : true;
+}
+
+void KisImageConfig::setSwapWholeFileMapping(bool value)
+{
+    m_config.writeEntry("swapWholeFileMapping", value);
+}
+
+QString KisImageConfig::swapTileCompression(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapTileCompression", "LZ4") : "LZ4";
+}
+
+void KisImageConfig::setSwapTileCompression(const QString &value)
+{
+    m_config.writeEntry("swapTileCompression", value);
+}
+
+QString KisImageConfig::kraTileCompression(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("kraTileCompression", "LZF") : "LZF";
+}
+
+void KisImageConfig::setKraTileCompression(const QString &value)
+{
+    m_config.writeEntry("kraTileCompression", value);
+}
+
+bool KisImageConfig::historyDeltaCompression(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("historyDeltaCompression", false) : false;
+}
+
+void KisImageConfig::setHistoryDeltaCompression(bool value)
+{
+    m_config.writeEntry("historyDeltaCompression", value);
+}
+
+bool KisImageConfig::tileDeduplication(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tileDeduplication", false) : false;
+}
+
+void KisImageConfig::setTileDeduplication(bool value)
+{
+    m_config.writeEntry("tileDeduplication", value);
+}
+
+bool KisImageConfig::asyncDabRendering(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("asyncDabRendering", false) : false;
+}
+
+void KisImageConfig::setAsyncDabRendering(bool value)
+{
+    m_config.writeEntry("asyncDabRendering", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -57,6 +57,51 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * Map the whole swap file into the address space instead of
+     * using the moving windows of swapWindowSize(). Ignored on the
+     * systems where such mapping is not supported.
+     */
+    bool swapWholeFileMapping(bool requestDefault = false) const;
+    void setSwapWholeFileMapping(bool value);
+
+    /**
+     * The name of the codec used for compressing the tiles in the
+     * swap file, e.g. "LZ4". Falls back to LZF if the codec is not
+     * available.
+     */
+    QString swapTileCompression(bool requestDefault = false) const;
+    void setSwapTileCompression(const QString &value);
+
+    /**
+     * The name of the codec used for the layers saved into .kra files.
+     * Files saved with anything but LZF cannot be opened by Krita
+     * versions that don't know the codec, so LZF is the default.
+     */
+    QString kraTileCompression(bool requestDefault = false) const;
+    void setKraTileCompression(const QString &value);
+
+    /**
+     * When enabled, the tiles that are kept only by the undo history
+     * are stored as compressed deltas against their newer revisions
+     */
+    bool historyDeltaCompression(bool requestDefault = false) const;
+    void setHistoryDeltaCompression(bool value);
+
+    /**
+     * When enabled, the tiles with equal content are periodically
+     * merged into a single instance until they are accessed again
+     */
+    bool tileDeduplication(bool requestDefault = false) const;
+    void setTileDeduplication(bool value);
+
+    /**
+     * When enabled, the brush engine renders the dabs of a stroke
+     * on the worker threads and composites them on the stroke thread
+     */
+    bool asyncDabRendering(bool requestDefault = false) const;
+    void setAsyncDabRendering(bool value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
@@ -108,6 +108,10 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.deduplicatedSize = tileStats.deduplicatedSize;
+
+    stats.historicalDeltaSize = tileStats.historicalDeltaSize;
+    stats.historicalDeltaSavedSize = tileStats.historicalDeltaSavedSize;
 
     KisImageConfig cfg;
 
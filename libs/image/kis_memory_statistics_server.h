@@ -42,6 +42,10 @@ public:
               poolSize(0),
 
               swapSize(0),
+              deduplicatedSize(0),
+
+              historicalDeltaSize(0),
+              historicalDeltaSavedSize(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -59,6 +63,19 @@ public:
 
         qint64 swapSize;
 
+        /**
+         * The amount of memory saved by sharing the tiles
+         * with equal content
+         */
+        qint64 deduplicatedSize;
+
+        /**
+         * The size of the undo history tiles stored as compressed
+         * deltas and the amount of memory saved by that
+         */
+        qint64 historicalDeltaSize;
+        qint64 historicalDeltaSavedSize;
+
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
         qint64 tilesSoftLimit;
@@ -589,11 +589,11 @@ void KisPaintDevice::Private::updateLodDataStruct(LodDataStruct *_dst, const QRe
     int blendDataOffset = 0;
 
     const int srcCellSize = srcStepSize * srcStepSize;
-    const int srcCellStride = srcCellSize * pixelSize;
     const int srcStepStride = srcStepSize * pixelSize;
     const int srcColumnStride = (srcStepSize - 1) * srcStepStride;
 
     QScopedArrayPointer<qint16> weights(new qint16[srcCellSize]);
+    QScopedArrayPointer<quint8> dstRowData(new quint8[dstRect.width() * pixelSize]);
 
     {
         const qint16 averageWeight = qCeil(255.0 / srcCellSize);
@@ -632,12 +632,14 @@ void KisPaintDevice::Private::updateLodDataStruct(LodDataStruct *_dst, const QRe
 
         if (rowsAccumulated >= srcStepSize) {
 
-            // blend and write the final data
-            blendDataPtr = blendData.data();
+            // blend the whole row in one go and write the final data
+            mixOp->mixColorsRow(blendData.data(), weights.data(), srcCellSize, dstRowData.data(), dstRect.width());
+
+            const quint8 *dstRowPtr = dstRowData.data();
             for (int i = 0; i < dstRect.width(); i++) {
-                mixOp->mixColors(blendDataPtr, weights.data(), srcCellSize, dstIntIt.rawData());
+                memcpy(dstIntIt.rawData(), dstRowPtr, pixelSize);
 
-                blendDataPtr += srcCellStride;
+                dstRowPtr += pixelSize;
                 dstIntIt.nextPixel();
             }
 
@@ -1509,16 +1511,30 @@ void KisPaintDevice::clearSelection(KisSelectionSP selection)
         KisHLineConstIteratorSP selectionIt = selection->projection()->createHLineConstIteratorNG(r.x(), r.y(), r.width());
 
         const quint8* defaultPixel_ = defaultPixel();
+        const int pixelSize = colorSpace->pixelSize();
         bool transparentDefault = (colorSpace->opacityU8(defaultPixel_) == OPACITY_TRANSPARENT_U8);
+
+        QVector<quint8> opacityBuffer(r.width());
+
         for (qint32 y = 0; y < r.height(); y++) {
 
+            qint32 numPixels;
             do {
-                // XXX: Optimize by using stretches
-                colorSpace->applyInverseAlphaU8Mask(devIt->rawData(), selectionIt->rawDataConst(), 1);
-                if (transparentDefault && colorSpace->opacityU8(devIt->rawData()) == OPACITY_TRANSPARENT_U8) {
-                    memcpy(devIt->rawData(), defaultPixel_, colorSpace->pixelSize());
+                numPixels = qMin(devIt->nConseqPixels(), selectionIt->nConseqPixels());
+
+                quint8 *dstPtr = devIt->rawData();
+                colorSpace->applyInverseAlphaU8Mask(dstPtr, selectionIt->rawDataConst(), numPixels);
+
+                if (transparentDefault) {
+                    colorSpace->copyOpacityU8(dstPtr, opacityBuffer.data(), numPixels);
+
+                    for (qint32 i = 0; i < numPixels; i++) {
+                        if (opacityBuffer[i] == OPACITY_TRANSPARENT_U8) {
+                            memcpy(dstPtr + i * pixelSize, defaultPixel_, pixelSize);
+                        }
+                    }
                 }
-            } while (devIt->nextPixel() && selectionIt->nextPixel());
+            } while (devIt->nextPixels(numPixels) && selectionIt->nextPixels(numPixels));
             devIt->nextRow();
             selectionIt->nextRow();
         }
@@ -164,10 +164,11 @@ public:
                 const quint8 *srcData = srcIt.rawDataConst();
                 quint8 *dstData = dstIt.rawData();
 
-                m_colorSpace->convertPixelsTo(srcData, dstData,
-                                              dstColorSpace,
-                                              nConseqPixels,
-                                              renderingIntent, conversionFlags);
+                m_colorSpace->convertPixelRowTo(srcData, dstData,
+                                                dstColorSpace,
+                                                nConseqPixels,
+                                                srcIt.x(), srcIt.y(),
+                                                renderingIntent, conversionFlags);
 
 
             } while(srcIt.nextPixels(nConseqPixels) &&
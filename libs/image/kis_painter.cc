@@ -37,6 +37,7 @@
 #include <QRect>
 #include <QString>
 #include <QStringList>
+#include <QVarLengthArray>
 #include <kundo2command.h>
 
 #include <kis_debug.h>
@@ -126,6 +127,8 @@ struct Q_DECL_HIDDEN KisPainter::Private {
                              qint32 *dstX,
                              qint32 *dstY);
 
+    bool tryBitBltUniformSource(const KoColorSpace *srcColorSpace);
+
     void fillPainterPathImpl(const QPainterPath& path, const QRect &requestedRect);
 };
 
@@ -425,6 +428,84 @@ inline bool KisPainter::Private::tryReduceSourceRect(const KisPaintDevice *srcDe
     return false;
 }
 
+/**
+ * Composites the chunk described by paramInfo when the source is a part
+ * of a uniform tile. Returns false if the chunk should be composited
+ * in a usual way.
+ */
+inline bool KisPainter::Private::tryBitBltUniformSource(const KoColorSpace *srcColorSpace)
+{
+    const QString &opId = compositeOp->id();
+
+    /**
+     * Transparent source pixels do not change the destination, the
+     * same assumption is used in tryReduceSourceRect(). The exceptions
+     * are the ops that write the destination regardless of the source
+     * alpha: Copy and Clear replace it and In multiplies it by the
+     * source alpha.
+     */
+    const bool transparentSourceIsNoop =
+        opId != COMPOSITE_COPY &&
+        opId != COMPOSITE_CLEAR &&
+        opId != COMPOSITE_IN;
+
+    if (transparentSourceIsNoop &&
+        srcColorSpace->opacityF(paramInfo.srcRowStart) == OPACITY_TRANSPARENT_F) {
+
+        return true;
+    }
+
+    /**
+     * Uniform source over uniform destination gives a uniform
+     * result, so composite a single pixel and fill the chunk with
+     * it. Dissolve uses a random value per pixel, so it is excluded.
+     *
+     * The destination is being written to, so its tile cannot have a
+     * valid cached uniformity. Check the chunk itself, it is much
+     * cheaper than compositing it.
+     */
+    if (paramInfo.maskRowStart || opId == COMPOSITE_DISSOLVE) {
+        return false;
+    }
+
+    const quint8 *dstRow = paramInfo.dstRowStart;
+    for (qint32 row = 0; row < paramInfo.rows; row++) {
+        if (memcmp(dstRow, paramInfo.dstRowStart, pixelSize) ||
+            memcmp(dstRow, dstRow + pixelSize, (paramInfo.cols - 1) * pixelSize)) {
+
+            return false;
+        }
+        dstRow += paramInfo.dstRowStride;
+    }
+
+    QVarLengthArray<quint8, 32> pixel(pixelSize);
+    memcpy(pixel.data(), paramInfo.dstRowStart, pixelSize);
+
+    KoCompositeOp::ParameterInfo pixelParams(paramInfo);
+    pixelParams.dstRowStart = pixel.data();
+    pixelParams.dstRowStride = 0;
+    pixelParams.srcRowStride = 0;
+    pixelParams.rows = 1;
+    pixelParams.cols = 1;
+    colorSpace->bitBlt(srcColorSpace, pixelParams, compositeOp, renderingIntent, conversionFlags);
+
+    if (!memcmp(pixel.data(), paramInfo.dstRowStart, pixelSize)) {
+        return true;
+    }
+
+    quint8 *fillRow = paramInfo.dstRowStart;
+    for (qint32 row = 0; row < paramInfo.rows; row++) {
+        quint8 *dst = fillRow;
+        for (qint32 column = 0; column < paramInfo.cols; column++) {
+            memcpy(dst, pixel.data(), pixelSize);
+            dst += pixelSize;
+        }
+        fillRow += paramInfo.dstRowStride;
+    }
+
+    return true;
+}
+
 void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
                                           const KisPaintDeviceSP srcDev,
                                           const KisFixedPaintDeviceSP selection,
@@ -652,7 +733,12 @@ void KisPainter::bitBltImpl(qint32 dstX, qint32 dstY,
                 d->paramInfo.maskRowStride = maskRowStride;
                 d->paramInfo.rows          = rows;
                 d->paramInfo.cols          = columns;
-                d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, d->compositeOp, d->renderingIntent, d->conversionFlags);
+
+                const bool srcIsUniform = useOldSrcData ? srcIt->isOldTileUniform() : srcIt->isTileUniform();
+
+                if (!srcIsUniform || !d->tryBitBltUniformSource(srcDev->colorSpace())) {
+                    d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, d->compositeOp, d->renderingIntent, d->conversionFlags);
+                }
 
                 srcX_ += columns;
                 dstX_ += columns;
@@ -700,7 +786,12 @@ void KisPainter::bitBltImpl(qint32 dstX, qint32 dstY,
                 d->paramInfo.maskRowStride = 0;
                 d->paramInfo.rows          = rows;
                 d->paramInfo.cols          = columns;
-                d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, d->compositeOp, d->renderingIntent, d->conversionFlags);
+
+                const bool srcIsUniform = useOldSrcData ? srcIt->isOldTileUniform() : srcIt->isTileUniform();
+
+                if (!srcIsUniform || !d->tryBitBltUniformSource(srcDev->colorSpace())) {
+                    d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, d->compositeOp, d->renderingIntent, d->conversionFlags);
+                }
 
                 srcX_ += columns;
                 dstX_ += columns;
@@ -1383,14 +1474,20 @@ void KisPainter::Private::fillPainterPathImpl(const QPainterPath& path, const QR
             qint32 rectHeight = qMin(fillRect.y() + fillRect.height() - y, maskImageHeight);
 
             KisHLineIteratorSP lineIt = polygon->createHLineIteratorNG(x, y, rectWidth);
+            const KoColorSpace *polygonCs = polygon->colorSpace();
 
-            quint8 tmp;
+            QVector<quint8> maskRow(rectWidth);
             for (int row = y; row < y + rectHeight; row++) {
                 QRgb* line = reinterpret_cast<QRgb*>(polygonMaskImage.scanLine(row - y));
+                for (int col = 0; col < rectWidth; col++) {
+                    maskRow[col] = qRed(line[col]);
+                }
+
+                qint32 numPixels;
                 do {
-                    tmp = qRed(line[lineIt->x() - x]);
-                    polygon->colorSpace()->applyAlphaU8Mask(lineIt->rawData(), &tmp, 1);
-                } while (lineIt->nextPixel());
+                    numPixels = lineIt->nConseqPixels();
+                    polygonCs->applyAlphaU8Mask(lineIt->rawData(), maskRow.constData() + lineIt->x() - x, numPixels);
+                } while (lineIt->nextPixels(numPixels));
                 lineIt->nextRow();
             }
 
@@ -1460,14 +1557,20 @@ void KisPainter::drawPainterPath(const QPainterPath& path, const QPen& pen, cons
             qint32 rectHeight = qMin(fillRect.y() + fillRect.height() - y, d->maskImageHeight);
 
             KisHLineIteratorSP lineIt = d->polygon->createHLineIteratorNG(x, y, rectWidth);
+            const KoColorSpace *polygonCs = d->polygon->colorSpace();
 
-            quint8 tmp;
+            QVector<quint8> maskRow(rectWidth);
             for (int row = y; row < y + rectHeight; row++) {
                 QRgb* line = reinterpret_cast<QRgb*>(d->polygonMaskImage.scanLine(row - y));
+                for (int col = 0; col < rectWidth; col++) {
+                    maskRow[col] = qRed(line[col]);
+                }
+
+                qint32 numPixels;
                 do {
-                    tmp = qRed(line[lineIt->x() - x]);
-                    d->polygon->colorSpace()->applyAlphaU8Mask(lineIt->rawData(), &tmp, 1);
-                } while (lineIt->nextPixel());
+                    numPixels = lineIt->nConseqPixels();
+                    polygonCs->applyAlphaU8Mask(lineIt->rawData(), maskRow.constData() + lineIt->x() - x, numPixels);
+                } while (lineIt->nextPixels(numPixels));
                 lineIt->nextRow();
             }
 
@@ -31,6 +31,19 @@ public:
     virtual qint32 numContiguousColumns(qint32 x) const = 0;
     virtual qint32 numContiguousRows(qint32 y) const = 0;
     virtual qint32 rowStride(qint32 x, qint32 y) const = 0;
+
+    /**
+     * Returns true if all the pixels of the tile under the current
+     * position are equal, that is the whole area reported by
+     * numContiguousColumns() and numContiguousRows() is filled with
+     * the current pixel. The result is cached in the tile data.
+     */
+    virtual bool isTileUniform() const = 0;
+
+    /**
+     * Same as isTileUniform(), but for the data returned by oldRawData()
+     */
+    virtual bool isOldTileUniform() const = 0;
 };
 
 class KRITAIMAGE_EXPORT KisRandomAccessorNG : public KisRandomConstAccessorNG, public KisBaseAccessor
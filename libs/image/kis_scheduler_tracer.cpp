@@ -0,0 +1,366 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_scheduler_tracer.h"
+
+#include <QGlobalStatic>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QCoreApplication>
+
+#include "kis_debug.h"
+
+Q_GLOBAL_STATIC(KisSchedulerTracer, s_instance)
+
+const int KisSchedulerTracer::NUM_HISTOGRAM_BUCKETS = 26; // up to ~30s
+const int KisSchedulerTracer::MAX_EVENTS = 1000000;
+
+static const char* jobTypeName(KisSchedulerTracer::JobType type)
+{
+    switch (type) {
+    case KisSchedulerTracer::MERGE_JOB:
+        return "merge";
+    case KisSchedulerTracer::STROKE_JOB:
+        return "stroke";
+    case KisSchedulerTracer::SPONTANEOUS_JOB:
+        return "spontaneous";
+    default:
+        return "unknown";
+    }
+}
+
+static int histogramBucket(qint64 value)
+{
+    int bucket = 0;
+    while (value > 0 && bucket < KisSchedulerTracer::NUM_HISTOGRAM_BUCKETS - 1) {
+        value >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+struct Event
+{
+    const char *name;
+    qint64 startTime;
+    qint64 duration;
+    qint64 queueLatency;
+    quint64 threadId;
+    QRect rect;
+    int levelOfDetail;
+};
+
+struct RunningJob
+{
+    RunningJob() : type(KisSchedulerTracer::MERGE_JOB), startTime(0), queueLatency(-1), levelOfDetail(-1) {}
+
+    KisSchedulerTracer::JobType type;
+    qint64 startTime;
+    qint64 queueLatency;
+    QRect rect;
+    int levelOfDetail;
+};
+
+struct Q_DECL_HIDDEN KisSchedulerTracer::Private
+{
+    Private() : numDroppedEvents(0) {}
+
+    QString fileName;
+    QElapsedTimer timer;
+
+    mutable QMutex lock;
+
+    QHash<const void*, qint64> enqueuedJobs;
+    QHash<const void*, RunningJob> runningJobs;
+
+    QVector<Event> events;
+    int numDroppedEvents;
+
+    QVector<qint64> latencyHistograms[NUM_JOB_TYPES];
+    QVector<qint64> executionHistograms[NUM_JOB_TYPES];
+
+    void addEvent(const Event &event) {
+        if (events.size() < MAX_EVENTS) {
+            events.append(event);
+        } else {
+            numDroppedEvents++;
+        }
+    }
+
+    void writeEvents(const QString &fileName);
+    void writeHistograms(const QString &fileName);
+};
+
+KisSchedulerTracer::KisSchedulerTracer()
+    : m_enabled(false),
+      m_d(new Private)
+{
+    m_d->timer.start();
+
+    for (int i = 0; i < NUM_JOB_TYPES; i++) {
+        m_d->latencyHistograms[i].fill(0, NUM_HISTOGRAM_BUCKETS);
+        m_d->executionHistograms[i].fill(0, NUM_HISTOGRAM_BUCKETS);
+    }
+
+    const QByteArray fileName = qgetenv("KRITA_SCHEDULER_TRACE");
+    if (!fileName.isEmpty()) {
+        m_d->fileName = QString::fromLocal8Bit(fileName);
+        m_enabled = true;
+    }
+}
+
+KisSchedulerTracer::~KisSchedulerTracer()
+{
+    writeTrace();
+    delete m_d;
+}
+
+KisSchedulerTracer* KisSchedulerTracer::instance()
+{
+    return s_instance;
+}
+
+qint64 KisSchedulerTracer::currentTime() const
+{
+    return m_d->timer.nsecsElapsed() / 1000;
+}
+
+void KisSchedulerTracer::reportJobEnqueued(const void *key)
+{
+    if (!m_enabled) return;
+
+    const qint64 time = currentTime();
+
+    QMutexLocker l(&m_d->lock);
+    m_d->enqueuedJobs.insert(key, time);
+}
+
+void KisSchedulerTracer::reportJobStarted(const void *key, JobType type, const QRect &rect, int levelOfDetail)
+{
+    if (!m_enabled) return;
+
+    RunningJob job;
+    job.type = type;
+    job.startTime = currentTime();
+    job.rect = rect;
+    job.levelOfDetail = levelOfDetail;
+
+    QMutexLocker l(&m_d->lock);
+
+    QHash<const void*, qint64>::iterator it = m_d->enqueuedJobs.find(key);
+    if (it != m_d->enqueuedJobs.end()) {
+        job.queueLatency = job.startTime - it.value();
+        m_d->enqueuedJobs.erase(it);
+
+        m_d->latencyHistograms[type][histogramBucket(job.queueLatency)]++;
+    }
+
+    m_d->runningJobs.insert(key, job);
+}
+
+void KisSchedulerTracer::reportJobFinished(const void *key)
+{
+    if (!m_enabled) return;
+
+    const qint64 time = currentTime();
+
+    QMutexLocker l(&m_d->lock);
+
+    QHash<const void*, RunningJob>::iterator it = m_d->runningJobs.find(key);
+    if (it == m_d->runningJobs.end()) return;
+
+    const RunningJob &job = it.value();
+
+    Event event;
+    event.name = jobTypeName(job.type);
+    event.startTime = job.startTime;
+    event.duration = time - job.startTime;
+    event.queueLatency = job.queueLatency;
+    event.threadId = quint64(quintptr(QThread::currentThreadId()));
+    event.rect = job.rect;
+    event.levelOfDetail = job.levelOfDetail;
+
+    m_d->executionHistograms[job.type][histogramBucket(event.duration)]++;
+    m_d->addEvent(event);
+
+    m_d->runningJobs.erase(it);
+}
+
+void KisSchedulerTracer::reportJobDropped(const void *key)
+{
+    if (!m_enabled) return;
+
+    QMutexLocker l(&m_d->lock);
+    m_d->enqueuedJobs.remove(key);
+}
+
+void KisSchedulerTracer::reportEvent(const char *name, qint64 startTime,
+                                     const QRect &rect, int levelOfDetail)
+{
+    if (!m_enabled) return;
+
+    Event event;
+    event.name = name;
+    event.startTime = startTime;
+    event.duration = currentTime() - startTime;
+    event.queueLatency = -1;
+    event.threadId = quint64(quintptr(QThread::currentThreadId()));
+    event.rect = rect;
+    event.levelOfDetail = levelOfDetail;
+
+    QMutexLocker l(&m_d->lock);
+    m_d->addEvent(event);
+}
+
+void KisSchedulerTracer::writeTrace()
+{
+    if (!m_enabled) return;
+
+    QMutexLocker l(&m_d->lock);
+
+    m_d->writeEvents(m_d->fileName);
+    m_d->writeHistograms(m_d->fileName + ".histograms.txt");
+
+    if (m_d->numDroppedEvents) {
+        warnKrita << "KisSchedulerTracer:" << m_d->numDroppedEvents
+                  << "events were dropped, the limit is" << MAX_EVENTS;
+    }
+}
+
+void KisSchedulerTracer::Private::writeEvents(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnKrita << "KisSchedulerTracer: failed to open" << fileName;
+        return;
+    }
+
+    QTextStream stream(&file);
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    stream << "{\"traceEvents\":[\n";
+
+    for (int i = 0; i < events.size(); i++) {
+        const Event &event = events[i];
+
+        stream << "{\"name\":\"" << event.name << "\""
+               << ",\"cat\":\"scheduler\",\"ph\":\"X\""
+               << ",\"ts\":" << event.startTime
+               << ",\"dur\":" << event.duration
+               << ",\"pid\":" << pid
+               << ",\"tid\":" << event.threadId
+               << ",\"args\":{";
+
+        stream << "\"x\":" << event.rect.x()
+               << ",\"y\":" << event.rect.y()
+               << ",\"width\":" << event.rect.width()
+               << ",\"height\":" << event.rect.height()
+               << ",\"lod\":" << event.levelOfDetail;
+
+        if (event.queueLatency >= 0) {
+            stream << ",\"queueLatency\":" << event.queueLatency;
+        }
+
+        stream << "}}" << (i < events.size() - 1 ? ",\n" : "\n");
+    }
+
+    stream << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void KisSchedulerTracer::Private::writeHistograms(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnKrita << "KisSchedulerTracer: failed to open" << fileName;
+        return;
+    }
+
+    QTextStream stream(&file);
+
+    const char *sections[] = {"Queue latency", "Execution time"};
+    QVector<qint64> *histograms[] = {latencyHistograms, executionHistograms};
+
+    for (int section = 0; section < 2; section++) {
+        stream << "# " << sections[section] << ", us\n";
+        stream << "<";
+
+        for (int type = 0; type < NUM_JOB_TYPES; type++) {
+            stream << "\t" << jobTypeName(JobType(type));
+        }
+        stream << "\n";
+
+        for (int bucket = 0; bucket < NUM_HISTOGRAM_BUCKETS; bucket++) {
+            if (bucket < NUM_HISTOGRAM_BUCKETS - 1) {
+                stream << (qint64(1) << bucket);
+            } else {
+                stream << "inf";
+            }
+
+            for (int type = 0; type < NUM_JOB_TYPES; type++) {
+                stream << "\t" << histograms[section][type][bucket];
+            }
+            stream << "\n";
+        }
+        stream << "\n";
+    }
+}
+
+QVector<qint64> KisSchedulerTracer::latencyHistogram(JobType type) const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->latencyHistograms[type];
+}
+
+QVector<qint64> KisSchedulerTracer::executionHistogram(JobType type) const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->executionHistograms[type];
+}
+
+void KisSchedulerTracer::testingSetOutputFile(const QString &fileName)
+{
+    QMutexLocker l(&m_d->lock);
+    m_d->fileName = fileName;
+    m_enabled = !fileName.isEmpty();
+
+    /**
+     * The jobs queued before the tracing has been stopped
+     * will never be reported as dropped or started
+     */
+    if (!m_enabled) {
+        m_d->enqueuedJobs.clear();
+        m_d->runningJobs.clear();
+    }
+}
+
+int KisSchedulerTracer::testingNumEvents() const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->events.size();
+}
+
+int KisSchedulerTracer::testingNumEnqueuedJobs() const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->enqueuedJobs.size();
+}
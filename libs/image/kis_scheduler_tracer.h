@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_SCHEDULER_TRACER_H
+#define __KIS_SCHEDULER_TRACER_H
+
+#include <QtGlobal>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+
+/**
+ * Records the timing of the jobs passing through the update
+ * scheduler: when they were queued, when they were started and
+ * finished, on which thread, which area they covered and on which
+ * level of detail. The places that are not jobs themselves (e.g.
+ * processing of the queues or uploading of the canvas textures)
+ * can be traced with KisSchedulerTraceScope.
+ *
+ * The tracer is enabled by setting KRITA_SCHEDULER_TRACE environment
+ * variable to the path of the output file. On exit (or on a call to
+ * writeTrace()) two files are written:
+ *
+ * <path> --- the events in Chrome trace-event JSON format, which
+ *            can be opened in chrome://tracing
+ *
+ * <path>.histograms.txt --- per job type histograms of the queue
+ *            latency and the execution time
+ *
+ * When the tracer is disabled, all the report calls return right
+ * after checking isEnabled().
+ */
+class KRITAIMAGE_EXPORT KisSchedulerTracer
+{
+public:
+    enum JobType {
+        MERGE_JOB = 0,
+        STROKE_JOB,
+        SPONTANEOUS_JOB,
+        NUM_JOB_TYPES
+    };
+
+    static const int NUM_HISTOGRAM_BUCKETS;
+    static const int MAX_EVENTS;
+
+public:
+    KisSchedulerTracer();
+    ~KisSchedulerTracer();
+
+    static KisSchedulerTracer* instance();
+
+    inline bool isEnabled() const {
+        return m_enabled;
+    }
+
+    /**
+     * Time since the creation of the tracer in microseconds
+     */
+    qint64 currentTime() const;
+
+    void reportJobEnqueued(const void *key);
+    void reportJobStarted(const void *key, JobType type, const QRect &rect, int levelOfDetail);
+    void reportJobFinished(const void *key);
+
+    /**
+     * Should be called when a queued job is removed from the queue
+     * without being started, e.g. when it is merged into another
+     * job, overridden or cancelled. Otherwise the record would stay
+     * in the tracer forever and the pointer might be reused by
+     * another job.
+     */
+    void reportJobDropped(const void *key);
+
+    /**
+     * Records an arbitrary event that started at \p startTime and
+     * lasted till now. \p name should be a static string.
+     */
+    void reportEvent(const char *name, qint64 startTime,
+                     const QRect &rect = QRect(), int levelOfDetail = -1);
+
+    /**
+     * Writes the collected data into the output files. Does
+     * nothing if the tracer is disabled.
+     */
+    void writeTrace();
+
+    /**
+     * The number of jobs of \p type which queue latency (or
+     * execution time) fell into a bucket. The bucket \c i contains
+     * the values in range [2^(i-1), 2^i) microseconds, the last
+     * one has no upper limit.
+     */
+    QVector<qint64> latencyHistogram(JobType type) const;
+    QVector<qint64> executionHistogram(JobType type) const;
+
+    void testingSetOutputFile(const QString &fileName);
+    int testingNumEvents() const;
+    int testingNumEnqueuedJobs() const;
+
+private:
+    bool m_enabled;
+
+    struct Private;
+    Private * const m_d;
+};
+
+/**
+ * Reports an event covering the lifetime of the object
+ */
+class KRITAIMAGE_EXPORT KisSchedulerTraceScope
+{
+public:
+    KisSchedulerTraceScope(const char *name,
+                           const QRect &rect = QRect(),
+                           int levelOfDetail = -1)
+        : m_name(name),
+          m_rect(rect),
+          m_levelOfDetail(levelOfDetail),
+          m_startTime(-1)
+    {
+        KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+        if (tracer->isEnabled()) {
+            m_startTime = tracer->currentTime();
+        }
+    }
+
+    ~KisSchedulerTraceScope() {
+        if (m_startTime >= 0) {
+            KisSchedulerTracer::instance()->reportEvent(m_name, m_startTime,
+                                                        m_rect, m_levelOfDetail);
+        }
+    }
+
+private:
+    const char *m_name;
+    QRect m_rect;
+    int m_levelOfDetail;
+    qint64 m_startTime;
+};
+
+#endif /* __KIS_SCHEDULER_TRACER_H */
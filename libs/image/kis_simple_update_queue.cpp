@@ -23,6 +23,8 @@
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "kis_datamanager.h"
+#include "kis_scheduler_tracer.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -52,8 +54,25 @@
 #endif /* ENABLE_ACCUMULATOR */
 
 
+static inline qint32 alignToTile(qint32 size, qint32 tileSize)
+{
+    return qMax(1, (size + tileSize - 1) / tileSize) * tileSize;
+}
+
+static inline qint32 floorDiv(qint32 value, qint32 divisor)
+{
+    return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+static inline qint64 pixelsCount(const QRect &rc)
+{
+    return qint64(rc.width()) * rc.height();
+}
+
 KisSimpleUpdateQueue::KisSimpleUpdateQueue()
-    : m_overrideLevelOfDetail(-1)
+    : m_overrideLevelOfDetail(-1),
+      m_dirtiedPixels(0),
+      m_recompositedPixels(0)
 {
     updateSettings();
 }
@@ -62,8 +81,16 @@ KisSimpleUpdateQueue::~KisSimpleUpdateQueue()
 {
     QMutexLocker locker(&m_lock);
 
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+
+    Q_FOREACH (KisBaseRectsWalkerSP walker, m_updatesList) {
+        tracer->reportJobDropped(walker.data());
+    }
+
     while (!m_spontaneousJobsList.isEmpty()) {
-        delete m_spontaneousJobsList.takeLast();
+        KisSpontaneousJob *job = m_spontaneousJobsList.takeLast();
+        tracer->reportJobDropped(job);
+        delete job;
     }
 }
 
@@ -71,8 +98,8 @@ void KisSimpleUpdateQueue::updateSettings()
 {
     KisImageConfig config;
 
-    m_patchWidth = config.updatePatchWidth();
-    m_patchHeight = config.updatePatchHeight();
+    m_patchWidth = alignToTile(config.updatePatchWidth(), KisTileData::WIDTH);
+    m_patchHeight = alignToTile(config.updatePatchHeight(), KisTileData::HEIGHT);
 
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
@@ -118,6 +145,8 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
         if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
             updaterContext.isJobAllowed(item)) {
 
+            m_recompositedPixels += pixelsCount(item->requestedRect());
+
             updaterContext.addMergeJob(item);
             iter.remove();
             jobAdded = true;
@@ -154,16 +183,19 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
 
 void KisSimpleUpdateQueue::addUpdateJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail)
 {
+    countDirtiedPixels(rc);
     addJob(node, rc, cropRect, levelOfDetail, KisBaseRectsWalker::UPDATE);
 }
 
 void KisSimpleUpdateQueue::addUpdateNoFilthyJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail)
 {
+    countDirtiedPixels(rc);
     addJob(node, rc, cropRect, levelOfDetail, KisBaseRectsWalker::UPDATE_NO_FILTHY);
 }
 
 void KisSimpleUpdateQueue::addFullRefreshJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail)
 {
+    countDirtiedPixels(rc);
     addJob(node, rc, cropRect, levelOfDetail, KisBaseRectsWalker::FULL_REFRESH);
 }
 
@@ -172,8 +204,12 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QRect& rc,
                                   int levelOfDetail,
                                   KisBaseRectsWalker::UpdateType type)
 {
-    if(trySplitJob(node, rc, cropRect, levelOfDetail, type)) return;
-    if(tryMergeJob(node, rc, cropRect, levelOfDetail, type)) return;
+    QRect uncoveredRect = rc;
+
+    if(rc.isEmpty()) return;
+    if(tryCoalesceJob(node, rc, cropRect, levelOfDetail, type, &uncoveredRect)) return;
+    if(trySplitJob(node, uncoveredRect, cropRect, levelOfDetail, type)) return;
+    if(tryMergeJob(node, uncoveredRect, cropRect, levelOfDetail, type)) return;
 
     KisBaseRectsWalkerSP walker;
 
@@ -188,7 +224,9 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QRect& rc,
     }
     /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
 
-    walker->collectRects(node, rc);
+    walker->collectRects(node, uncoveredRect);
+
+    KisSchedulerTracer::instance()->reportJobEnqueued(walker.data());
 
     m_lock.lock();
     m_updatesList.append(walker);
@@ -209,10 +247,12 @@ void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
 
         if (spontaneousJob->overrides(item)) {
             iter.remove();
+            KisSchedulerTracer::instance()->reportJobDropped(item);
             delete item;
         }
     }
 
+    KisSchedulerTracer::instance()->reportJobEnqueued(spontaneousJob);
     m_spontaneousJobsList.append(spontaneousJob);
 }
 
@@ -233,16 +273,23 @@ bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
                                        int levelOfDetail,
                                        KisBaseRectsWalker::UpdateType type)
 {
-    if(rc.width() <= m_patchWidth || rc.height() <= m_patchHeight)
+    if(rc.width() <= m_patchWidth && rc.height() <= m_patchHeight)
         return false;
 
     // a bit of recursive splitting...
 
-    qint32 firstCol = rc.x() / m_patchWidth;
-    qint32 firstRow = rc.y() / m_patchHeight;
+    /**
+     * The patches are aligned to the grid of the patch size, so
+     * the dirty rects of the jobs do not overlap. The walkers may
+     * still grow their change rects beyond the patch, so the jobs
+     * can write into the same areas of the projection. Such jobs
+     * are not run concurrently by the updater context.
+     */
+    qint32 firstCol = floorDiv(rc.left(), m_patchWidth);
+    qint32 firstRow = floorDiv(rc.top(), m_patchHeight);
 
-    qint32 lastCol = (rc.x() + rc.width()) / m_patchWidth;
-    qint32 lastRow = (rc.y() + rc.height()) / m_patchHeight;
+    qint32 lastCol = floorDiv(rc.right(), m_patchWidth);
+    qint32 lastRow = floorDiv(rc.bottom(), m_patchHeight);
 
     for(qint32 i = firstRow; i <= lastRow; i++) {
         for(qint32 j = firstCol; j <= lastCol; j++) {
@@ -295,6 +342,97 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
     return (bool)goodCandidate;
 }
 
+/**
+ * Checks the part of the update that is already covered by the jobs
+ * queued for the same node. If nothing is left, the job is dropped.
+ * If the rest is a rectangle, it is returned in \p uncoveredRect, so
+ * that the new walker (if the job is not merged into an existing one)
+ * doesn't process the same area twice.
+ */
+bool KisSimpleUpdateQueue::tryCoalesceJob(KisNodeSP node, const QRect& rc,
+                                          const QRect& cropRect,
+                                          int levelOfDetail,
+                                          KisBaseRectsWalker::UpdateType type,
+                                          QRect *uncoveredRect)
+{
+    QMutexLocker locker(&m_lock);
+
+    const QRegion queued = queuedRegion(node, rc, cropRect, levelOfDetail, type);
+    if(queued.isEmpty()) return false;
+
+    const QRegion rest = QRegion(rc) - queued;
+
+    if(rest.isEmpty()) return true;
+
+    /**
+     * Splitting the job into many small walkers would
+     * cost more than processing a bit extra
+     */
+    if(rest.rectCount() == 1) {
+        *uncoveredRect = rest.boundingRect();
+    }
+
+    return false;
+}
+
+/**
+ * Collects the area of the queued updates of \p node, which intersect
+ * \p rc and can be replaced with each other (the same type, crop rect
+ * and level of detail).
+ *
+ * LOCKING: should be called with m_lock held
+ */
+QRegion KisSimpleUpdateQueue::queuedRegion(KisNodeSP node, const QRect& rc,
+                                           const QRect& cropRect,
+                                           int levelOfDetail,
+                                           KisBaseRectsWalker::UpdateType type) const
+{
+    QRegion region;
+
+    KisBaseRectsWalkerSP item;
+    KisWalkersListIterator iter(m_updatesList);
+
+    while(iter.hasNext()) {
+        item = iter.next();
+
+        if(item->startNode() != node) continue;
+        if(item->type() != type) continue;
+        if(item->cropRect() != cropRect) continue;
+        if(item->levelOfDetail() != levelOfDetail) continue;
+
+        if(item->requestedRect().intersects(rc)) {
+            region += item->requestedRect();
+        }
+    }
+
+    return region;
+}
+
+void KisSimpleUpdateQueue::countDirtiedPixels(const QRect& rc)
+{
+    QMutexLocker locker(&m_lock);
+    m_dirtiedPixels += pixelsCount(rc);
+}
+
+qint64 KisSimpleUpdateQueue::dirtiedPixels() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_dirtiedPixels;
+}
+
+qint64 KisSimpleUpdateQueue::recompositedPixels() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_recompositedPixels;
+}
+
+void KisSimpleUpdateQueue::resetPixelCounters()
+{
+    QMutexLocker locker(&m_lock);
+    m_dirtiedPixels = 0;
+    m_recompositedPixels = 0;
+}
+
 void KisSimpleUpdateQueue::optimize()
 {
     QMutexLocker locker(&m_lock);
@@ -325,6 +463,7 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
 
         if(joinRects(baseRect, item->requestedRect(), maxAlpha)) {
             iter.remove();
+            KisSchedulerTracer::instance()->reportJobDropped(item.data());
         }
     }
 
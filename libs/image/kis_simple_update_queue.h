@@ -20,6 +20,7 @@
 #define __KIS_SIMPLE_UPDATE_QUEUE_H
 
 #include <QMutex>
+#include <QRegion>
 #include "kis_updater_context.h"
 
 typedef QList<KisBaseRectsWalkerSP> KisWalkersList;
@@ -54,6 +55,17 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * The amount of pixels requested to be updated and the amount
+     * of pixels of the merge jobs actually passed to the updater
+     * context. The latter differs from the former because of the
+     * coalescing of the overlapping updates and the merging of the
+     * neighbouring ones.
+     */
+    qint64 dirtiedPixels() const;
+    qint64 recompositedPixels() const;
+    void resetPixelCounters();
+
 protected:
     void addJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
@@ -61,6 +73,10 @@ protected:
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
+    bool tryCoalesceJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, QRect *uncoveredRect);
+
+    QRegion queuedRegion(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type) const;
+    void countDirtiedPixels(const QRect& rc);
 
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
@@ -80,7 +96,8 @@ protected:
     /**
      * Big update areas are split into a set of smaller
      * ones, m_patchWidth and m_patchHeight represent the
-     * size of these areas.
+     * size of these areas. The size is rounded up to the
+     * tiles size, so the patches never share tiles.
      */
     qint32 m_patchWidth;
     qint32 m_patchHeight;
@@ -102,6 +119,9 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    qint64 m_dirtiedPixels;
+    qint64 m_recompositedPixels;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
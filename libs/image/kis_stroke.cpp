@@ -19,6 +19,7 @@
 #include "kis_stroke.h"
 
 #include "kis_stroke_strategy.h"
+#include "kis_scheduler_tracer.h"
 
 
 KisStroke::KisStroke(KisStrokeStrategy *strokeStrategy, Type type, int levelOfDetail)
@@ -188,6 +189,7 @@ void KisStroke::clearQueueOnCancel()
 
     while (it != m_jobsQueue.end()) {
         if ((*it)->isCancellable()) {
+            KisSchedulerTracer::instance()->reportJobDropped(*it);
             delete (*it);
             it = m_jobsQueue.erase(it);
         } else {
@@ -257,7 +259,10 @@ void KisStroke::enqueue(KisStrokeJobStrategy *strategy,
         return;
     }
 
-    m_jobsQueue.enqueue(new KisStrokeJob(strategy, data, worksOnLevelOfDetail(), true));
+    KisStrokeJob *job = new KisStrokeJob(strategy, data, worksOnLevelOfDetail(), true);
+    KisSchedulerTracer::instance()->reportJobEnqueued(job);
+
+    m_jobsQueue.enqueue(job);
 }
 
 void KisStroke::prepend(KisStrokeJobStrategy *strategy,
@@ -274,7 +279,10 @@ void KisStroke::prepend(KisStrokeJobStrategy *strategy,
     // LOG_MERGE_FIXME:
     Q_UNUSED(levelOfDetail);
 
-    m_jobsQueue.prepend(new KisStrokeJob(strategy, data, worksOnLevelOfDetail(), isCancellable));
+    KisStrokeJob *job = new KisStrokeJob(strategy, data, worksOnLevelOfDetail(), isCancellable);
+    KisSchedulerTracer::instance()->reportJobEnqueued(job);
+
+    m_jobsQueue.prepend(job);
 }
 
 KisStrokeJob* KisStroke::dequeue()
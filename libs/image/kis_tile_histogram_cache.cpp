@@ -0,0 +1,362 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tile_histogram_cache.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSet>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <KoHistogramProducer.h>
+
+#include "kis_paint_device.h"
+#include "kis_iterator_ng.h"
+#include "kis_debug.h"
+
+
+/**
+ * 4x4 tiles. The memory footprint of a partial histogram is
+ * (nChannels * 256 * 4) bytes, so an image of 10k x 10k pixels
+ * takes about 8MiB of cached bins.
+ */
+const int KisTileHistogramCache::CELL_SIZE = 256;
+
+namespace {
+
+/**
+ * There is no point in spawning a merge thread for just a few cells
+ */
+const int MIN_CELLS_PER_MERGE_GROUP = 16;
+
+typedef QSharedPointer<KoHistogramProducer> KoHistogramProducerSP;
+
+inline int cellIndex(int coord)
+{
+    return coord >= 0 ?
+        coord / KisTileHistogramCache::CELL_SIZE :
+        (coord + 1) / KisTileHistogramCache::CELL_SIZE - 1;
+}
+
+inline quint64 cellKey(int col, int row)
+{
+    return (quint64(quint32(col)) << 32) | quint32(row);
+}
+
+inline QRect cellRect(quint64 key)
+{
+    const int col = qint32(key >> 32);
+    const int row = qint32(key & 0xFFFFFFFF);
+
+    return QRect(col * KisTileHistogramCache::CELL_SIZE,
+                 row * KisTileHistogramCache::CELL_SIZE,
+                 KisTileHistogramCache::CELL_SIZE,
+                 KisTileHistogramCache::CELL_SIZE);
+}
+
+void addRectToProducer(KisPaintDeviceSP device, const QRect &rc, KoHistogramProducer *producer)
+{
+    if (rc.isEmpty()) return;
+
+    KisSequentialConstIterator srcIt(device, rc);
+    const KoColorSpace *cs = device->colorSpace();
+
+    int numPixels;
+    do {
+        numPixels = srcIt.nConseqPixels();
+        producer->addRegionToBin(srcIt.oldRawData(), 0, numPixels, cs);
+    } while (srcIt.nextPixels(numPixels));
+}
+
+struct CellJob {
+    quint64 key;
+    KoHistogramProducerSP producer;
+};
+
+struct MergeGroup {
+    QVector<KoHistogramProducerSP> cells;
+    KoHistogramProducerSP producer;
+    bool succeeded;
+};
+
+typedef QPair<const KisPaintDevice*, QString> SharedCacheKey;
+typedef QHash<SharedCacheKey, KisTileHistogramCacheWSP> SharedCacheHash;
+Q_GLOBAL_STATIC(SharedCacheHash, s_sharedCaches)
+
+}
+
+struct KisTileHistogramCache::Private
+{
+    KisPaintDeviceSP device;
+    ProducerFactory factory;
+
+    mutable QMutex mutex;
+    QRect bounds;
+    QHash<quint64, KoHistogramProducerSP> cells;
+    QSet<quint64> dirtyCells;
+    qreal viewFrom = 0.0;
+    qreal viewWidth = 1.0;
+    bool canMerge = true;
+
+    QMutex updateMutex;
+
+    void setDirtyUnlocked(const QRect &rc);
+    KoHistogramProducerSP createProducer() const;
+    bool mergeCells(const QVector<KoHistogramProducerSP> &cells, KoHistogramProducer *dst);
+};
+
+KisTileHistogramCache::KisTileHistogramCache(KisPaintDeviceSP device,
+                                             ProducerFactory factory,
+                                             const QRect &bounds)
+    : m_d(new Private)
+{
+    m_d->device = device;
+    m_d->factory = factory;
+    setBounds(bounds);
+}
+
+KisTileHistogramCache::~KisTileHistogramCache()
+{
+}
+
+KisTileHistogramCacheSP KisTileHistogramCache::sharedCache(KisPaintDeviceSP device,
+                                                           const QString &producerId,
+                                                           ProducerFactory factory,
+                                                           const QRect &bounds)
+{
+    SharedCacheHash &caches = *s_sharedCaches;
+
+    /**
+     * The caches hold their devices, so the key of a live cache
+     * cannot be reused by another device
+     */
+    SharedCacheHash::iterator it = caches.begin();
+    while (it != caches.end()) {
+        if (!it.value().isValid()) {
+            it = caches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const SharedCacheKey key(device.data(), producerId);
+
+    KisTileHistogramCacheSP cache = caches.value(key);
+    if (cache && cache->bounds().contains(bounds)) {
+        return cache;
+    }
+
+    cache = new KisTileHistogramCache(device, factory, bounds);
+    caches.insert(key, cache);
+
+    return cache;
+}
+
+KisPaintDeviceSP KisTileHistogramCache::device() const
+{
+    return m_d->device;
+}
+
+QRect KisTileHistogramCache::bounds() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->bounds;
+}
+
+void KisTileHistogramCache::setBounds(const QRect &bounds)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->bounds = bounds;
+    m_d->cells.clear();
+    m_d->dirtyCells.clear();
+    m_d->setDirtyUnlocked(bounds);
+}
+
+void KisTileHistogramCache::setDirty(const QRect &rc)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->setDirtyUnlocked(rc);
+}
+
+void KisTileHistogramCache::setAllDirty()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->setDirtyUnlocked(m_d->bounds);
+}
+
+bool KisTileHistogramCache::isDirty() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return !m_d->dirtyCells.isEmpty();
+}
+
+void KisTileHistogramCache::Private::setDirtyUnlocked(const QRect &rc)
+{
+    const QRect dirtyRect = rc & bounds;
+    if (dirtyRect.isEmpty()) return;
+
+    const int firstCol = cellIndex(dirtyRect.left());
+    const int lastCol = cellIndex(dirtyRect.right());
+    const int firstRow = cellIndex(dirtyRect.top());
+    const int lastRow = cellIndex(dirtyRect.bottom());
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            dirtyCells.insert(cellKey(col, row));
+        }
+    }
+}
+
+KoHistogramProducerSP KisTileHistogramCache::Private::createProducer() const
+{
+    KoHistogramProducerSP producer(factory());
+    if (producer) {
+        producer->setView(viewFrom, viewWidth);
+    }
+    return producer;
+}
+
+bool KisTileHistogramCache::Private::mergeCells(const QVector<KoHistogramProducerSP> &cells, KoHistogramProducer *dst)
+{
+    Q_FOREACH (KoHistogramProducerSP cell, cells) {
+        if (!dst->addBins(cell.data())) return false;
+    }
+    return true;
+}
+
+void KisTileHistogramCache::update(KoHistogramProducer *producer)
+{
+    QMutexLocker updateLocker(&m_d->updateMutex);
+
+    QVector<CellJob> jobs;
+    QRect bounds;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        if (m_d->viewFrom != producer->viewFrom() ||
+            m_d->viewWidth != producer->viewWidth()) {
+
+            m_d->viewFrom = producer->viewFrom();
+            m_d->viewWidth = producer->viewWidth();
+            m_d->cells.clear();
+            m_d->setDirtyUnlocked(m_d->bounds);
+        }
+
+        bounds = m_d->bounds;
+
+        if (m_d->canMerge) {
+            jobs.reserve(m_d->dirtyCells.size());
+            Q_FOREACH (quint64 key, m_d->dirtyCells) {
+                jobs.append({key, KoHistogramProducerSP()});
+            }
+        }
+        m_d->dirtyCells.clear();
+    }
+
+    producer->clear();
+
+    if (!m_d->canMerge) {
+        addRectToProducer(m_d->device, bounds, producer);
+        return;
+    }
+
+    QtConcurrent::blockingMap(jobs,
+        [this, bounds] (CellJob &job) {
+            job.producer = m_d->createProducer();
+            if (job.producer) {
+                addRectToProducer(m_d->device, cellRect(job.key) & bounds, job.producer.data());
+            }
+        });
+
+    QVector<KoHistogramProducerSP> cells;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        /**
+         * The bounds could have been changed while we were
+         * calculating, then the cells are already dropped and
+         * marked dirty again
+         */
+        if (bounds != m_d->bounds) return;
+
+        Q_FOREACH (const CellJob &job, jobs) {
+            if (job.producer) {
+                m_d->cells.insert(job.key, job.producer);
+            } else {
+                m_d->cells.remove(job.key);
+            }
+        }
+
+        cells.reserve(m_d->cells.size());
+        Q_FOREACH (KoHistogramProducerSP cell, m_d->cells) {
+            cells.append(cell);
+        }
+    }
+
+    if (cells.isEmpty()) return;
+
+    const int numGroups =
+        qBound(1, cells.size() / MIN_CELLS_PER_MERGE_GROUP, QThread::idealThreadCount());
+
+    bool succeeded = true;
+
+    if (numGroups == 1) {
+        succeeded = m_d->mergeCells(cells, producer);
+    } else {
+        QVector<MergeGroup> groups(numGroups);
+
+        for (int i = 0; i < cells.size(); i++) {
+            groups[i % numGroups].cells.append(cells[i]);
+        }
+
+        QtConcurrent::blockingMap(groups,
+            [this] (MergeGroup &group) {
+                group.producer = m_d->createProducer();
+                group.succeeded =
+                    group.producer &&
+                    m_d->mergeCells(group.cells, group.producer.data());
+            });
+
+        Q_FOREACH (const MergeGroup &group, groups) {
+            succeeded &= group.succeeded && producer->addBins(group.producer.data());
+            if (!succeeded) break;
+        }
+    }
+
+    if (!succeeded) {
+        warnImage << "KisTileHistogramCache: the histogram producer" << producer->id().id()
+                  << "cannot merge partial histograms, falling back to full rescans";
+
+        {
+            QMutexLocker l(&m_d->mutex);
+            m_d->canMerge = false;
+            m_d->cells.clear();
+        }
+
+        producer->clear();
+        addRectToProducer(m_d->device, bounds, producer);
+    }
+}
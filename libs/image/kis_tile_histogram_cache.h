@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_TILE_HISTOGRAM_CACHE_H
+#define __KIS_TILE_HISTOGRAM_CACHE_H
+
+#include <functional>
+
+#include <QRect>
+#include <QScopedPointer>
+
+#include "kis_shared.h"
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KoHistogramProducer;
+
+
+/**
+ * Keeps partial histograms of a paint device calculated for
+ * separate cells of its bounds, so that after a change only the
+ * cells touched by the change have to be rescanned.
+ *
+ * The cells are aligned to the tile grid and are CELL_SIZE pixels
+ * wide, so a cell covers several tiles. A partial histogram per
+ * every tile would cost a few kilobytes per tile, which is too
+ * much for big images.
+ *
+ * The dirty cells are recalculated in parallel. The resulting
+ * partial histograms are merged in parallel as well, first into
+ * one histogram per thread and then into the final one.
+ *
+ * The producer passed to update() must support
+ * KoHistogramProducer::addBins(), otherwise the cache falls back
+ * to a full rescan of the bounds.
+ *
+ * setDirty() and setBounds() may be called from any thread,
+ * update() is serialized internally.
+ */
+class KRITAIMAGE_EXPORT KisTileHistogramCache : public KisShared
+{
+public:
+    typedef std::function<KoHistogramProducer*()> ProducerFactory;
+
+    static const int CELL_SIZE;
+
+public:
+    /**
+     * @param device the device to calculate the histogram of
+     * @param factory creates the producers for the partial
+     *        histograms. They should be of the same type as the one
+     *        passed to update()
+     * @param bounds the area of the device to take into account
+     */
+    KisTileHistogramCache(KisPaintDeviceSP device,
+                          ProducerFactory factory,
+                          const QRect &bounds);
+    ~KisTileHistogramCache();
+
+    /**
+     * Returns a cache of \p device shared between all the users
+     * of the histograms of the device, e.g. the histogram docker
+     * and the levels and curves filters. The cache is looked up by
+     * the device and \p producerId. If there is no such cache or
+     * it does not cover \p bounds, a new one is created and shared.
+     *
+     * The shared caches are not owned by anybody, a cache is
+     * forgotten when its last user releases it.
+     *
+     * Should be called from the GUI thread only.
+     */
+    static KisTileHistogramCacheSP sharedCache(KisPaintDeviceSP device,
+                                               const QString &producerId,
+                                               ProducerFactory factory,
+                                               const QRect &bounds);
+
+    KisPaintDeviceSP device() const;
+
+    QRect bounds() const;
+
+    /**
+     * Changes the area of the device to take into account.
+     * All the cells are recalculated on the next update.
+     */
+    void setBounds(const QRect &bounds);
+
+    /**
+     * Marks the cells touched by \p rc for recalculation
+     */
+    void setDirty(const QRect &rc);
+    void setAllDirty();
+
+    bool isDirty() const;
+
+    /**
+     * Recalculates the dirty cells and writes the merged histogram
+     * into \p producer. The previous content of \p producer is
+     * cleared.
+     */
+    void update(KoHistogramProducer *producer);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_TILE_HISTOGRAM_CACHE_H */
@@ -140,6 +140,10 @@ typedef KisSharedPtr<KisPixelSelection> KisPixelSelectionSP;
 class KisHistogram;
 typedef KisSharedPtr<KisHistogram> KisHistogramSP;
 
+class KisTileHistogramCache;
+typedef KisSharedPtr<KisTileHistogramCache> KisTileHistogramCacheSP;
+typedef KisWeakSharedPtr<KisTileHistogramCache> KisTileHistogramCacheWSP;
+
 typedef QVector<QPoint> vKisSegments;
 
 class KisFilter;
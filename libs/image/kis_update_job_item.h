@@ -26,6 +26,7 @@
 #include "kis_spontaneous_job.h"
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
+#include "kis_scheduler_tracer.h"
 
 
 class KisUpdateJobItem :  public QObject, public QRunnable
@@ -59,11 +60,23 @@ public:
             m_exclusiveJobLock->lockForRead();
         }
 
+        KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+
         if(m_type == MERGE) {
+            tracer->reportJobStarted(m_walker.data(), KisSchedulerTracer::MERGE_JOB,
+                                     m_changeRect, m_walker->levelOfDetail());
             runMergeJob();
+            tracer->reportJobFinished(m_walker.data());
         } else {
             Q_ASSERT(m_type == STROKE || m_type == SPONTANEOUS);
+
+            if (tracer->isEnabled()) {
+                reportRunnableJobStarted(tracer);
+            }
+
             m_runnableJob->run();
+            tracer->reportJobFinished(m_runnableJob);
+
             delete m_runnableJob;
             m_runnableJob = 0;
         }
@@ -86,6 +99,18 @@ public:
         emit sigContinueUpdate(changeRect);
     }
 
+    inline void reportRunnableJobStarted(KisSchedulerTracer *tracer) {
+        if (m_type == STROKE) {
+            KisStrokeJob *job = static_cast<KisStrokeJob*>(m_runnableJob);
+            tracer->reportJobStarted(job, KisSchedulerTracer::STROKE_JOB,
+                                     QRect(), job->levelOfDetail());
+        } else {
+            KisSpontaneousJob *job = static_cast<KisSpontaneousJob*>(m_runnableJob);
+            tracer->reportJobStarted(job, KisSchedulerTracer::SPONTANEOUS_JOB,
+                                     QRect(), job->levelOfDetail());
+        }
+    }
+
     inline void setWalker(KisBaseRectsWalkerSP walker) {
         m_type = MERGE;
         m_accessRect = walker->accessRect();
@@ -31,6 +31,7 @@
 
 #include <QReadWriteLock>
 #include "kis_lazy_wait_condition.h"
+#include "kis_scheduler_tracer.h"
 
 //#define DEBUG_BALANCING
 
@@ -340,6 +341,8 @@ void KisUpdateScheduler::barrierLock()
 
 void KisUpdateScheduler::processQueues()
 {
+    KisSchedulerTraceScope traceScope("processQueues");
+
     wakeUpWaitingThreads();
 
     if(m_d->processingBlocked) return;
@@ -19,20 +19,39 @@
 #include "kis_updater_context.h"
 
 #include <QThread>
-#include <QThreadPool>
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
 
 
-KisUpdaterContext::KisUpdaterContext(qint32 threadCount)
+static qint32 normalizeThreadCount(qint32 threadCount)
 {
     if(threadCount <= 0) {
         threadCount = QThread::idealThreadCount();
         threadCount = threadCount > 0 ? threadCount : 1;
     }
+    return threadCount;
+}
+
+/**
+ * Every thread gets a couple of job slots, so that the scheduler can
+ * queue a few jobs in the executor and a stroke job may overtake the
+ * merge jobs waiting there. The number is kept small, because a job
+ * that has been handed to the executor can no longer be merged with
+ * or split by the newer updates coming to the update queue.
+ */
+static const qint32 JOB_SLOTS_PER_THREAD = 2;
 
-    m_jobs.resize(threadCount);
+KisUpdaterContext::KisUpdaterContext(qint32 threadCount, qint32 jobSlotsCount)
+    : m_executor(normalizeThreadCount(threadCount))
+{
+    if (jobSlotsCount <= 0) {
+        jobSlotsCount = JOB_SLOTS_PER_THREAD * m_executor.threadCount();
+    }
+
+    m_jobs.resize(jobSlotsCount);
     for(qint32 i = 0; i < m_jobs.size(); i++) {
         m_jobs[i] = new KisUpdateJobItem(&m_exclusiveJobLock);
         connect(m_jobs[i], SIGNAL(sigContinueUpdate(const QRect&)),
@@ -49,7 +68,7 @@ KisUpdaterContext::KisUpdaterContext(qint32 threadCount)
 
 KisUpdaterContext::~KisUpdaterContext()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
     for(qint32 i = 0; i < m_jobs.size(); i++)
         delete m_jobs[i];
 }
@@ -120,8 +139,25 @@ void KisUpdaterContext::addMergeJob(KisBaseRectsWalkerSP walker)
     qint32 jobIndex = findSpareThread();
     Q_ASSERT(jobIndex >= 0);
 
+    prefetchWalkerTiles(walker);
+
     m_jobs[jobIndex]->setWalker(walker);
-    m_threadPool.start(m_jobs[jobIndex]);
+    m_executor.start(m_jobs[jobIndex], KisUpdaterExecutor::NORMAL_PRIORITY);
+}
+
+/**
+ * The walker already knows which areas of which devices are going
+ * to be read by the merge job, so we can ask the tiles engine to
+ * bring them back from the swap while the job is being started.
+ */
+void KisUpdaterContext::prefetchWalkerTiles(KisBaseRectsWalkerSP walker)
+{
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, walker->leafStack()) {
+        KisPaintDeviceSP device = item.m_leaf->original();
+        if (device) {
+            device->dataManager()->prefetch(item.m_applyRect);
+        }
+    }
 }
 
 /**
@@ -144,7 +180,7 @@ void KisUpdaterContext::addStrokeJob(KisStrokeJob *strokeJob)
     Q_ASSERT(jobIndex >= 0);
 
     m_jobs[jobIndex]->setStrokeJob(strokeJob);
-    m_threadPool.start(m_jobs[jobIndex]);
+    m_executor.start(m_jobs[jobIndex], KisUpdaterExecutor::HIGH_PRIORITY);
 }
 
 /**
@@ -167,7 +203,7 @@ void KisUpdaterContext::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
     Q_ASSERT(jobIndex >= 0);
 
     m_jobs[jobIndex]->setSpontaneousJob(spontaneousJob);
-    m_threadPool.start(m_jobs[jobIndex]);
+    m_executor.start(m_jobs[jobIndex], KisUpdaterExecutor::LOW_PRIORITY);
 }
 
 /**
@@ -185,7 +221,7 @@ void KisTestableUpdaterContext::addSpontaneousJob(KisSpontaneousJob *spontaneous
 
 void KisUpdaterContext::waitForDone()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 }
 
 bool KisUpdaterContext::walkerIntersectsJob(KisBaseRectsWalkerSP walker,
@@ -223,7 +259,7 @@ void KisUpdaterContext::unlock()
 }
 
 KisTestableUpdaterContext::KisTestableUpdaterContext(qint32 threadCount)
-    : KisUpdaterContext(threadCount)
+    : KisUpdaterContext(threadCount, threadCount)
 {
 }
 
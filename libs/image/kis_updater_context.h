@@ -22,11 +22,11 @@
 #include <QObject>
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QThreadPool>
 
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_lock_free_lod_counter.h"
+#include "kis_updater_executor.h"
 
 
 class KisUpdateJobItem;
@@ -38,7 +38,14 @@ class KRITAIMAGE_EXPORT KisUpdaterContext : public QObject
     Q_OBJECT
 
 public:
-    KisUpdaterContext(qint32 threadCount = -1);
+    /**
+     * Creates a context running its jobs on \p threadCount threads.
+     * The number of jobs that can be added to the context at once is
+     * \p jobSlotsCount, which is a couple of times bigger than the
+     * number of threads by default. The jobs that do not get a thread
+     * immediately are queued in the executor by their priority.
+     */
+    KisUpdaterContext(qint32 threadCount = -1, qint32 jobSlotsCount = -1);
     virtual ~KisUpdaterContext();
 
 
@@ -57,8 +64,9 @@ public:
     int currentLevelOfDetail() const;
 
     /**
-     * Check whether there is a spare thread for running
-     * one more job
+     * Check whether there is a spare job slot for running
+     * one more job. The job may be queued in the executor
+     * until one of the threads becomes free.
      */
     bool hasSpareThread();
 
@@ -129,6 +137,7 @@ protected:
     static bool walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                     const KisUpdateJobItem* job);
     qint32 findSpareThread();
+    static void prefetchWalkerTiles(KisBaseRectsWalkerSP walker);
 
 protected:
     /**
@@ -141,7 +150,11 @@ protected:
 
     QMutex m_lock;
     QVector<KisUpdateJobItem*> m_jobs;
-    QThreadPool m_threadPool;
+    /**
+     * Stroke jobs are executed first, then merge jobs, and the
+     * spontaneous (background regeneration) jobs go last
+     */
+    KisUpdaterExecutor m_executor;
     KisLockFreeLodCounter m_lodCounter;
 };
 
@@ -149,7 +162,8 @@ class KRITAIMAGE_EXPORT KisTestableUpdaterContext : public KisUpdaterContext
 {
 public:
     /**
-     * Creates an explicit number of threads
+     * Creates an explicit number of threads. The number
+     * of job slots is equal to the number of threads.
      */
     KisTestableUpdaterContext(qint32 threadCount);
     ~KisTestableUpdaterContext();
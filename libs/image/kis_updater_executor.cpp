@@ -0,0 +1,218 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_updater_executor.h"
+
+#include <QThread>
+#include <QRunnable>
+#include <QList>
+
+#include "kis_debug.h"
+
+
+class KisUpdaterExecutor::Worker : public QThread
+{
+public:
+    Worker(KisUpdaterExecutor *executor, int index)
+        : m_executor(executor),
+          m_index(index)
+    {
+    }
+
+    void run() {
+        forever {
+            QRunnable *job = m_executor->takeJob(this);
+
+            if (job) {
+                job->run();
+                m_executor->finishJob();
+                continue;
+            }
+
+            QMutexLocker locker(&m_executor->m_sleepLock);
+
+            if (m_executor->m_shouldExit) break;
+
+            /**
+             * The jobs are counted before the sleepers are woken up,
+             * so checking the counters under the lock guarantees that
+             * the wakeup will not be lost
+             */
+            bool hasQueuedJobs = false;
+            for (int i = 0; i < NUM_PRIORITIES; i++) {
+                if (m_executor->m_numQueued[i].load()) {
+                    hasQueuedJobs = true;
+                    break;
+                }
+            }
+
+            if (!hasQueuedJobs) {
+                m_executor->m_workAvailable.wait(&m_executor->m_sleepLock);
+            }
+        }
+    }
+
+    KisUpdaterExecutor *m_executor;
+    int m_index;
+
+    QMutex m_queueLock;
+    QList<QRunnable*> m_queues[NUM_PRIORITIES];
+};
+
+
+KisUpdaterExecutor::KisUpdaterExecutor(int threadCount)
+    : m_nextWorker(0),
+      m_workersStarted(false),
+      m_numUnfinished(0),
+      m_shouldExit(false)
+{
+    KIS_ASSERT_RECOVER(threadCount > 0) { threadCount = 1; }
+
+    for (int i = 0; i < NUM_PRIORITIES; i++) {
+        m_numQueued[i] = 0;
+    }
+
+    m_workers.resize(threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        m_workers[i] = new Worker(this, i);
+    }
+}
+
+KisUpdaterExecutor::~KisUpdaterExecutor()
+{
+    waitForDone();
+
+    {
+        QMutexLocker locker(&m_sleepLock);
+        m_shouldExit = true;
+        m_workAvailable.wakeAll();
+    }
+
+    /**
+     * The workers access each other's queues,
+     * so delete them only when all of them are stopped
+     */
+    Q_FOREACH (Worker *worker, m_workers) {
+        worker->wait();
+    }
+
+    qDeleteAll(m_workers);
+}
+
+void KisUpdaterExecutor::start(QRunnable *runnable, Priority priority)
+{
+    KIS_ASSERT_RECOVER_NOOP(priority >= 0 && priority < NUM_PRIORITIES);
+
+    m_numUnfinished.ref();
+
+    Worker *worker = currentWorker();
+
+    if (!worker) {
+        const int index = quint32(m_nextWorker.fetchAndAddRelaxed(1)) % m_workers.size();
+        worker = m_workers[index];
+    }
+
+    {
+        QMutexLocker locker(&worker->m_queueLock);
+        worker->m_queues[priority].append(runnable);
+    }
+
+    m_numQueued[priority].ref();
+
+    QMutexLocker locker(&m_sleepLock);
+
+    if (!m_workersStarted) {
+        startWorkers();
+    }
+
+    m_workAvailable.wakeOne();
+}
+
+void KisUpdaterExecutor::waitForDone()
+{
+    QMutexLocker locker(&m_sleepLock);
+
+    while (m_numUnfinished.load()) {
+        m_allDone.wait(&m_sleepLock);
+    }
+}
+
+int KisUpdaterExecutor::threadCount() const
+{
+    return m_workers.size();
+}
+
+QRunnable* KisUpdaterExecutor::takeJob(Worker *thief)
+{
+    const int numWorkers = m_workers.size();
+
+    for (int priority = 0; priority < NUM_PRIORITIES; priority++) {
+        if (!m_numQueued[priority].load()) continue;
+
+        /**
+         * Our own queue is checked first. The newest job is taken,
+         * because its data is most probably still in the cache
+         */
+        {
+            QMutexLocker locker(&thief->m_queueLock);
+            QList<QRunnable*> &queue = thief->m_queues[priority];
+
+            if (!queue.isEmpty()) {
+                m_numQueued[priority].deref();
+                return queue.takeLast();
+            }
+        }
+
+        for (int i = 1; i < numWorkers; i++) {
+            Worker *victim = m_workers[(thief->m_index + i) % numWorkers];
+
+            QMutexLocker locker(&victim->m_queueLock);
+            QList<QRunnable*> &queue = victim->m_queues[priority];
+
+            if (!queue.isEmpty()) {
+                m_numQueued[priority].deref();
+                return queue.takeFirst();
+            }
+        }
+    }
+
+    return 0;
+}
+
+void KisUpdaterExecutor::finishJob()
+{
+    if (!m_numUnfinished.deref()) {
+        QMutexLocker locker(&m_sleepLock);
+        m_allDone.wakeAll();
+    }
+}
+
+void KisUpdaterExecutor::startWorkers()
+{
+    Q_FOREACH (Worker *worker, m_workers) {
+        worker->start();
+    }
+
+    m_workersStarted = true;
+}
+
+KisUpdaterExecutor::Worker* KisUpdaterExecutor::currentWorker() const
+{
+    Worker *worker = dynamic_cast<Worker*>(QThread::currentThread());
+    return worker && worker->m_executor == this ? worker : 0;
+}
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_UPDATER_EXECUTOR_H
+#define __KIS_UPDATER_EXECUTOR_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+class QRunnable;
+
+
+/**
+ * A work-stealing replacement of QThreadPool used by KisUpdaterContext.
+ *
+ * Every worker thread has its own set of job queues, one per priority
+ * class. A job started from a worker thread (e.g. when a finished job
+ * asks the scheduler for more work) is put into the queue of that
+ * worker, the jobs started from other threads are distributed between
+ * the workers in a round-robin manner. An idle worker takes the jobs
+ * from its own queues first (in LIFO order) and steals from the others
+ * if there is nothing to do (in FIFO order).
+ *
+ * The jobs of a higher priority class are always taken before the
+ * jobs of a lower one, no matter in which queue they are.
+ *
+ * The runnables are never deleted by the executor, autoDelete()
+ * property is ignored.
+ */
+class KRITAIMAGE_EXPORT KisUpdaterExecutor
+{
+public:
+    enum Priority {
+        HIGH_PRIORITY = 0,
+        NORMAL_PRIORITY,
+        LOW_PRIORITY,
+        NUM_PRIORITIES
+    };
+
+public:
+    KisUpdaterExecutor(int threadCount);
+    ~KisUpdaterExecutor();
+
+    /**
+     * Puts \p runnable into the queue with \p priority. The worker
+     * threads are started on the first call.
+     */
+    void start(QRunnable *runnable, Priority priority = NORMAL_PRIORITY);
+
+    /**
+     * Blocks until all the started jobs are finished, including
+     * the ones started by the jobs themselves
+     */
+    void waitForDone();
+
+    int threadCount() const;
+
+private:
+    class Worker;
+    friend class Worker;
+
+    QRunnable* takeJob(Worker *thief);
+    void finishJob();
+
+    void startWorkers();
+    Worker* currentWorker() const;
+
+private:
+    Q_DISABLE_COPY(KisUpdaterExecutor)
+
+    QVector<Worker*> m_workers;
+    QAtomicInt m_nextWorker;
+    bool m_workersStarted;
+
+    /**
+     * The number of queued jobs in each priority class. Lets the
+     * workers skip empty classes without touching the queues.
+     */
+    QAtomicInt m_numQueued[NUM_PRIORITIES];
+
+    QMutex m_sleepLock;
+    QWaitCondition m_workAvailable;
+    QWaitCondition m_allDone;
+    QAtomicInt m_numUnfinished;
+    bool m_shouldExit;
+};
+
+#endif /* __KIS_UPDATER_EXECUTOR_H */
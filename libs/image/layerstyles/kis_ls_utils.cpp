@@ -72,11 +72,11 @@ namespace KisLsUtils
         KisSequentialConstIterator srcIt(device, srcRect);
         KisSequentialIterator dstIt(selection, srcRect);
 
+        int numPixels;
         do {
-            quint8 *dstPtr = dstIt.rawData();
-            const quint8* srcPtr = srcIt.rawDataConst();
-            *dstPtr = cs->opacityU8(srcPtr);
-        } while(srcIt.nextPixel() && dstIt.nextPixel());
+            numPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+            cs->copyOpacityU8(srcIt.rawDataConst(), dstIt.rawData(), numPixels);
+        } while(srcIt.nextPixels(numPixels) && dstIt.nextPixels(numPixels));
 
         return baseSelection;
     }
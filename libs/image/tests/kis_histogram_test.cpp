@@ -21,9 +21,11 @@
 #include <QTest>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
+#include <KoColor.h>
 #include <KoHistogramProducer.h>
 #include "kis_paint_device.h"
 #include "kis_histogram.h"
+#include "kis_tile_histogram_cache.h"
 #include "kis_paint_layer.h"
 #include "kis_types.h"
 
@@ -46,4 +48,105 @@ void KisHistogramTest::testCreation()
 }
 
 
+void compareProducers(KoHistogramProducer *p1, KoHistogramProducer *p2)
+{
+    QCOMPARE(p1->count(), p2->count());
+
+    for (int ch = 0; ch < p1->channels().size(); ch++) {
+        for (int i = 0; i < p1->numberOfBins(); i++) {
+            QCOMPARE(p1->getBinAt(ch, i), p2->getBinAt(ch, i));
+        }
+        QCOMPARE(p1->outOfViewLeft(ch), p2->outOfViewLeft(ch));
+        QCOMPARE(p1->outOfViewRight(ch), p2->outOfViewRight(ch));
+    }
+}
+
+void KisHistogramTest::testTileHistogramCache()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect bounds(0, 0, 1000, 700);
+
+    for (int i = 0; i < 20; i++) {
+        const QRect rc(i * 47, i * 31, 200 + i * 5, 150);
+        dev->fill(rc, KoColor(QColor(i * 12, 255 - i * 10, i * 7, 100 + i * 5), cs));
+    }
+
+    QList<QString> producers = KoHistogramProducerFactoryRegistry::instance()->keysCompatibleWith(cs, true);
+    QVERIFY(!producers.isEmpty());
+    KoHistogramProducerFactory *factory = KoHistogramProducerFactoryRegistry::instance()->get(producers.first());
+
+    KisTileHistogramCacheSP cache =
+        new KisTileHistogramCache(dev, [factory] () { return factory->generate(); }, bounds);
+
+    QScopedPointer<KoHistogramProducer> cachedProducer(factory->generate());
+
+    cache->update(cachedProducer.data());
+    QVERIFY(!cache->isDirty());
+
+    KisHistogram refHistogram(dev, bounds, factory->generate(), LINEAR);
+    compareProducers(cachedProducer.data(), refHistogram.producer());
+
+    const QRect changeRect(300, 200, 100, 80);
+    dev->fill(changeRect, KoColor(Qt::blue, cs));
+    cache->setDirty(changeRect);
+    QVERIFY(cache->isDirty());
+
+    cache->update(cachedProducer.data());
+    refHistogram.updateHistogram();
+    compareProducers(cachedProducer.data(), refHistogram.producer());
+
+    const QRect newBounds(100, 100, 600, 300);
+    cache->setBounds(newBounds);
+    cache->update(cachedProducer.data());
+
+    KisHistogram newRefHistogram(dev, newBounds, factory->generate(), LINEAR);
+    compareProducers(cachedProducer.data(), newRefHistogram.producer());
+}
+
+void KisHistogramTest::testSharedTileHistogramCache()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    KisPaintDeviceSP otherDev = new KisPaintDevice(cs);
+
+    QList<QString> producers = KoHistogramProducerFactoryRegistry::instance()->keysCompatibleWith(cs, true);
+    QVERIFY(!producers.isEmpty());
+    KoHistogramProducerFactory *factory = KoHistogramProducerFactoryRegistry::instance()->get(producers.first());
+    KisTileHistogramCache::ProducerFactory producerFactory = [factory] () { return factory->generate(); };
+
+    const QRect bounds(0, 0, 1000, 700);
+
+    KisTileHistogramCacheSP cache =
+        KisTileHistogramCache::sharedCache(dev, factory->id(), producerFactory, bounds);
+
+    // the same device and producer get the same cache
+    QCOMPARE(KisTileHistogramCache::sharedCache(dev, factory->id(), producerFactory, QRect(100, 100, 200, 200)).data(),
+             cache.data());
+
+    QVERIFY(KisTileHistogramCache::sharedCache(dev, "other", producerFactory, bounds).data() != cache.data());
+    QVERIFY(KisTileHistogramCache::sharedCache(otherDev, factory->id(), producerFactory, bounds).data() != cache.data());
+
+    // the cache does not cover the requested bounds, so it is replaced
+    KisTileHistogramCacheSP bigCache =
+        KisTileHistogramCache::sharedCache(dev, factory->id(), producerFactory, QRect(0, 0, 2000, 700));
+    QVERIFY(bigCache.data() != cache.data());
+    QCOMPARE(KisTileHistogramCache::sharedCache(dev, factory->id(), producerFactory, bounds).data(),
+             bigCache.data());
+
+    // the released cache is forgotten
+    QScopedPointer<KoHistogramProducer> producer(factory->generate());
+    bigCache->update(producer.data());
+    QVERIFY(!bigCache->isDirty());
+
+    cache = 0;
+    bigCache = 0;
+
+    cache = KisTileHistogramCache::sharedCache(dev, factory->id(), producerFactory, bounds);
+    QVERIFY(cache->isDirty());
+    QCOMPARE(cache->bounds(), bounds);
+}
+
+
 QTEST_MAIN(KisHistogramTest)
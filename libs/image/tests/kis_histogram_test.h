@@ -27,6 +27,8 @@ class KisHistogramTest : public QObject
 private Q_SLOTS:
 
     void testCreation();
+    void testTileHistogramCache();
+    void testSharedTileHistogramCache();
 
 };
 
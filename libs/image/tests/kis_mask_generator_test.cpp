@@ -182,4 +182,122 @@ void KisMaskGeneratorTest::testCopyCtorGaussRect()
 }
 
 
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include "kis_fixed_paint_device.h"
+#include "kis_brush_mask_applicator_base.h"
+
+/**
+ * Renders the mask through the applicator of the generator (which uses
+ * the SIMD row processor when the generator can be vectorized) and
+ * compares it to the values returned by valueAt()
+ */
+void testApplicatorVsValueAt(KisMaskGenerator *gen, qreal angle)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+
+    const int size = qCeil(qMax(gen->width(), gen->height())) + 6;
+    const QRect bounds(0, 0, size, size);
+    const qreal centerX = 0.5 * size + 0.3;
+    const qreal centerY = 0.5 * size - 0.2;
+
+    KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+    dev->setRect(bounds);
+    dev->initialize(OPACITY_OPAQUE_U8);
+
+    MaskProcessingData data(dev, cs, 0.0, 1.0, centerX, centerY, angle);
+
+    KisBrushMaskApplicatorBase *applicator = gen->applicator();
+    applicator->initializeData(&data);
+    applicator->process(bounds);
+
+    const quint8 *dabPointer = dev->data();
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const qreal x_ = x - centerX;
+            const qreal y_ = y - centerY;
+            const qreal maskX = data.cosa * x_ - data.sina * y_;
+            const qreal maskY = data.sina * x_ + data.cosa * y_;
+
+            const int expected = OPACITY_OPAQUE_U8 - gen->valueAt(maskX, maskY);
+            const int value = *dabPointer++;
+
+            QVERIFY2(qAbs(value - expected) <= 1,
+                     QString("Pixel (%1, %2) with angle %3: value %4, expected %5")
+                     .arg(x).arg(y).arg(angle).arg(value).arg(expected).toLatin1());
+        }
+    }
+}
+
+template <class Generator>
+void testApplicatorVsValueAtAllModes()
+{
+    const qreal angles[] = {0.0, M_PI / 6, 2.0};
+
+    for (int i = 0; i < 3; i++) {
+        for (int antialias = 0; antialias < 2; antialias++) {
+            // sharp
+            {
+                Generator gen(40, 1.0, 1.0, 1.0, 2, antialias);
+                testApplicatorVsValueAt(&gen, angles[i]);
+            }
+            // faded and squeezed
+            {
+                Generator gen(40, 0.7, 0.4, 0.6, 2, antialias);
+                testApplicatorVsValueAt(&gen, angles[i]);
+            }
+        }
+    }
+}
+
+template <class Generator>
+void testCurveApplicatorVsValueAtAllModes()
+{
+    KisCubicCurve curve;
+    curve.fromString("0,1;0.3,0.7;1,0;");
+
+    const qreal angles[] = {0.0, M_PI / 6, 2.0};
+
+    for (int i = 0; i < 3; i++) {
+        for (int antialias = 0; antialias < 2; antialias++) {
+            // sharp
+            {
+                Generator gen(40, 1.0, 1.0, 1.0, 2, curve, antialias);
+                testApplicatorVsValueAt(&gen, angles[i]);
+            }
+            // faded and squeezed
+            {
+                Generator gen(40, 0.7, 0.4, 0.6, 2, curve, antialias);
+                testApplicatorVsValueAt(&gen, angles[i]);
+            }
+        }
+    }
+}
+
+void KisMaskGeneratorTest::testApplicatorRect()
+{
+    testApplicatorVsValueAtAllModes<KisRectangleMaskGenerator>();
+}
+
+void KisMaskGeneratorTest::testApplicatorGaussCircle()
+{
+    testApplicatorVsValueAtAllModes<KisGaussCircleMaskGenerator>();
+}
+
+void KisMaskGeneratorTest::testApplicatorGaussRect()
+{
+    testApplicatorVsValueAtAllModes<KisGaussRectangleMaskGenerator>();
+}
+
+void KisMaskGeneratorTest::testApplicatorCurveCircle()
+{
+    testCurveApplicatorVsValueAtAllModes<KisCurveCircleMaskGenerator>();
+}
+
+void KisMaskGeneratorTest::testApplicatorCurveRect()
+{
+    testCurveApplicatorVsValueAtAllModes<KisCurveRectangleMaskGenerator>();
+}
+
 QTEST_MAIN(KisMaskGeneratorTest)
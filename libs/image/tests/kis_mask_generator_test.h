@@ -37,6 +37,12 @@ private Q_SLOTS:
 
     void testCopyCtorGaussCircle();
     void testCopyCtorGaussRect();
+
+    void testApplicatorRect();
+    void testApplicatorGaussCircle();
+    void testApplicatorGaussRect();
+    void testApplicatorCurveCircle();
+    void testApplicatorCurveRect();
 };
 
 #endif
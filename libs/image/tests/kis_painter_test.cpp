@@ -479,6 +479,53 @@ void KisPainterTest::testBitBltOldData()
     srcGc.deleteTransaction();
 }
 
+void KisPainterTest::testBitBltUniformTiles()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    const KoColor srcColor(QColor(255, 0, 0, 128), cs);
+    const KoColor dstColor(QColor(0, 0, 255, 255), cs);
+    const QRect fillRect(0, 0, 256, 256);
+    const QRect bltRect(10, 20, 200, 150);
+
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+    KisPaintDeviceSP refDst = new KisPaintDevice(cs);
+    src->fill(fillRect, srcColor);
+    dst->fill(fillRect, dstColor);
+    refDst->fill(fillRect, dstColor);
+
+    // the fixed device is composited pixel by pixel
+    KisFixedPaintDeviceSP fixedSrc = new KisFixedPaintDevice(cs);
+    fixedSrc->setRect(bltRect);
+    fixedSrc->initialize();
+    fixedSrc->fill(bltRect, srcColor);
+
+    KisPainter refGc(refDst);
+    refGc.setOpacity(100);
+    refGc.bltFixed(bltRect.topLeft(), fixedSrc, bltRect);
+    refGc.end();
+
+    KisPainter gc(dst);
+    gc.setOpacity(100);
+    gc.bitBlt(bltRect.topLeft(), src, bltRect);
+    gc.end();
+
+    // the vectorized ops may round the pixels of a row slightly differently
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint, dst->convertToQImage(0), refDst->convertToQImage(0), 1, 1));
+
+    // fully transparent sources change nothing
+    KisPaintDeviceSP transparentSrc = new KisPaintDevice(cs);
+    transparentSrc->fill(fillRect, KoColor(Qt::transparent, cs));
+
+    KisPainter transparentGc(dst);
+    transparentGc.bitBlt(bltRect.topLeft(), transparentSrc, bltRect);
+    transparentGc.end();
+
+    QVERIFY(TestUtil::compareQImages(errpoint, dst->convertToQImage(0), refDst->convertToQImage(0), 1, 1));
+}
+
 void KisPainterTest::benchmarkBitBlt()
 {
     quint8 p = 128;
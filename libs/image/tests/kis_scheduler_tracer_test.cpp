@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_scheduler_tracer_test.h"
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "kis_scheduler_tracer.h"
+
+
+inline qint64 histogramSum(const QVector<qint64> &histogram)
+{
+    qint64 sum = 0;
+    Q_FOREACH (qint64 value, histogram) {
+        sum += value;
+    }
+    return sum;
+}
+
+void KisSchedulerTracerTest::testDisabled()
+{
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    tracer->testingSetOutputFile(QString());
+
+    QVERIFY(!tracer->isEnabled());
+
+    const int numEvents = tracer->testingNumEvents();
+
+    int key = 0;
+    tracer->reportJobEnqueued(&key);
+    tracer->reportJobStarted(&key, KisSchedulerTracer::MERGE_JOB, QRect(0,0,64,64), 0);
+    tracer->reportJobFinished(&key);
+
+    {
+        KisSchedulerTraceScope scope("testScope");
+    }
+
+    QCOMPARE(tracer->testingNumEvents(), numEvents);
+}
+
+void KisSchedulerTracerTest::testTrace()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString fileName = dir.path() + "/trace.json";
+
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    tracer->testingSetOutputFile(fileName);
+
+    QVERIFY(tracer->isEnabled());
+
+    const qint64 numMergeJobs =
+        histogramSum(tracer->executionHistogram(KisSchedulerTracer::MERGE_JOB));
+    const qint64 numStrokeJobs =
+        histogramSum(tracer->executionHistogram(KisSchedulerTracer::STROKE_JOB));
+    const qint64 numLatencies =
+        histogramSum(tracer->latencyHistogram(KisSchedulerTracer::MERGE_JOB));
+
+    int mergeKey = 0;
+    int strokeKey = 0;
+
+    tracer->reportJobEnqueued(&mergeKey);
+    QTest::qSleep(2);
+    tracer->reportJobStarted(&mergeKey, KisSchedulerTracer::MERGE_JOB, QRect(10,20,64,32), 1);
+    tracer->reportJobFinished(&mergeKey);
+
+    // not enqueued job has no latency reported
+    tracer->reportJobStarted(&strokeKey, KisSchedulerTracer::STROKE_JOB, QRect(), 0);
+    tracer->reportJobFinished(&strokeKey);
+
+    // unknown jobs are ignored
+    int unknownKey = 0;
+    tracer->reportJobFinished(&unknownKey);
+
+    {
+        KisSchedulerTraceScope scope("testScope", QRect(1,2,3,4));
+    }
+
+    QCOMPARE(histogramSum(tracer->executionHistogram(KisSchedulerTracer::MERGE_JOB)), numMergeJobs + 1);
+    QCOMPARE(histogramSum(tracer->executionHistogram(KisSchedulerTracer::STROKE_JOB)), numStrokeJobs + 1);
+    QCOMPARE(histogramSum(tracer->latencyHistogram(KisSchedulerTracer::MERGE_JOB)), numLatencies + 1);
+    QCOMPARE(histogramSum(tracer->latencyHistogram(KisSchedulerTracer::STROKE_JOB)), qint64(0));
+
+    tracer->writeTrace();
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QJsonArray events = doc.object().value("traceEvents").toArray();
+    QCOMPARE(events.size(), tracer->testingNumEvents());
+
+    int numMergeEvents = 0;
+    int numScopeEvents = 0;
+
+    Q_FOREACH (const QJsonValue &value, events) {
+        QJsonObject event = value.toObject();
+        QCOMPARE(event.value("ph").toString(), QString("X"));
+
+        QJsonObject args = event.value("args").toObject();
+
+        if (event.value("name").toString() == "merge") {
+            numMergeEvents++;
+            QCOMPARE(args.value("x").toInt(), 10);
+            QCOMPARE(args.value("width").toInt(), 64);
+            QCOMPARE(args.value("lod").toInt(), 1);
+            QVERIFY(args.value("queueLatency").toDouble() >= 2000);
+        } else if (event.value("name").toString() == "testScope") {
+            numScopeEvents++;
+            QCOMPARE(args.value("height").toInt(), 4);
+            QVERIFY(!args.contains("queueLatency"));
+        }
+    }
+
+    QCOMPARE(numMergeEvents, 1);
+    QCOMPARE(numScopeEvents, 1);
+
+    QVERIFY(QFile::exists(fileName + ".histograms.txt"));
+
+    tracer->testingSetOutputFile(QString());
+}
+
+void KisSchedulerTracerTest::testDroppedJobs()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    KisSchedulerTracer *tracer = KisSchedulerTracer::instance();
+    tracer->testingSetOutputFile(dir.path() + "/trace.json");
+
+    const int numEnqueued = tracer->testingNumEnqueuedJobs();
+    const qint64 numLatencies =
+        histogramSum(tracer->latencyHistogram(KisSchedulerTracer::MERGE_JOB));
+
+    int droppedKey = 0;
+    int leftKey = 0;
+
+    tracer->reportJobEnqueued(&droppedKey);
+    tracer->reportJobEnqueued(&leftKey);
+    QCOMPARE(tracer->testingNumEnqueuedJobs(), numEnqueued + 2);
+
+    tracer->reportJobDropped(&droppedKey);
+    QCOMPARE(tracer->testingNumEnqueuedJobs(), numEnqueued + 1);
+
+    // a dropped job reusing the key has no latency
+    tracer->reportJobStarted(&droppedKey, KisSchedulerTracer::MERGE_JOB, QRect(), 0);
+    tracer->reportJobFinished(&droppedKey);
+    QCOMPARE(histogramSum(tracer->latencyHistogram(KisSchedulerTracer::MERGE_JOB)), numLatencies);
+
+    // stopping the tracing forgets the rest of the jobs
+    tracer->testingSetOutputFile(QString());
+    QCOMPARE(tracer->testingNumEnqueuedJobs(), 0);
+}
+
+QTEST_MAIN(KisSchedulerTracerTest)
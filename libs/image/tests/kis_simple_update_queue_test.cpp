@@ -277,5 +277,62 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testCoalescing()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->lock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, QRect(0,0,100,100), imageRect, 0);
+
+    // fully covered --- dropped
+    queue.addUpdateJob(paintLayer, QRect(10,10,50,50), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 1);
+    QVERIFY(checkWalker(walkersList[0], QRect(0,0,100,100)));
+
+    // too big to be merged --- the covered part is cut off
+    queue.addUpdateJob(paintLayer, QRect(0,50,100,500), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 2);
+    QVERIFY(checkWalker(walkersList[1], QRect(0,100,100,450)));
+
+    QCOMPARE(queue.dirtiedPixels(), qint64(100 * 100 + 50 * 50 + 100 * 500));
+
+    KisTestableUpdaterContext context(2);
+    queue.processQueue(context);
+
+    QCOMPARE(queue.recompositedPixels(), qint64(100 * 100 + 100 * 450));
+
+    queue.resetPixelCounters();
+    QCOMPARE(queue.dirtiedPixels(), qint64(0));
+    QCOMPARE(queue.recompositedPixels(), qint64(0));
+
+    context.clear();
+    QVERIFY(walkersList.isEmpty());
+
+    queue.addUpdateJob(paintLayer, QRect(600,0,100,100), imageRect, 0);
+
+    /**
+     * Partially covered --- only the uncovered part is checked for
+     * merging. Merging it would add more work than it saves.
+     */
+    queue.addUpdateJob(paintLayer, QRect(650,0,100,100), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 2);
+    QVERIFY(checkWalker(walkersList[0], QRect(600,0,100,100)));
+    QVERIFY(checkWalker(walkersList[1], QRect(700,0,50,100)));
+}
+
 QTEST_MAIN(KisSimpleUpdateQueueTest)
 
@@ -27,6 +27,7 @@
 
 #include "kis_merge_walker.h"
 #include "kis_updater_context.h"
+#include "kis_updater_executor.h"
 #include "kis_image.h"
 
 #include "scheduler_utils.h"
@@ -237,5 +238,231 @@ void KisUpdaterContextTest::stressTestExclusiveJobs()
              << "/" << NUM_CHECKS * NUM_JOBS;
 }
 
+class RecordingRunnable : public QRunnable
+{
+public:
+    RecordingRunnable(int id, QList<int> &record, QMutex &lock)
+        : m_id(id), m_record(record), m_lock(lock)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() {
+        QMutexLocker locker(&m_lock);
+        m_record.append(m_id);
+    }
+
+private:
+    int m_id;
+    QList<int> &m_record;
+    QMutex &m_lock;
+};
+
+class BlockingRunnable : public QRunnable
+{
+public:
+    BlockingRunnable() {
+        setAutoDelete(false);
+    }
+
+    void run() {
+        started.release();
+        unblock.acquire();
+    }
+
+    QSemaphore started;
+    QSemaphore unblock;
+};
+
+void KisUpdaterContextTest::testExecutorPriorities()
+{
+    KisUpdaterExecutor executor(1);
+
+    QList<int> record;
+    QMutex lock;
+
+    BlockingRunnable blocker;
+    RecordingRunnable low(KisUpdaterExecutor::LOW_PRIORITY, record, lock);
+    RecordingRunnable normal(KisUpdaterExecutor::NORMAL_PRIORITY, record, lock);
+    RecordingRunnable high(KisUpdaterExecutor::HIGH_PRIORITY, record, lock);
+
+    executor.start(&blocker);
+    blocker.started.acquire();
+
+    executor.start(&low, KisUpdaterExecutor::LOW_PRIORITY);
+    executor.start(&normal, KisUpdaterExecutor::NORMAL_PRIORITY);
+    executor.start(&high, KisUpdaterExecutor::HIGH_PRIORITY);
+
+    blocker.unblock.release();
+    executor.waitForDone();
+
+    QList<int> expected;
+    expected << KisUpdaterExecutor::HIGH_PRIORITY
+             << KisUpdaterExecutor::NORMAL_PRIORITY
+             << KisUpdaterExecutor::LOW_PRIORITY;
+
+    QCOMPARE(record, expected);
+}
+
+class SpawningRunnable : public QRunnable
+{
+public:
+    SpawningRunnable(KisUpdaterExecutor &executor, QAtomicInt &counter, int depth)
+        : m_executor(executor), m_counter(counter), m_depth(depth)
+    {
+    }
+
+    void run() {
+        m_counter.ref();
+
+        if (m_depth > 0) {
+            m_executor.start(new SpawningRunnable(m_executor, m_counter, m_depth - 1),
+                             KisUpdaterExecutor::HIGH_PRIORITY);
+            m_executor.start(new SpawningRunnable(m_executor, m_counter, m_depth - 1),
+                             KisUpdaterExecutor::LOW_PRIORITY);
+        }
+
+        // the executor never deletes the runnables itself
+        delete this;
+    }
+
+private:
+    KisUpdaterExecutor &m_executor;
+    QAtomicInt &m_counter;
+    int m_depth;
+};
+
+void KisUpdaterContextTest::stressTestExecutor()
+{
+    const int numRoots = 16;
+    const int depth = 6;
+
+    KisUpdaterExecutor executor(NUM_THREADS);
+    QAtomicInt counter;
+
+    for (int i = 0; i < numRoots; i++) {
+        executor.start(new SpawningRunnable(executor, counter, depth));
+    }
+
+    executor.waitForDone();
+
+    QCOMPARE(int(counter), numRoots * ((1 << (depth + 1)) - 1));
+}
+
+class BlockingSpontaneousJob : public KisSpontaneousJob
+{
+public:
+    void run() {
+        started.release();
+        unblock.acquire();
+    }
+
+    bool overrides(const KisSpontaneousJob *otherJob) {
+        Q_UNUSED(otherJob);
+        return false;
+    }
+
+    int levelOfDetail() const {
+        return 0;
+    }
+
+    QSemaphore started;
+    QSemaphore unblock;
+};
+
+class RecordingStrokeStrategy : public KisStrokeJobStrategy
+{
+public:
+    RecordingStrokeStrategy(QStringList &record, QMutex &lock)
+        : m_record(record), m_lock(lock)
+    {
+    }
+
+    void run(KisStrokeJobData *data) {
+        Q_UNUSED(data);
+        QMutexLocker locker(&m_lock);
+        m_record.append("stroke");
+    }
+
+private:
+    QStringList &m_record;
+    QMutex &m_lock;
+};
+
+void KisUpdaterContextTest::testStrokeJobOvertakesMergeJobs()
+{
+    /**
+     * One thread and four job slots: the thread is kept busy by
+     * a spontaneous job, so the merge and stroke jobs added after
+     * it have to wait in the executor's queues
+     */
+    KisUpdaterContext context(1, 4);
+
+    QRect imageRect(0,0,100,100);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->lock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QStringList record;
+    QMutex recordLock;
+
+    connect(&context, &KisUpdaterContext::sigContinueUpdate,
+            [&record, &recordLock] (const QRect &rc) {
+                Q_UNUSED(rc);
+                QMutexLocker locker(&recordLock);
+                record.append("merge");
+            });
+
+    BlockingSpontaneousJob *blocker = new BlockingSpontaneousJob();
+
+    context.lock();
+    context.addSpontaneousJob(blocker);
+    context.unlock();
+
+    blocker->started.acquire();
+
+    context.lock();
+
+    KisBaseRectsWalkerSP walker1 = new KisMergeWalker(imageRect);
+    walker1->collectRects(paintLayer, QRect(0,0,30,100));
+    QVERIFY(context.hasSpareThread());
+    QVERIFY(context.isJobAllowed(walker1));
+    context.addMergeJob(walker1);
+
+    KisBaseRectsWalkerSP walker2 = new KisMergeWalker(imageRect);
+    walker2->collectRects(paintLayer, QRect(60,0,30,100));
+    QVERIFY(context.hasSpareThread());
+    QVERIFY(context.isJobAllowed(walker2));
+    context.addMergeJob(walker2);
+
+    QScopedPointer<KisStrokeJobStrategy> strategy(
+        new RecordingStrokeStrategy(record, recordLock));
+
+    KisStrokeJobData *data =
+        new KisStrokeJobData(KisStrokeJobData::CONCURRENT,
+                             KisStrokeJobData::NORMAL);
+
+    QVERIFY(context.hasSpareThread());
+    context.addStrokeJob(new KisStrokeJob(strategy.data(), data, 0, true));
+
+    QVERIFY(!context.hasSpareThread());
+
+    context.unlock();
+
+    blocker->unblock.release();
+    context.waitForDone();
+
+    QStringList expected;
+    expected << "stroke" << "merge" << "merge";
+
+    QCOMPARE(record, expected);
+}
+
 QTEST_MAIN(KisUpdaterContextTest)
 
@@ -29,6 +29,9 @@ private Q_SLOTS:
     void testJobInterference();
     void testSnapshot();
     void stressTestExclusiveJobs();
+    void testExecutorPriorities();
+    void stressTestExecutor();
+    void testStrokeJobOvertakesMergeJobs();
 };
 
 #endif /* KIS_UPDATER_CONTEXT_TEST_H */
@@ -63,7 +63,18 @@ protected:
     inline qint32 calcYInTile(qint32 y, qint32 row) const {
         return y - row * KisTileData::HEIGHT;
     }
-    
+
+    /**
+     * Hints the prefetcher that the tiles in the range are going
+     * to be accessed soon
+     */
+    inline void prefetchTiles(qint32 firstCol, qint32 firstRow,
+                              qint32 lastCol, qint32 lastRow) {
+        if (m_dataManager) {
+            m_dataManager->prefetchTiles(firstCol, firstRow, lastCol, lastRow);
+        }
+    }
+
 };
 
 #endif
@@ -220,6 +220,12 @@ void KisHLineIterator2::preallocateTiles()
         unlockTile(m_tilesCache[i].oldtile);
         fetchTileDataForCache(m_tilesCache[i], m_leftCol + i, m_row);
     }
+
+    /**
+     * The iterator will most probably proceed to the next row
+     * of tiles, so ask them to be loaded from the swap in advance
+     */
+    prefetchTiles(m_leftCol, m_row + 1, m_rightCol, m_row + 1);
 }
 
 qint32 KisHLineIterator2::x() const
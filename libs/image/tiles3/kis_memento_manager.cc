@@ -195,6 +195,19 @@ void KisMementoManager::commit()
         mi->commit();
         revisionList.append(mi);
 
+        /**
+         * The parent's data is going to be used by the undo
+         * history only, so it can be stored as a delta against
+         * the newly committed data
+         */
+        if (mi->type() == KisMementoItem::CHANGED &&
+            parentMI->type() == KisMementoItem::CHANGED &&
+            parentMI->tileData() != mi->tileData()) {
+
+            KisTileDataStore::instance()->queueDeltaCompression(parentMI->tileData(),
+                                                                mi->tileData());
+        }
+
         m_headsHashTable.deleteTile(mi->col(), mi->row());
 
         iter.moveCurrentToHashTable(&m_headsHashTable);
@@ -145,6 +145,17 @@ qint32 KisRandomAccessor2::rowStride(qint32 x, qint32 y) const
     return m_ktm->rowStride(x - m_offsetX, y - m_offsetY);
 }
 
+bool KisRandomAccessor2::isTileUniform() const
+{
+    // the current tile is always the first one in the cache
+    return m_tilesCache[0]->tile->isUniform();
+}
+
+bool KisRandomAccessor2::isOldTileUniform() const
+{
+    return m_tilesCache[0]->oldtile->isUniform();
+}
+
 qint32 KisRandomAccessor2::x() const
 {
     return m_lastX;
@@ -79,6 +79,8 @@ public:
     qint32 numContiguousColumns(qint32 x) const;
     qint32 numContiguousRows(qint32 y) const;
     qint32 rowStride(qint32 x, qint32 y) const;
+    bool isTileUniform() const;
+    bool isOldTileUniform() const;
     qint32 x() const;
     qint32 y() const;
 
@@ -32,6 +32,7 @@ void KisTile::init(qint32 col, qint32 row,
     m_col = col;
     m_row = row;
     m_lockCounter = 0;
+    m_uniformityDirty.store(0);
 
     m_extent = QRect(m_col * KisTileData::WIDTH, m_row * KisTileData::HEIGHT,
                      KisTileData::WIDTH, KisTileData::HEIGHT);
@@ -134,6 +135,15 @@ inline void KisTile::unblockSwapping() const
     Q_ASSERT(m_lockCounter > 0);
 
     if(--m_lockCounter == 0) {
+        /**
+         * Someone might have checked the uniformity while the tile
+         * was being written to, so forget the result when the last
+         * user leaves
+         */
+        if(m_uniformityDirty.fetchAndStoreOrdered(0)) {
+            m_tileData->resetUniformity();
+        }
+
         m_tileData->unblockSwapping();
 
         if(!m_oldTileData.isEmpty()) {
@@ -167,6 +177,27 @@ void KisTile::lockForRead() const
 }
 
 
+void KisTile::adviseWillNeed() const
+{
+    /**
+     * The barrier lock guarantees the tile data will not
+     * be released while we are working with it
+     */
+    QMutexLocker locker(&m_swapBarrierLock);
+    KisTileDataStore::instance()->adviseWillNeed(m_tileData);
+}
+
+KisTileData* KisTile::referenceTileData() const
+{
+    /**
+     * The old tile data is released under the barrier lock
+     * as well, so it cannot be freed before we ref it
+     */
+    QMutexLocker locker(&m_swapBarrierLock);
+    m_tileData->ref();
+    return m_tileData;
+}
+
 #define lazyCopying() (m_tileData->m_usersCount>1)
 
 void KisTile::lockForWrite()
@@ -199,6 +230,19 @@ void KisTile::lockForWrite()
         m_COWMutex.unlock();
     }
 
+    /**
+     * The deduplication pass might have folded equal tile data
+     * into ours. They must get their own copies before we change
+     * the data in place. No new copies can be folded while we
+     * block swapping of the tile data.
+     */
+    if (m_tileData->m_foldedCount > 0) {
+        KisTileDataStore::instance()->unfoldTileData(m_tileData);
+    }
+
+    m_uniformityDirty.storeRelease(1);
+    m_tileData->resetUniformity();
+
     DEBUG_LOG_ACTION("lock [W]");
 }
 
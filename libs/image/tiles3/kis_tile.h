@@ -75,6 +75,20 @@ public:
     void lockForWrite();
     void unlock() const;
 
+    /**
+     * Hints the swap backend that the data of the tile is going
+     * to be accessed soon. Doesn't load anything itself.
+     */
+    void adviseWillNeed() const;
+
+    /**
+     * Returns the current tile data of the tile with its reference
+     * counter incremented, the caller should deref() it when done.
+     * The reference keeps the object alive, but doesn't make the
+     * caller a user of the data, so COW is not triggered by it.
+     */
+    KisTileData* referenceTileData() const;
+
     /* this allows us work directly on tile's data */
     inline quint8 *data() const {
         return m_tileData->data();
@@ -113,6 +127,16 @@ public:
         return m_tileData;
     }
 
+    /**
+     * Returns true if all the pixels of the tile are equal. While
+     * someone has the tile locked for writing the data may be
+     * changing, so the tile is reported as non-uniform then.
+     * The tile should be locked by the caller.
+     */
+    inline bool isUniform() const {
+        return !m_uniformityDirty.loadAcquire() && m_tileData->isUniform();
+    }
+
 private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
@@ -127,6 +151,12 @@ private:
     mutable QStack<KisTileData*> m_oldTileData;
     mutable volatile int m_lockCounter;
 
+    /**
+     * Set when the tile has been locked for writing, the cached
+     * uniformity of the tile data is reset when it is unlocked
+     */
+    mutable QAtomicInt m_uniformityDirty;
+
     qint32 m_col;
     qint32 m_row;
 
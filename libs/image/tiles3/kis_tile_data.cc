@@ -22,14 +22,34 @@
 
 #include <kis_debug.h>
 
-#include <boost/pool/singleton_pool.hpp>
+#include "kis_tile_data_slab_allocator.h"
 
 // BPP == bytes per pixel
 #define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
 #define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
+#define TILE_SIZE_16BPP (16 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
 
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
+/**
+ * The allocators are never destroyed, because the tile data may
+ * still be freed by the other static objects on exit
+ */
+static KisTileDataSlabAllocator* slabAllocator(const qint32 pixelSize)
+{
+    static KisTileDataSlabAllocator *allocator4BPP = new KisTileDataSlabAllocator(TILE_SIZE_4BPP);
+    static KisTileDataSlabAllocator *allocator8BPP = new KisTileDataSlabAllocator(TILE_SIZE_8BPP);
+    static KisTileDataSlabAllocator *allocator16BPP = new KisTileDataSlabAllocator(TILE_SIZE_16BPP);
+
+    switch(pixelSize) {
+    case 4:
+        return allocator4BPP;
+    case 8:
+        return allocator8BPP;
+    case 16:
+        return allocator16BPP;
+    default:
+        return 0;
+    }
+}
 
 const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
@@ -41,6 +61,8 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
+      m_foldedCount(0),
+      m_uniformity(UNIFORM),
       m_pixelSize(pixelSize),
       m_store(store)
 {
@@ -68,6 +90,8 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
       m_age(0),
       m_usersCount(0),
       m_refCount(0),
+      m_foldedCount(0),
+      m_uniformity(rhs.m_uniformity.load()),
       m_pixelSize(rhs.m_pixelSize),
       m_store(rhs.m_store)
 {
@@ -117,16 +141,15 @@ void KisTileData::allocateMemory()
 
 quint8* KisTileData::allocateData(const qint32 pixelSize)
 {
-    quint8 *ptr = 0;
-
-    switch(pixelSize) {
-    case 4:
-        ptr = (quint8*)BoostPool4BPP::malloc();
-        break;
-    case 8:
-        ptr = (quint8*)BoostPool8BPP::malloc();
-        break;
-    default:
+    KisTileDataSlabAllocator *allocator = slabAllocator(pixelSize);
+    quint8 *ptr = allocator ? allocator->allocate() : 0;
+
+    /**
+     * The slabs are mapped from the system in big pieces, so the
+     * mapping may fail while there is still some memory for the
+     * usual heap. freeData() recognizes such buffers.
+     */
+    if (!ptr) {
         ptr = (quint8*) malloc(pixelSize * WIDTH * HEIGHT);
     }
 
@@ -135,14 +158,9 @@ quint8* KisTileData::allocateData(const qint32 pixelSize)
 
 void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
 {
-    switch(pixelSize) {
-    case 4:
-        BoostPool4BPP::free(ptr);
-        break;
-    case 8:
-        BoostPool8BPP::free(ptr);
-        break;
-    default:
+    KisTileDataSlabAllocator *allocator = slabAllocator(pixelSize);
+
+    if (!allocator || !allocator->free(ptr)) {
         free(ptr);
     }
 }
@@ -155,25 +173,20 @@ void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
 
 void KisTileData::releaseInternalPools()
 {
-    if (!KisTileDataStore::instance()->numTiles() &&
-        !KisTileDataStore::instance()->numTilesInMemory()) {
-
-        BoostPool4BPP::purge_memory();
-        BoostPool8BPP::purge_memory();
+    /**
+     * The slabs are released only when they are completely free,
+     * so it is safe to call it while there are tiles in use
+     */
+    slabAllocator(4)->releaseFreeSlabs();
+    slabAllocator(8)->releaseFreeSlabs();
+    slabAllocator(16)->releaseFreeSlabs();
 
 #ifdef DEBUG_POOL_RELEASE
-        dbgKrita << "After purging unused memory:";
+    dbgKrita << "After purging unused memory:";
 
-        char command[256];
-        sprintf(command, "cat /proc/%d/status | grep -i vm", (int)getpid());
-        printf("--- %s ---\n", command);
-        (void)system(command);
+    char command[256];
+    sprintf(command, "cat /proc/%d/status | grep -i vm", (int)getpid());
+    printf("--- %s ---\n", command);
+    (void)system(command);
 #endif /* DEBUG_POOL_RELEASE */
-
-    }
-//    else {
-//        warnKrita << "WARNING: trying to purge pool memory while there are used tiles present!";
-//        warnKrita << "         The memory will *NOT* be returned to the system, though it will";
-//        warnKrita << "         be reused by Krita internally. Please report to developers!";
-//    }
 }
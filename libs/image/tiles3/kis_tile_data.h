@@ -38,12 +38,37 @@ inline quint8* KisTileData::data() const {
 void KisTileData::setData(const quint8 *data) {
     Q_ASSERT(m_data);
     memcpy(m_data, data, m_pixelSize*WIDTH*HEIGHT);
+    resetUniformity();
 }
 
 inline quint32 KisTileData::pixelSize() const {
     return m_pixelSize;
 }
 
+inline bool KisTileData::isUniform() const {
+    int uniformity = m_uniformity.load();
+
+    if (uniformity == UNIFORM_UNKNOWN) {
+        Q_ASSERT(m_data);
+
+        /**
+         * The data is uniform iff it is equal to itself
+         * shifted by one pixel
+         */
+        const qint32 dataSize = m_pixelSize * WIDTH * HEIGHT;
+        uniformity = !memcmp(m_data, m_data + m_pixelSize, dataSize - m_pixelSize) ?
+            UNIFORM : NOT_UNIFORM;
+
+        m_uniformity.testAndSetOrdered(UNIFORM_UNKNOWN, uniformity);
+    }
+
+    return uniformity == UNIFORM;
+}
+
+inline void KisTileData::resetUniformity() {
+    m_uniformity.store(UNIFORM_UNKNOWN);
+}
+
 inline bool KisTileData::acquire() {
     /**
      * We need to ensure the clones in the stack are
@@ -61,6 +61,12 @@ public:
         SWAPPED
     };
 
+    enum EnumUniformity {
+        UNIFORM_UNKNOWN = 0,
+        UNIFORM,
+        NOT_UNIFORM
+    };
+
     /**
      * Information about data stored
      */
@@ -68,6 +74,15 @@ public:
     inline void setData(const quint8 *data);
     inline quint32 pixelSize() const;
 
+    /**
+     * Returns true if all the pixels of the tile data are equal.
+     * The result is cached until the data is written to through
+     * KisTile::lockForWrite(). The caller should block swapping
+     * while calling it.
+     */
+    inline bool isUniform() const;
+    inline void resetUniformity();
+
     /**
      * Increments usersCount of a TD and refs shared pointer counter
      * Used by KisTile for COW
@@ -160,10 +175,13 @@ public:
     /**
      * Releases internal pools, which keep blobs where the tiles are
      * stored.  The point is that we don't allocate the tiles from
-     * glibc directly, but use pools (implemented via boost) to
-     * allocate bigger chunks. This method should be called when one
-     * knows that we have just free'd quite a lot of memory and we
-     * won't need it anymore. E.g. when a document has been closed.
+     * glibc directly, but use slabs (see KisTileDataSlabAllocator)
+     * to allocate bigger chunks. The slabs that became completely
+     * free are returned to the system automatically, except a few
+     * ones kept for reuse. This method returns all of them and
+     * should be called when one knows that we have just free'd
+     * quite a lot of memory and we won't need it anymore. E.g. when
+     * a document has been closed.
      */
     static void releaseInternalPools();
 
@@ -259,6 +277,18 @@ private:
      */
     mutable QAtomicInt m_refCount;
 
+    /**
+     * How many tile data objects have been folded into this one
+     * by the deduplication pass? They are not users of the data,
+     * so they do not take part in COW.
+     */
+    mutable QAtomicInt m_foldedCount;
+
+
+    /**
+     * Cached result of isUniform(), see EnumUniformity
+     */
+    mutable QAtomicInt m_uniformity;
 
     qint32 m_pixelSize;
     //qint32 m_timeStamp;
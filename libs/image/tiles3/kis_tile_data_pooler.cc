@@ -30,6 +30,7 @@ const qint32 KisTileDataPooler::MAX_NUM_CLONES = 16;
 const qint32 KisTileDataPooler::MAX_TIMEOUT = 60000; // 01m00s
 const qint32 KisTileDataPooler::MIN_TIMEOUT = 100; // 00m00.100s
 const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
+const qint32 KisTileDataPooler::DEDUPLICATION_INTERVAL = 10000; // 00m10s
 
 //#define DEBUG_POOLER
 
@@ -180,6 +181,7 @@ void KisTileDataPooler::run()
     if(!m_memoryLimit) return;
 
     m_shouldExitFlag = false;
+    m_deduplicationTimer.start();
 
     while (1) {
         DEBUG_SIMPLE_ACTION("went to bed... Zzz...");
@@ -216,6 +218,17 @@ void KisTileDataPooler::run()
 
         m_store->endIteration(iter);
 
+        /**
+         * Hashing all the tiles is not cheap, so we do
+         * it much rarer than the pooling cycles
+         */
+        if (m_store->tileDeduplicationEnabled() &&
+            m_deduplicationTimer.elapsed() > DEDUPLICATION_INTERVAL) {
+
+            m_store->deduplicateTileData();
+            m_deduplicationTimer.restart();
+        }
+
         DEBUG_TILE_STATISTICS();
         DEBUG_SIMPLE_ACTION("cycle finished");
     }
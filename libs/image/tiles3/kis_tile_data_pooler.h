@@ -21,6 +21,7 @@
 #include <QObject>
 #include <QThread>
 #include <QSemaphore>
+#include <QElapsedTimer>
 
 class KisTileDataStore;
 class KisTileData;
@@ -49,6 +50,7 @@ protected:
     static const qint32 MAX_TIMEOUT;
     static const qint32 MIN_TIMEOUT;
     static const qint32 TIMEOUT_FACTOR;
+    static const qint32 DEDUPLICATION_INTERVAL;
 
     void waitForWork();
     qint32 numClonesNeeded(KisTileData *td) const;
@@ -86,6 +88,7 @@ protected:
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
+    QElapsedTimer m_deduplicationTimer;
 };
 
 
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tile_data_slab_allocator.h"
+
+#include <stdlib.h>
+#include "kis_debug.h"
+
+#ifdef Q_OS_UNIX
+#define HAVE_MMAP_SLABS
+#include <sys/mman.h>
+#endif
+
+/**
+ * The size of a huge page on x86 and ARM64. The slabs are aligned
+ * to their size, so the system is able to back them with huge pages.
+ */
+const qint32 KisTileDataSlabAllocator::SLAB_SIZE = 2 * 1024 * 1024;
+/**
+ * Painting tends to free and allocate tiles in bursts, so keep a few
+ * free slabs around to avoid mapping and unmapping them repeatedly
+ */
+const qint32 KisTileDataSlabAllocator::MAX_CACHED_FREE_SLABS = 4;
+
+
+KisTileDataSlabAllocator::KisTileDataSlabAllocator(qint32 chunkSize)
+    : m_chunkSize(chunkSize),
+      m_chunksPerSlab(SLAB_SIZE / chunkSize),
+      m_numFreeSlabs(0)
+{
+    Q_ASSERT(chunkSize >= (qint32)sizeof(FreeChunk));
+    Q_ASSERT(m_chunksPerSlab > 0);
+}
+
+KisTileDataSlabAllocator::~KisTileDataSlabAllocator()
+{
+    Q_FOREACH (Slab *slab, m_slabs) {
+        destroySlab(slab);
+    }
+}
+
+quint8* KisTileDataSlabAllocator::allocate()
+{
+    QMutexLocker locker(&m_lock);
+
+    Slab *slab = 0;
+
+    if (m_availableSlabs.isEmpty()) {
+        slab = createSlab();
+        if (!slab) return 0;
+
+        m_slabs.insert(slabKey(slab->base), slab);
+        m_availableSlabs.insert(slabKey(slab->base), slab);
+        m_numFreeSlabs++;
+    } else {
+        slab = m_availableSlabs.begin().value();
+    }
+
+    quint8 *ptr = 0;
+
+    if (slab->freeList) {
+        ptr = reinterpret_cast<quint8*>(slab->freeList);
+        slab->freeList = slab->freeList->next;
+    } else {
+        /**
+         * Hand out the chunks that have never been used yet only
+         * after the freed ones, so that the pages of the slab are
+         * not touched before they are really needed
+         */
+        Q_ASSERT(slab->numUntouched > 0);
+        ptr = slab->base + (m_chunksPerSlab - slab->numUntouched) * m_chunkSize;
+        slab->numUntouched--;
+    }
+
+    if (!slab->numUsed++) {
+        m_numFreeSlabs--;
+    }
+
+    if (slab->numUsed == m_chunksPerSlab) {
+        m_availableSlabs.remove(slabKey(slab->base));
+    }
+
+    return ptr;
+}
+
+bool KisTileDataSlabAllocator::free(quint8 *ptr)
+{
+    QMutexLocker locker(&m_lock);
+
+    const quintptr key = slabKey(ptr);
+    Slab *slab = m_slabs.value(key, 0);
+    if (!slab) return false;
+
+    FreeChunk *chunk = reinterpret_cast<FreeChunk*>(ptr);
+    chunk->next = slab->freeList;
+    slab->freeList = chunk;
+
+    if (slab->numUsed-- == m_chunksPerSlab) {
+        m_availableSlabs.insert(key, slab);
+    }
+
+    if (!slab->numUsed) {
+        if (m_numFreeSlabs >= MAX_CACHED_FREE_SLABS) {
+            m_availableSlabs.remove(key);
+            m_slabs.remove(key);
+            destroySlab(slab);
+        } else {
+            m_numFreeSlabs++;
+        }
+    }
+
+    return true;
+}
+
+qint64 KisTileDataSlabAllocator::releaseFreeSlabs()
+{
+    QMutexLocker locker(&m_lock);
+
+    qint64 releasedSize = 0;
+
+    QMap<quintptr, Slab*>::iterator it = m_availableSlabs.begin();
+    while (it != m_availableSlabs.end()) {
+        Slab *slab = it.value();
+
+        if (!slab->numUsed) {
+            it = m_availableSlabs.erase(it);
+            m_slabs.remove(slabKey(slab->base));
+            destroySlab(slab);
+
+            m_numFreeSlabs--;
+            releasedSize += SLAB_SIZE;
+        } else {
+            ++it;
+        }
+    }
+
+    Q_ASSERT(!m_numFreeSlabs);
+
+    return releasedSize;
+}
+
+qint32 KisTileDataSlabAllocator::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+qint32 KisTileDataSlabAllocator::numSlabs() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_slabs.size();
+}
+
+qint32 KisTileDataSlabAllocator::numFreeSlabs() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_numFreeSlabs;
+}
+
+qint64 KisTileDataSlabAllocator::totalSlabMemory() const
+{
+    QMutexLocker locker(&m_lock);
+    return qint64(m_slabs.size()) * SLAB_SIZE;
+}
+
+KisTileDataSlabAllocator::Slab* KisTileDataSlabAllocator::createSlab()
+{
+    quint8 *base = 0;
+    void *allocation = 0;
+
+#ifdef HAVE_MMAP_SLABS
+    /**
+     * mmap() guarantees the page alignment only, so map twice as
+     * much and unmap the unaligned head and tail of the region
+     */
+    void *ptr = mmap(0, 2 * SLAB_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (ptr == MAP_FAILED) {
+        warnKrita << "KisTileDataSlabAllocator: failed to map a slab of" << SLAB_SIZE << "bytes";
+        return 0;
+    }
+
+    quint8 *region = static_cast<quint8*>(ptr);
+    base = reinterpret_cast<quint8*>(slabKey(region + SLAB_SIZE - 1));
+
+    const quintptr headSize = base - region;
+    const quintptr tailSize = SLAB_SIZE - headSize;
+
+    if (headSize) {
+        munmap(region, headSize);
+    }
+
+    if (tailSize) {
+        munmap(base + SLAB_SIZE, tailSize);
+    }
+
+#ifdef MADV_HUGEPAGE
+    madvise(base, SLAB_SIZE, MADV_HUGEPAGE);
+#endif
+
+    allocation = base;
+#else
+    allocation = malloc(2 * SLAB_SIZE);
+
+    if (!allocation) {
+        warnKrita << "KisTileDataSlabAllocator: failed to allocate a slab of" << SLAB_SIZE << "bytes";
+        return 0;
+    }
+
+    base = reinterpret_cast<quint8*>(slabKey(static_cast<quint8*>(allocation) + SLAB_SIZE - 1));
+#endif
+
+    Slab *slab = new Slab;
+    slab->base = base;
+    slab->allocation = allocation;
+    slab->freeList = 0;
+    slab->numUntouched = m_chunksPerSlab;
+    slab->numUsed = 0;
+
+    return slab;
+}
+
+void KisTileDataSlabAllocator::destroySlab(Slab *slab)
+{
+#ifdef HAVE_MMAP_SLABS
+    munmap(slab->allocation, SLAB_SIZE);
+#else
+    ::free(slab->allocation);
+#endif
+
+    delete slab;
+}
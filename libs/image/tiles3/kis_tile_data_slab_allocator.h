@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_TILE_DATA_SLAB_ALLOCATOR_H
+#define __KIS_TILE_DATA_SLAB_ALLOCATOR_H
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QHash>
+#include <QMap>
+
+
+/**
+ * Allocates the buffers of a fixed size (one tile of a fixed pixel
+ * size) from big slabs of memory requested from the system directly.
+ *
+ * The slabs are aligned to their size and are hinted to be backed by
+ * huge pages where the system supports that. The memory of a slab is
+ * not touched until the chunks are actually handed out, so the pages
+ * are placed on the NUMA node of the thread that uses them first.
+ *
+ * The chunks are always taken from the slab with the lowest address,
+ * which keeps the used memory compact. When a slab becomes completely
+ * free, it is returned to the system (only a few free slabs are kept
+ * for reuse). Call releaseFreeSlabs() to return all of them.
+ */
+class KisTileDataSlabAllocator
+{
+public:
+    static const qint32 SLAB_SIZE;
+    static const qint32 MAX_CACHED_FREE_SLABS;
+
+    KisTileDataSlabAllocator(qint32 chunkSize);
+    ~KisTileDataSlabAllocator();
+
+    /**
+     * Returns null if the system refused to give us a new slab
+     */
+    quint8* allocate();
+
+    /**
+     * Returns false if \p ptr was not allocated by this allocator
+     */
+    bool free(quint8 *ptr);
+
+    /**
+     * Returns all the completely free slabs to the system.
+     * Returns the amount of memory released (in bytes).
+     */
+    qint64 releaseFreeSlabs();
+
+    qint32 chunkSize() const;
+
+    qint32 numSlabs() const;
+    qint32 numFreeSlabs() const;
+
+    /**
+     * The memory reserved by the slabs (in bytes)
+     */
+    qint64 totalSlabMemory() const;
+
+private:
+    struct FreeChunk {
+        FreeChunk *next;
+    };
+
+    struct Slab {
+        quint8 *base;
+        void *allocation;
+
+        FreeChunk *freeList;
+        qint32 numUntouched;
+        qint32 numUsed;
+    };
+
+    Slab* createSlab();
+    void destroySlab(Slab *slab);
+
+    inline quintptr slabKey(quint8 *ptr) const {
+        return reinterpret_cast<quintptr>(ptr) & ~quintptr(SLAB_SIZE - 1);
+    }
+
+private:
+    Q_DISABLE_COPY(KisTileDataSlabAllocator)
+
+    mutable QMutex m_lock;
+
+    const qint32 m_chunkSize;
+    const qint32 m_chunksPerSlab;
+
+    QHash<quintptr, Slab*> m_slabs;
+
+    /**
+     * The slabs having at least one free chunk, sorted by address
+     */
+    QMap<quintptr, Slab*> m_availableSlabs;
+    qint32 m_numFreeSlabs;
+};
+
+#endif /* __KIS_TILE_DATA_SLAB_ALLOCATOR_H */
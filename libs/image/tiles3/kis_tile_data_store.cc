@@ -20,12 +20,15 @@
 #include "config-memory-leak-tracker.h"
 
 #include <QGlobalStatic>
+#include <QHash>
+#include <QVector>
 
 #include "kis_tile_data_store.h"
 #include "kis_tile_data.h"
 #include "kis_debug.h"
 
 #include "kis_tile_data_store_iterators.h"
+#include "kis_image_config.h"
 
 Q_GLOBAL_STATIC(KisTileDataStore, s_instance)
 
@@ -72,6 +75,10 @@ KisTileDataStore::KisTileDataStore()
       m_numTiles(0),
       m_memoryMetric(0)
 {
+    KisImageConfig config(true);
+    m_historyDeltaCompression = config.historyDeltaCompression();
+    m_tileDeduplication = config.tileDeduplication();
+
     m_clockIterator = m_tileDataList.end();
     m_pooler.start();
     m_swapper.start();
@@ -110,6 +117,12 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
 
+    stats.deduplicatedSize = m_deltaStore.foldedMemoryMetric() * metricCoeff;
+
+    stats.historicalDeltaSize = m_deltaStore.compressedSize();
+    stats.historicalDeltaSavedSize =
+        m_deltaStore.totalMemoryMetric() * metricCoeff - stats.historicalDeltaSize;
+
     return stats;
 }
 
@@ -178,10 +191,17 @@ void KisTileDataStore::freeTileData(KisTileData *td)
 
     DEBUG_FREE_ACTION(td);
 
+    KisTileData *deltaBase = 0;
+    bool deltaFolded = false;
+
     m_listLock.lock();
     td->m_swapLock.lockForWrite();
 
-    if(!td->data()) {
+    if(td->m_state == KisTileData::COMPRESSED) {
+        deltaFolded = m_deltaStore.isFolded(td);
+        deltaBase = m_deltaStore.forgetTileData(td);
+    }
+    else if(!td->data()) {
         m_swappedStore.forgetTileData(td);
     }
     else {
@@ -192,6 +212,17 @@ void KisTileDataStore::freeTileData(KisTileData *td)
     m_listLock.unlock();
 
     delete td;
+
+    /**
+     * The base may be freed here as well, so drop the
+     * reference only when all the locks are released
+     */
+    if(deltaBase) {
+        if(deltaFolded) {
+            deltaBase->m_foldedCount.deref();
+        }
+        deltaBase->deref();
+    }
 }
 
 void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
@@ -202,8 +233,24 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
     td->m_swapLock.lockForRead();
 
     while(!td->data()) {
+        /**
+         * The delta-compressed tile data needs its base to be
+         * loaded before we take any locks, because loading the
+         * base may need the same locks as well. The base cannot
+         * change while we hold the swap lock of the tile data.
+         */
+        KisTileData *deltaBase = 0;
+        if(td->m_state == KisTileData::COMPRESSED) {
+            deltaBase = m_deltaStore.deltaBase(td);
+            deltaBase->ref();
+        }
+
         td->m_swapLock.unlock();
 
+        if(deltaBase) {
+            deltaBase->blockSwapping();
+        }
+
         /**
          * The order of this heavy locking is very important.
          * Change it only in case, you really know what you are doing.
@@ -226,7 +273,24 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
         if(!td->data()) {
             td->m_swapLock.lockForWrite();
 
-            m_swappedStore.swapInTileData(td);
+            if(td->m_state == KisTileData::COMPRESSED) {
+                const bool folded = m_deltaStore.isFolded(td);
+                KisTileData *base = m_deltaStore.unpackTileData(td);
+                Q_ASSERT(base == deltaBase);
+
+                /**
+                 * We still hold our own reference to the base,
+                 * so the counter will not drop to zero here
+                 */
+                if(folded) {
+                    base->m_foldedCount.deref();
+                }
+                base->m_refCount.deref();
+                td->m_state = KisTileData::NORMAL;
+            }
+            else {
+                m_swappedStore.swapInTileData(td);
+            }
             registerTileDataImp(td);
 
             td->m_swapLock.unlock();
@@ -234,6 +298,11 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
 
         m_listLock.unlock();
 
+        if(deltaBase) {
+            deltaBase->unblockSwapping();
+            deltaBase->deref();
+        }
+
         /**
          * <-- In theory, livelock is possible here...
          */
@@ -261,6 +330,262 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+void KisTileDataStore::adviseWillNeed(KisTileData *td)
+{
+    td->m_swapLock.lockForRead();
+
+    if(!td->data() && td->m_state != KisTileData::COMPRESSED) {
+        m_swappedStore.adviseWillNeed(td);
+    }
+
+    td->m_swapLock.unlock();
+}
+
+void KisTileDataStore::prefetchTileData(KisTileData *td)
+{
+    td->m_swapLock.lockForRead();
+    const bool isCompressed = !td->data() && td->m_state == KisTileData::COMPRESSED;
+    td->m_swapLock.unlock();
+
+    if(isCompressed) return;
+
+    td->blockSwapping();
+    td->unblockSwapping();
+}
+
+void KisTileDataStore::releaseSwappedOutPages()
+{
+    m_swappedStore.releaseSwappedOutPages();
+}
+
+/**
+ * Increments the reference counter only if the tile data
+ * is not being destroyed at the moment
+ */
+static inline bool tryRefAlive(QAtomicInt &refCount)
+{
+    int value;
+    do {
+        value = refCount.load();
+        if(!value) return false;
+    } while(!refCount.testAndSetOrdered(value, value + 1));
+
+    return true;
+}
+
+qint32 KisTileDataStore::deduplicateTileData()
+{
+    typedef QPair<uint, qint32> ContentKey;
+
+    struct Candidate {
+        KisTileData *td;
+        ContentKey key;
+        bool valid;
+    };
+
+    QVector<Candidate> candidates;
+
+    /**
+     * Hashing all the tiles takes a lot of time, so we only take
+     * a snapshot of the list under the lock. The references we hold
+     * keep the tile data objects alive until the end of the pass.
+     */
+    m_listLock.lock();
+
+    candidates.reserve(m_numTiles);
+
+    KisTileDataListIterator it = m_tileDataList.begin();
+    for(; it != m_tileDataList.end(); ++it) {
+        KisTileData *td = *it;
+
+        if(tryRefAlive(td->m_refCount)) {
+            Candidate candidate;
+            candidate.td = td;
+            candidate.valid = false;
+            candidates.append(candidate);
+        }
+    }
+
+    m_listLock.unlock();
+
+    /**
+     * If we cannot take the lock, the tile data is being
+     * accessed right now, most probably, it is changing
+     */
+    for(int i = 0; i < candidates.size(); i++) {
+        Candidate &candidate = candidates[i];
+        KisTileData *td = candidate.td;
+
+        if(!td->m_swapLock.tryLockForWrite()) continue;
+
+        if(td->data()) {
+            const qint32 pixelSize = td->pixelSize();
+            const int dataSize = KisTileData::WIDTH * KisTileData::HEIGHT * pixelSize;
+            candidate.key = ContentKey(qHashBits(td->data(), dataSize), pixelSize);
+            candidate.valid = true;
+        }
+
+        td->m_swapLock.unlock();
+    }
+
+    QHash<ContentKey, KisTileData*> canonicalTiles;
+    qint32 numFolded = 0;
+
+    for(int i = 0; i < candidates.size(); i++) {
+        const Candidate &candidate = candidates[i];
+        if(!candidate.valid) continue;
+
+        KisTileData *td = candidate.td;
+        KisTileData *canonical = canonicalTiles.value(candidate.key, 0);
+
+        if(!canonical) {
+            canonicalTiles.insert(candidate.key, td);
+            continue;
+        }
+
+        /**
+         * The tiles might have changed or have been swapped out since
+         * they were hashed, so everything is rechecked under the locks
+         */
+        QMutexLocker lock(&m_listLock);
+
+        if(!td->m_swapLock.tryLockForWrite()) continue;
+
+        if(!td->data()) {
+            td->m_swapLock.unlock();
+            continue;
+        }
+
+        if(canonical->m_swapLock.tryLockForWrite()) {
+            const int dataSize = KisTileData::WIDTH * KisTileData::HEIGHT * td->pixelSize();
+
+            /**
+             * The folded tile data only references the canonical one,
+             * it doesn't become its user, so the owners of the
+             * canonical data are not forced into COW. Instead, the
+             * folded copies are restored before the canonical data
+             * is changed, see unfoldTileData(). Note that the hash
+             * may collide, so compare the data.
+             */
+            if(canonical->data() &&
+               !memcmp(canonical->data(), td->data(), dataSize) &&
+               tryRefAlive(canonical->m_refCount)) {
+
+                canonical->m_foldedCount.ref();
+
+                m_deltaStore.foldTileData(td, canonical);
+                unregisterTileDataImp(td);
+                td->m_state = KisTileData::COMPRESSED;
+                numFolded++;
+            }
+            canonical->m_swapLock.unlock();
+        }
+        else {
+            /**
+             * The canonical tile data is permanently locked (e.g. it
+             * is a default tile data of some device), let the other
+             * tiles be folded into the current one instead
+             */
+            canonicalTiles.insert(candidate.key, td);
+        }
+
+        td->m_swapLock.unlock();
+    }
+
+    /**
+     * Some of the tile data objects may have been freed by their
+     * owners during the pass, so the last reference is dropped here,
+     * when the list lock is not held anymore
+     */
+    Q_FOREACH (const Candidate &candidate, candidates) {
+        candidate.td->deref();
+    }
+
+    return numFolded;
+}
+
+void KisTileDataStore::unfoldTileData(KisTileData *base)
+{
+    QMutexLocker lock(&m_listLock);
+
+    Q_FOREACH (KisTileData *td, m_deltaStore.foldedTileData(base)) {
+        td->m_swapLock.lockForWrite();
+
+        m_deltaStore.unpackTileData(td);
+
+        /**
+         * The caller holds the base, so the counter
+         * will not drop to zero here
+         */
+        base->m_foldedCount.deref();
+        base->m_refCount.deref();
+        td->m_state = KisTileData::NORMAL;
+        registerTileDataImp(td);
+
+        td->m_swapLock.unlock();
+    }
+}
+
+void KisTileDataStore::queueDeltaCompression(KisTileData *td, KisTileData *base)
+{
+    if(!m_historyDeltaCompression) return;
+
+    td->ref();
+    base->ref();
+
+    QMutexLocker locker(&m_deltaQueueLock);
+    m_deltaQueue.append(qMakePair(td, base));
+}
+
+void KisTileDataStore::processDeltaCompressionQueue()
+{
+    QList<QPair<KisTileData*, KisTileData*> > queue;
+
+    {
+        QMutexLocker locker(&m_deltaQueueLock);
+        queue.swap(m_deltaQueue);
+    }
+
+    typedef QPair<KisTileData*, KisTileData*> DeltaRequest;
+    Q_FOREACH (const DeltaRequest &request, queue) {
+        tryDeltaCompressTileData(request.first, request.second);
+
+        request.first->deref();
+        request.second->deref();
+    }
+}
+
+bool KisTileDataStore::tryDeltaCompressTileData(KisTileData *td, KisTileData *base)
+{
+    bool result = false;
+
+    /**
+     * The tile data may have got new users since the request
+     * has been queued, e.g. after an undo, and the base may have
+     * been swapped out. The former case is checked under the lock.
+     */
+    base->blockSwapping();
+    m_listLock.lock();
+
+    if(td->m_swapLock.tryLockForWrite()) {
+        if(td->data() &&
+           td->m_state == KisTileData::NORMAL &&
+           td->historical() &&
+           m_deltaStore.packTileData(td, base)) {
+
+            unregisterTileDataImp(td);
+            td->m_state = KisTileData::COMPRESSED;
+            result = true;
+        }
+        td->m_swapLock.unlock();
+    }
+
+    m_listLock.unlock();
+    base->unblockSwapping();
+
+    return result;
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_listLock.lock();
@@ -339,6 +664,10 @@ void KisTileDataStore::debugClear()
 void KisTileDataStore::testingRereadConfig() {
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_deltaStore.testingRereadConfig();
+    KisImageConfig config(true);
+    m_historyDeltaCompression = config.historyDeltaCompression();
+    m_tileDeduplication = config.tileDeduplication();
     kickPooler();
 }
 
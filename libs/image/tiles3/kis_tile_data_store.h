@@ -26,6 +26,9 @@
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
 #include "swap/kis_swapped_data_store.h"
+#include "swap/kis_delta_data_store.h"
+
+#include <QPair>
 
 class KisTileDataStoreIterator;
 class KisTileDataStoreReverseIterator;
@@ -51,6 +54,11 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+
+        qint64 deduplicatedSize;
+
+        qint64 historicalDeltaSize;
+        qint64 historicalDeltaSavedSize;
     };
 
     MemoryStatistics memoryStatistics();
@@ -60,7 +68,7 @@ public:
      * or in a swap file
      */
     inline qint32 numTiles() const {
-        return m_numTiles + m_swappedStore.numTiles();
+        return m_numTiles + m_swappedStore.numTiles() + m_deltaStore.numTiles();
     }
 
     /**
@@ -70,6 +78,15 @@ public:
         return m_numTiles;
     }
 
+    /**
+     * Returns true if some of the tiles are swapped out. Used by
+     * the prefetching code to skip the hints when there is
+     * nothing to load.
+     */
+    inline bool hasSwappedTiles() const {
+        return m_swappedStore.numTiles() > 0;
+    }
+
     inline void checkFreeMemory() {
         m_swapper.checkFreeMemory();
     }
@@ -110,6 +127,65 @@ public:
     bool trySwapTileData(KisTileData *td);
 
 
+    /**
+     * Hints the swap backend that the swapped out \p td is going to
+     * be loaded soon. Does nothing if the data is in memory.
+     */
+    void adviseWillNeed(KisTileData *td);
+
+    /**
+     * Loads the swapped out \p td into memory and resets its age.
+     * The tile data compressed in memory (delta-compressed or
+     * folded) is left as it is, it is cheap to restore on access.
+     * Called by the prefetcher thread.
+     */
+    void prefetchTileData(KisTileData *td);
+
+    /**
+     * Lets the swap backend drop the pages of the data swapped out
+     * since the last call. Called by the swapper after a pass.
+     */
+    void releaseSwappedOutPages();
+
+    /**
+     * Returns true if the deduplication pass is enabled in the config
+     */
+    inline bool tileDeduplicationEnabled() const {
+        return m_tileDeduplication;
+    }
+
+    /**
+     * Finds the tile data objects with equal content and folds them
+     * into a single canonical tile data. The folded objects free
+     * their memory and restore it from the canonical data on the
+     * next access. Returns the number of folded tile data objects.
+     *
+     * Called by the pooler thread.
+     */
+    qint32 deduplicateTileData();
+
+    /**
+     * Restores the data of all the tile data objects folded into
+     * \p base. Called by KisTile before writing into \p base, the
+     * caller should block swapping of \p base.
+     */
+    void unfoldTileData(KisTileData *base);
+
+    /**
+     * Called by the Memento Manager on commit. Asks the store to
+     * replace the data of historical \p td with a compressed delta
+     * against its newer revision \p base. The request is processed
+     * asynchronously by the swapper thread and is silently ignored
+     * if the history delta compression is disabled in the config.
+     */
+    void queueDeltaCompression(KisTileData *td, KisTileData *base);
+
+    /**
+     * Processes the requests queued by queueDeltaCompression().
+     * Called by the swapper thread.
+     */
+    void processDeltaCompressionQueue();
+
     /**
      * WARN: The following three method are only for usage
      * in KisTileData. Do not call them directly!
@@ -140,6 +216,8 @@ private:
     inline void unregisterTileDataImp(KisTileData *td);
     void freeRegisteredTiles();
 
+    bool tryDeltaCompressTileData(KisTileData *td, KisTileData *base);
+
     friend class DeadlockyThread;
     friend class KisLowMemoryTests;
     void debugSwapAll();
@@ -158,6 +236,12 @@ private:
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
     KisSwappedDataStore m_swappedStore;
+    KisDeltaDataStore m_deltaStore;
+
+    bool m_historyDeltaCompression;
+    bool m_tileDeduplication;
+    QMutex m_deltaQueueLock;
+    QList<QPair<KisTileData*, KisTileData*> > m_deltaQueue;
 
     KisTileDataListIterator m_clockIterator;
 
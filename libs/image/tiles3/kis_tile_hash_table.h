@@ -20,6 +20,9 @@
 #ifndef KIS_TILEHASHTABLE_H_
 #define KIS_TILEHASHTABLE_H_
 
+#include <QAtomicInt>
+#include <QReadWriteLock>
+
 #include "kis_tile.h"
 
 
@@ -30,6 +33,16 @@
  * col()/row() methods and be able to answer setNext()/next() requests to
  * be   stored   here.    It   is   used   in   KisTiledDataManager   and
  * KisMementoManager.
+ *
+ * The table is  split into NUM_STRIPES lock stripes.  A tile with hash h
+ * is always stored in the bucket (h & (tableSize - 1)) and guarded by the
+ * stripe  (h & (NUM_STRIPES - 1)),  so the  stripe  of  a tile  does not
+ * depend on the current size of the table. Readers and writers of tiles
+ * lying in different stripes never touch the same lock, which lets the
+ * painting  threads  of  the  update  scheduler  create  tiles  in  the
+ * neighbouring areas concurrently. The  bucket  array grows (doubles)
+ * when the average chain length exceeds MAX_LOAD_FACTOR. Growing takes
+ * all the stripes for writing, so it is invisible to the other users.
  */
 
 template<class T>
@@ -48,7 +61,7 @@ public:
     ~KisTileHashTableTraits();
 
     bool isEmpty() {
-        return !m_numTiles;
+        return !m_numTiles.load();
     }
 
     bool tileExists(qint32 col, qint32 row);
@@ -90,7 +103,15 @@ public:
     KisTileData* defaultTileData() const;
 
     qint32 numTiles() {
-        return m_numTiles;
+        return m_numTiles.load();
+    }
+
+    /**
+     * The table may be grown by another thread at any moment,
+     * so the value is only a hint
+     */
+    qint32 tableSize() const {
+        return m_tableSize.load();
     }
 
     void debugPrintInfo();
@@ -98,9 +119,17 @@ public:
 private:
 
     TileTypeSP getTile(qint32 col, qint32 row);
-    void linkTile(TileTypeSP tile);
+    bool linkTile(TileTypeSP tile);
     TileTypeSP unlinkTile(qint32 col, qint32 row);
 
+    void growIfNeeded();
+    void rehash(qint32 newTableSize);
+
+    inline QReadWriteLock* stripeLock(quint32 hash) const;
+    void lockAllForRead() const;
+    void lockAllForWrite() const;
+    void unlockAll() const;
+
     inline void setDefaultTileDataImp(KisTileData *defaultTileData);
     inline KisTileData* defaultTileDataImp() const;
 
@@ -112,14 +141,18 @@ private:
 private:
     template<class U> friend class KisTileHashTableIteratorTraits;
 
-    static const qint32 TABLE_SIZE = 1024;
+    static const qint32 INITIAL_TABLE_SIZE = 1024;
+    static const qint32 MAX_LOAD_FACTOR = 2;
+    static const qint32 NUM_STRIPES = 32;
+
     TileTypeSP *m_hashTable;
-    qint32 m_numTiles;
+    QAtomicInt m_tableSize;
+    QAtomicInt m_numTiles;
 
     KisTileData *m_defaultTileData;
     KisMementoManager *m_mementoManager;
 
-    mutable QReadWriteLock m_lock;
+    mutable QReadWriteLock m_stripeLocks[NUM_STRIPES];
 };
 
 #include "kis_tile_hash_table_p.h"
@@ -129,7 +162,8 @@ private:
 /**
  * Walks through all tiles inside hash table
  * Note: You can't work with your hash table in a regular way
- *       during iterating with this iterator, because HT is locked.
+ *       during iterating with this iterator, because HT is locked
+ *       (all the stripes are taken for writing).
  *       The only thing you can do is to delete current tile.
  */
 template<class T>
@@ -141,16 +175,16 @@ public:
 
     KisTileHashTableIteratorTraits(KisTileHashTableTraits<T> *ht) {
         m_hashTable = ht;
+        m_hashTable->lockAllForWrite();
+
         m_index = nextNonEmptyList(0);
-        if (m_index < KisTileHashTableTraits<T>::TABLE_SIZE)
+        if (m_index < m_hashTable->m_tableSize.load())
             m_tile = m_hashTable->m_hashTable[m_index];
-
-        m_hashTable->m_lock.lockForWrite();
     }
 
     ~KisTileHashTableIteratorTraits<T>() {
         if (m_index != -1)
-            m_hashTable->m_lock.unlock();
+            m_hashTable->unlockAll();
     }
 
     KisTileHashTableIteratorTraits<T>& operator++() {
@@ -163,7 +197,7 @@ public:
             m_tile = m_tile->next();
             if (!m_tile) {
                 qint32 idx = nextNonEmptyList(m_index + 1);
-                if (idx < KisTileHashTableTraits<T>::TABLE_SIZE) {
+                if (idx < m_hashTable->m_tableSize.load()) {
                     m_index = idx;
                     m_tile = m_hashTable->m_hashTable[idx];
                 } else {
@@ -197,7 +231,7 @@ public:
 
     void destroy() {
         m_index = -1;
-        m_hashTable->m_lock.unlock();
+        m_hashTable->unlockAll();
     }
 protected:
     TileTypeSP m_tile;
@@ -208,7 +242,7 @@ protected:
     qint32 nextNonEmptyList(qint32 startIdx) {
         qint32 idx = startIdx;
 
-        while (idx < KisTileHashTableTraits<T>::TABLE_SIZE &&
+        while (idx < m_hashTable->m_tableSize.load() &&
                 !m_hashTable->m_hashTable[idx]) {
             idx++;
         }
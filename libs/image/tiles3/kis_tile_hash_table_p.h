@@ -26,12 +26,11 @@
 
 template<class T>
 KisTileHashTableTraits<T>::KisTileHashTableTraits(KisMementoManager *mm)
-        : m_lock(QReadWriteLock::NonRecursive)
 {
-    m_hashTable = new TileTypeSP [TABLE_SIZE];
+    m_tableSize.store(INITIAL_TABLE_SIZE);
+    m_hashTable = new TileTypeSP [m_tableSize.load()];
     Q_CHECK_PTR(m_hashTable);
 
-    m_numTiles = 0;
     m_defaultTileData = 0;
     m_mementoManager = mm;
 }
@@ -39,22 +38,22 @@ KisTileHashTableTraits<T>::KisTileHashTableTraits(KisMementoManager *mm)
 template<class T>
 KisTileHashTableTraits<T>::KisTileHashTableTraits(const KisTileHashTableTraits<T> &ht,
         KisMementoManager *mm)
-        : m_lock(QReadWriteLock::NonRecursive)
 {
-    QReadLocker locker(&ht.m_lock);
+    ht.lockAllForRead();
 
     m_mementoManager = mm;
     m_defaultTileData = 0;
     setDefaultTileDataImp(ht.m_defaultTileData);
 
-    m_hashTable = new TileTypeSP [TABLE_SIZE];
+    m_tableSize.store(ht.m_tableSize.load());
+    m_hashTable = new TileTypeSP [m_tableSize.load()];
     Q_CHECK_PTR(m_hashTable);
 
 
     TileTypeSP foreignTile;
     TileType* nativeTile;
     TileType* nativeTileHead;
-    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+    for (qint32 i = 0; i < m_tableSize.load(); i++) {
         nativeTileHead = 0;
 
         foreignTile = ht.m_hashTable[i];
@@ -68,7 +67,9 @@ KisTileHashTableTraits<T>::KisTileHashTableTraits(const KisTileHashTableTraits<T
 
         m_hashTable[i] = nativeTileHead;
     }
-    m_numTiles = ht.m_numTiles;
+    m_numTiles.store(ht.m_numTiles.load());
+
+    ht.unlockAll();
 }
 
 template<class T>
@@ -82,14 +83,55 @@ KisTileHashTableTraits<T>::~KisTileHashTableTraits()
 template<class T>
 quint32 KisTileHashTableTraits<T>::calculateHash(qint32 col, qint32 row)
 {
-    return ((row << 5) + (col & 0x1F)) & 0x3FF;
+    /**
+     * The row is scattered by a multiplicative (Fibonacci) hash
+     * and the column is xor'ed into it. The final shift folds the
+     * high bits, where the multiplication puts most of its entropy,
+     * into the lower bits used by the table index and the stripe.
+     * For a fixed row the lower bits stay a bijection of the lower
+     * bits of the column, so neighbouring tiles of one row (the most
+     * common access pattern of the iterators) fall into different
+     * stripes.
+     */
+    quint32 hash = (quint32(row) * 0x9E3779B1U) ^ quint32(col);
+    return hash ^ (hash >> 16);
+}
+
+template<class T>
+inline QReadWriteLock* KisTileHashTableTraits<T>::stripeLock(quint32 hash) const
+{
+    return &m_stripeLocks[hash & (NUM_STRIPES - 1)];
+}
+
+template<class T>
+void KisTileHashTableTraits<T>::lockAllForRead() const
+{
+    for (qint32 i = 0; i < NUM_STRIPES; i++) {
+        m_stripeLocks[i].lockForRead();
+    }
+}
+
+template<class T>
+void KisTileHashTableTraits<T>::lockAllForWrite() const
+{
+    for (qint32 i = 0; i < NUM_STRIPES; i++) {
+        m_stripeLocks[i].lockForWrite();
+    }
+}
+
+template<class T>
+void KisTileHashTableTraits<T>::unlockAll() const
+{
+    for (qint32 i = NUM_STRIPES - 1; i >= 0; i--) {
+        m_stripeLocks[i].unlock();
+    }
 }
 
 template<class T>
 typename KisTileHashTableTraits<T>::TileTypeSP
 KisTileHashTableTraits<T>::getTile(qint32 col, qint32 row)
 {
-    qint32 idx = calculateHash(col, row);
+    qint32 idx = calculateHash(col, row) & (m_tableSize.load() - 1);
     TileTypeSP tile = m_hashTable[idx];
 
     for (; tile; tile = tile->next()) {
@@ -103,10 +145,18 @@ KisTileHashTableTraits<T>::getTile(qint32 col, qint32 row)
     return 0;
 }
 
+/**
+ * Links the tile into its bucket. Should be called with
+ * the tile's stripe taken for writing.
+ *
+ * \return true if the table has become too dense and
+ *         should be grown with growIfNeeded() after
+ *         the stripe lock is released
+ */
 template<class T>
-void KisTileHashTableTraits<T>::linkTile(TileTypeSP tile)
+bool KisTileHashTableTraits<T>::linkTile(TileTypeSP tile)
 {
-    qint32 idx = calculateHash(tile->col(), tile->row());
+    qint32 idx = calculateHash(tile->col(), tile->row()) & (m_tableSize.load() - 1);
     TileTypeSP firstTile = m_hashTable[idx];
 
 #ifdef SHARED_TILES_SANITY_CHECK
@@ -116,14 +166,16 @@ void KisTileHashTableTraits<T>::linkTile(TileTypeSP tile)
 
     tile->setNext(firstTile);
     m_hashTable[idx] = tile;
-    m_numTiles++;
+
+    const qint32 numTiles = m_numTiles.fetchAndAddOrdered(1) + 1;
+    return numTiles > m_tableSize.load() * MAX_LOAD_FACTOR;
 }
 
 template<class T>
 typename KisTileHashTableTraits<T>::TileTypeSP
 KisTileHashTableTraits<T>::unlinkTile(qint32 col, qint32 row)
 {
-    qint32 idx = calculateHash(col, row);
+    qint32 idx = calculateHash(col, row) & (m_tableSize.load() - 1);
     TileTypeSP tile = m_hashTable[idx];
     TileTypeSP prevTile = 0;
 
@@ -146,7 +198,7 @@ KisTileHashTableTraits<T>::unlinkTile(qint32 col, qint32 row)
             tile->notifyDead();
             tile = 0;
 
-            m_numTiles--;
+            m_numTiles.deref();
             return tile;
         }
         prevTile = tile;
@@ -155,6 +207,47 @@ KisTileHashTableTraits<T>::unlinkTile(qint32 col, qint32 row)
     return 0;
 }
 
+template<class T>
+void KisTileHashTableTraits<T>::growIfNeeded()
+{
+    lockAllForWrite();
+
+    /**
+     * Someone could have already grown the table while
+     * we were waiting for the locks
+     */
+    if (m_numTiles.load() > m_tableSize.load() * MAX_LOAD_FACTOR) {
+        rehash(2 * m_tableSize.load());
+    }
+
+    unlockAll();
+}
+
+template<class T>
+void KisTileHashTableTraits<T>::rehash(qint32 newTableSize)
+{
+    TileTypeSP *newHashTable = new TileTypeSP [newTableSize];
+    Q_CHECK_PTR(newHashTable);
+
+    for (qint32 i = 0; i < m_tableSize.load(); i++) {
+        TileTypeSP tile = m_hashTable[i];
+
+        while (tile) {
+            TileTypeSP next = tile->next();
+
+            qint32 idx = calculateHash(tile->col(), tile->row()) & (newTableSize - 1);
+            tile->setNext(newHashTable[idx]);
+            newHashTable[idx] = tile;
+
+            tile = next;
+        }
+    }
+
+    delete[] m_hashTable;
+    m_hashTable = newHashTable;
+    m_tableSize.store(newTableSize);
+}
+
 template<class T>
 inline void KisTileHashTableTraits<T>::setDefaultTileDataImp(KisTileData *defaultTileData)
 {
@@ -181,7 +274,7 @@ inline KisTileData* KisTileHashTableTraits<T>::defaultTileDataImp() const
 template<class T>
 bool KisTileHashTableTraits<T>::tileExists(qint32 col, qint32 row)
 {
-    QReadLocker locker(&m_lock);
+    QReadLocker locker(stripeLock(calculateHash(col, row)));
     return getTile(col, row);
 }
 
@@ -189,7 +282,7 @@ template<class T>
 typename KisTileHashTableTraits<T>::TileTypeSP
 KisTileHashTableTraits<T>::getExistedTile(qint32 col, qint32 row)
 {
-    QReadLocker locker(&m_lock);
+    QReadLocker locker(stripeLock(calculateHash(col, row)));
     return getTile(col, row);
 }
 
@@ -198,17 +291,35 @@ typename KisTileHashTableTraits<T>::TileTypeSP
 KisTileHashTableTraits<T>::getTileLazy(qint32 col, qint32 row,
                                        bool& newTile)
 {
+    QReadWriteLock *lock = stripeLock(calculateHash(col, row));
+    newTile = false;
+
     /**
-     * FIXME: Read access is better
+     * Most of the requests are for the tiles that already
+     * exist, so try the shared lock first
      */
-    QWriteLocker locker(&m_lock);
+    {
+        QReadLocker locker(lock);
+        TileTypeSP tile = getTile(col, row);
+        if (tile) return tile;
+    }
 
-    newTile = false;
-    TileTypeSP tile = getTile(col, row);
-    if (!tile) {
-        tile = new TileType(col, row, m_defaultTileData, m_mementoManager);
-        linkTile(tile);
-        newTile = true;
+    TileTypeSP tile;
+    bool shouldGrow = false;
+
+    {
+        QWriteLocker locker(lock);
+
+        tile = getTile(col, row);
+        if (!tile) {
+            tile = new TileType(col, row, m_defaultTileData, m_mementoManager);
+            shouldGrow = linkTile(tile);
+            newTile = true;
+        }
+    }
+
+    if (shouldGrow) {
+        growIfNeeded();
     }
 
     return tile;
@@ -218,7 +329,7 @@ template<class T>
 typename KisTileHashTableTraits<T>::TileTypeSP
 KisTileHashTableTraits<T>::getReadOnlyTileLazy(qint32 col, qint32 row)
 {
-    QReadLocker locker(&m_lock);
+    QReadLocker locker(stripeLock(calculateHash(col, row)));
 
     TileTypeSP tile = getTile(col, row);
     if (!tile)
@@ -230,14 +341,22 @@ KisTileHashTableTraits<T>::getReadOnlyTileLazy(qint32 col, qint32 row)
 template<class T>
 void KisTileHashTableTraits<T>::addTile(TileTypeSP tile)
 {
-    QWriteLocker locker(&m_lock);
-    linkTile(tile);
+    bool shouldGrow = false;
+
+    {
+        QWriteLocker locker(stripeLock(calculateHash(tile->col(), tile->row())));
+        shouldGrow = linkTile(tile);
+    }
+
+    if (shouldGrow) {
+        growIfNeeded();
+    }
 }
 
 template<class T>
 void KisTileHashTableTraits<T>::deleteTile(qint32 col, qint32 row)
 {
-    QWriteLocker locker(&m_lock);
+    QWriteLocker locker(stripeLock(calculateHash(col, row)));
 
     TileTypeSP tile = unlinkTile(col, row);
 
@@ -256,11 +375,12 @@ void KisTileHashTableTraits<T>::deleteTile(TileTypeSP tile)
 template<class T>
 void KisTileHashTableTraits<T>::clear()
 {
-    QWriteLocker locker(&m_lock);
+    lockAllForWrite();
+
     TileTypeSP tile = 0;
     qint32 i;
 
-    for (i = 0; i < TABLE_SIZE; i++) {
+    for (i = 0; i < m_tableSize.load(); i++) {
         tile = m_hashTable[i];
 
         while (tile) {
@@ -275,26 +395,33 @@ void KisTileHashTableTraits<T>::clear()
             tmp->notifyDead();
             tmp = 0;
 
-            m_numTiles--;
+            m_numTiles.deref();
         }
 
         m_hashTable[i] = 0;
     }
 
-    Q_ASSERT(!m_numTiles);
+    Q_ASSERT(!m_numTiles.load());
+
+    unlockAll();
 }
 
 template<class T>
 void KisTileHashTableTraits<T>::setDefaultTileData(KisTileData *defaultTileData)
 {
-    QWriteLocker locker(&m_lock);
+    lockAllForWrite();
     setDefaultTileDataImp(defaultTileData);
+    unlockAll();
 }
 
 template<class T>
 KisTileData* KisTileHashTableTraits<T>::defaultTileData() const
 {
-    QWriteLocker locker(&m_lock);
+    /**
+     * setDefaultTileData() takes all the stripes, so
+     * holding any of them is enough
+     */
+    QReadLocker locker(&m_stripeLocks[0]);
     return defaultTileDataImp();
 }
 
@@ -307,7 +434,8 @@ void KisTileHashTableTraits<T>::debugPrintInfo()
     dbgTiles << "==========================\n"
              << "TileHashTable:"
              << "\n   def. data:\t\t" << m_defaultTileData
-             << "\n   numTiles:\t\t" << m_numTiles;
+             << "\n   numTiles:\t\t" << m_numTiles.load()
+             << "\n   tableSize:\t\t" << m_tableSize.load();
     debugListLengthDistibution();
     dbgTiles << "==========================\n";
 }
@@ -325,10 +453,10 @@ void KisTileHashTableTraits<T>::debugMaxListLength(qint32 &min, qint32 &max)
 {
     TileTypeSP tile;
     qint32 maxLen = 0;
-    qint32 minLen = m_numTiles;
+    qint32 minLen = m_numTiles.load();
     qint32 tmp = 0;
 
-    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+    for (qint32 i = 0; i < m_tableSize.load(); i++) {
         tmp = debugChainLen(i);
         if (tmp > maxLen)
             maxLen = tmp;
@@ -353,7 +481,7 @@ void KisTileHashTableTraits<T>::debugListLengthDistibution()
     qint32 *array = new qint32[arraySize];
     memset(array, 0, sizeof(qint32)*arraySize);
 
-    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+    for (qint32 i = 0; i < m_tableSize.load(); i++) {
         tmp = debugChainLen(i);
         array[tmp-min]++;
     }
@@ -375,12 +503,12 @@ void KisTileHashTableTraits<T>::sanityChecksumCheck()
      * We assume that the lock should have already been taken
      * by the code that was going to change the table
      */
-    Q_ASSERT(!m_lock.tryLockForWrite());
+    Q_ASSERT(!m_stripeLocks[0].tryLockForWrite());
 
     TileTypeSP tile = 0;
     qint32 exactNumTiles = 0;
 
-    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+    for (qint32 i = 0; i < m_tableSize.load(); i++) {
         tile = m_hashTable[i];
         while (tile) {
             exactNumTiles++;
@@ -388,10 +516,10 @@ void KisTileHashTableTraits<T>::sanityChecksumCheck()
         }
     }
 
-    if (exactNumTiles != m_numTiles) {
+    if (exactNumTiles != m_numTiles.load()) {
         dbgKrita << "Sanity check failed!";
         dbgKrita << ppVar(exactNumTiles);
-        dbgKrita << ppVar(m_numTiles);
+        dbgKrita << ppVar(m_numTiles.load());
         dbgKrita << "Wrong tiles checksum!";
         Q_ASSERT(0); // not fatalKrita for a backtrace support
     }
@@ -28,8 +28,10 @@
 #include "kis_memento_manager.h"
 #include "swap/kis_legacy_tile_compressor.h"
 #include "swap/kis_tile_compressor_factory.h"
+#include "swap/kis_tile_data_prefetcher.h"
 
 #include "kis_paint_device_writer.h"
+#include "kis_image_config.h"
 
 #include "kis_global.h"
 
@@ -133,8 +135,11 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
     KisTileHashTableIterator iter(m_hashTable);
     KisTileSP tile;
 
+    const quint8 codecId =
+        KisCompressionRegistry::idFromName(KisImageConfig(true).kraTileCompression());
+
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        KisTileCompressorFactory::create(CURRENT_VERSION, codecId);
 
     while ((tile = iter.tile())) {
         retval = compressor->writeTile(tile, store);
@@ -686,6 +691,37 @@ QRect KisTiledDataManager::extent() const
     return extentImpl();
 }
 
+void KisTiledDataManager::prefetch(const QRect &rect)
+{
+    if (!KisTileDataStore::instance()->hasSwappedTiles()) return;
+
+    const QRect rc = rect & extent();
+    if (rc.isEmpty()) return;
+
+    prefetchTiles(xToCol(rc.left()), yToRow(rc.top()),
+                  xToCol(rc.right()), yToRow(rc.bottom()));
+}
+
+void KisTiledDataManager::prefetchTiles(qint32 firstCol, qint32 firstRow,
+                                        qint32 lastCol, qint32 lastRow)
+{
+    if (!KisTileDataStore::instance()->hasSwappedTiles()) return;
+
+    QVector<KisTileSP> tiles;
+    tiles.reserve((lastCol - firstCol + 1) * (lastRow - firstRow + 1));
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            KisTileSP tile = m_hashTable->getExistedTile(col, row);
+            if (tile) {
+                tiles.append(tile);
+            }
+        }
+    }
+
+    KisTileDataPrefetcher::instance()->prefetch(tiles);
+}
+
 QRegion KisTiledDataManager::region() const
 {
     QRegion region;
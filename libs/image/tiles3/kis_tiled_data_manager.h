@@ -181,6 +181,13 @@ protected:
         return m_pixelSize;
     }
 
+    /**
+     * Passes the existing tiles in the range to the prefetcher
+     * thread. Used by the iterators to hint the next row/column.
+     */
+    void prefetchTiles(qint32 firstCol, qint32 firstRow,
+                       qint32 lastCol, qint32 lastRow);
+
     /* FIXME:*/
 public:
 
@@ -192,6 +199,14 @@ public:
 
     QRegion region() const;
 
+    /**
+     * Hints the tiles engine that the tiles covering \p rect are
+     * going to be read soon, so that they could be loaded from the
+     * swap file in the background. Does nothing if no tiles are
+     * swapped out at the moment.
+     */
+    void prefetch(const QRect &rect);
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
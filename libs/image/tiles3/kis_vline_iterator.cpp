@@ -222,6 +222,12 @@ void KisVLineIterator2::preallocateTiles()
         unlockTile(m_tilesCache[i].oldtile);
         fetchTileDataForCache(m_tilesCache[i], m_column, m_topRow + i );
     }
+
+    /**
+     * The iterator will most probably proceed to the next column
+     * of tiles, so ask them to be loaded from the swap in advance
+     */
+    prefetchTiles(m_column + 1, m_topRow, m_column + 1, m_bottomRow);
 }
 
 qint32 KisVLineIterator2::x() const
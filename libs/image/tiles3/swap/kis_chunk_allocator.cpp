@@ -27,16 +27,19 @@
 
 #define PEEK_NEXT(iter) (*(iter))
 #define PEEK_PREVIOUS(iter) (*((iter)-1))
-#define WRAP_PREVIOUS_CHUNK_DATA(iter) (KisChunk((iter)-1))
+
+const quint64 KisChunkAllocator::SIZE_CLASS_GRANULARITY = 64;
+const int KisChunkAllocator::NUM_SIZE_CLASSES = 2048;
 
 
 KisChunkAllocator::KisChunkAllocator(quint64 slabSize, quint64 storeSize)
+    : m_sizeClasses(NUM_SIZE_CLASSES)
 {
     m_storeMaxSize = storeSize;
     m_storeSlabSize = slabSize;
 
-    m_iterator = m_list.begin();
     m_storeSize = m_storeSlabSize;
+    m_tailBegin = 0;
     INIT_FAIL_COUNTER();
 }
 
@@ -46,40 +49,29 @@ KisChunkAllocator::~KisChunkAllocator()
 
 KisChunk KisChunkAllocator::getChunk(quint64 size)
 {
-    KisChunkDataListIterator startPosition = m_iterator;
-    START_COUNTING();
-
-    forever {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
-
-        if(m_iterator == m_list.end())
-            break;
-
-        m_iterator++;
-        REGISTER_STEP();
-    }
+    bool success = false;
+    KisChunk chunk = tryAllocateFromTail(size, &success);
+    if(success) return chunk;
 
     REGISTER_FAIL();
-    m_iterator = m_list.begin();
 
-    forever {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+    FreeGap gap;
+    if(takeFreeGap(size, &gap)) {
+        KisChunkDataListIterator it =
+            m_list.insert(gap.next, KisChunkData(gap.begin, size));
 
-        if(m_iterator == m_list.end() || m_iterator == startPosition)
-            break;
+        if(gap.size > size) {
+            addFreeGap(gap.begin + size, gap.size - size, gap.next);
+        }
 
-        m_iterator++;
-        REGISTER_STEP();
+        return KisChunk(it);
     }
 
     REGISTER_FAIL();
-    m_iterator = m_list.end();
 
     while ((m_storeSize += m_storeSlabSize) <= m_storeMaxSize) {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+        chunk = tryAllocateFromTail(size, &success);
+        if(success) return chunk;
     }
 
     qFatal("KisChunkAllocator: out of swap space");
@@ -88,40 +80,98 @@ KisChunk KisChunkAllocator::getChunk(quint64 size)
     return KisChunk(m_list.end());
 }
 
-bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
-                                       KisChunkDataListIterator &iterator,
-                                       quint64 size)
+KisChunk KisChunkAllocator::tryAllocateFromTail(quint64 size, bool *success)
 {
-    bool result = false;
-    quint64 highBound = m_storeSize;
-    quint64 lowBound = 0;
-    quint64 shift = 0;
+    if(m_storeSize - m_tailBegin < size) {
+        *success = false;
+        return KisChunk(m_list.end());
+    }
 
-    if(HAS_NEXT(list, iterator))
-        highBound = PEEK_NEXT(iterator).m_begin;
+    KisChunkDataListIterator it =
+        m_list.insert(m_list.end(), KisChunkData(m_tailBegin, size));
+    m_tailBegin += size;
 
-    if(HAS_PREVIOUS(list, iterator)) {
-        lowBound = PEEK_PREVIOUS(iterator).m_end;
-        shift = 1;
-    }
+    *success = true;
+    return KisChunk(it);
+}
 
-    if(GAP_SIZE(lowBound, highBound) >= size) {
-        list.insert(iterator, KisChunkData(lowBound + shift, size));
-        result = true;
+bool KisChunkAllocator::takeFreeGap(quint64 size, FreeGap *gap)
+{
+    const int firstClass = sizeClass(size);
+    START_COUNTING();
+
+    for(int i = firstClass; i < NUM_SIZE_CLASSES; i++) {
+        const QSet<quint64> &sizeClassGaps = m_sizeClasses[i];
+        if(sizeClassGaps.isEmpty()) continue;
+
+        /**
+         * Only the first and the last classes may contain gaps
+         * that are smaller than requested. Any gap from the
+         * classes in between will suit us.
+         */
+        const bool needsCheck = i == firstClass || i == NUM_SIZE_CLASSES - 1;
+
+        Q_FOREACH (quint64 begin, sizeClassGaps) {
+            const FreeGap &candidate = m_freeGaps[begin];
+            if(!needsCheck || candidate.size >= size) {
+                *gap = candidate;
+                removeFreeGap(begin);
+                return true;
+            }
+            REGISTER_STEP();
+        }
     }
 
-    return result;
+    return false;
+}
+
+void KisChunkAllocator::addFreeGap(quint64 begin, quint64 size, KisChunkDataListIterator next)
+{
+    FreeGap gap;
+    gap.begin = begin;
+    gap.size = size;
+    gap.next = next;
+
+    m_freeGaps.insert(begin, gap);
+    m_sizeClasses[sizeClass(size)].insert(begin);
+}
+
+void KisChunkAllocator::removeFreeGap(quint64 begin)
+{
+    FreeGap gap = m_freeGaps.take(begin);
+    m_sizeClasses[sizeClass(gap.size)].remove(begin);
 }
 
 void KisChunkAllocator::freeChunk(KisChunk chunk)
 {
-    if(m_iterator != m_list.end() && m_iterator == chunk.position()) {
-        m_iterator = m_list.erase(m_iterator);
+    KisChunkDataListIterator it = chunk.position();
+    Q_ASSERT(it->m_begin == chunk.begin());
+
+    quint64 begin = it->m_begin;
+    quint64 end = it->m_end;
+
+    const quint64 previousGapBegin =
+        HAS_PREVIOUS(m_list, it) ? PEEK_PREVIOUS(it).m_end + 1 : 0;
+
+    KisChunkDataListIterator next = m_list.erase(it);
+
+    if(previousGapBegin < begin) {
+        removeFreeGap(previousGapBegin);
+        begin = previousGapBegin;
+    }
+
+    if(!HAS_NEXT(m_list, next)) {
+        m_tailBegin = begin;
         return;
     }
 
-    Q_ASSERT(chunk.position()->m_begin == chunk.begin());
-    m_list.erase(chunk.position());
+    if(end + 1 < PEEK_NEXT(next).m_begin) {
+        const quint64 nextGapBegin = end + 1;
+        end += m_freeGaps[nextGapBegin].size;
+        removeFreeGap(nextGapBegin);
+    }
+
+    addFreeGap(begin, end - begin + 1, next);
 }
 
 
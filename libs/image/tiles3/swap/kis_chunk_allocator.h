@@ -20,6 +20,9 @@
 #define __KIS_CHUNK_LIST_H
 
 #include <QLinkedList>
+#include <QMap>
+#include <QSet>
+#include <QVector>
 
 #define MiB (1ULL << 20)
 
@@ -124,6 +127,16 @@ private:
 };
 
 
+/**
+ * The allocator keeps the list of allocated chunks sorted by their
+ * position in the store. Free gaps between the chunks are indexed by
+ * their size class, so finding a free place for a chunk doesn't need
+ * a scan over the list.
+ *
+ * New chunks are taken from the tail of the store first. The gaps are
+ * reused only when the tail has no space left, and the store is grown
+ * only when there is no gap big enough for the request.
+ */
 class KisChunkAllocator
 {
 public:
@@ -143,9 +156,28 @@ public:
     qreal debugFragmentation(bool toStderr = true);
 
 private:
-    bool tryInsertChunk(KisChunkDataList &list,
-                        KisChunkDataListIterator &iterator,
-                        quint64 size);
+    struct FreeGap {
+        quint64 begin;
+        quint64 size;
+
+        /**
+         * The chunk following the gap. New chunks
+         * allocated in the gap are inserted before it.
+         */
+        KisChunkDataListIterator next;
+    };
+
+    static const quint64 SIZE_CLASS_GRANULARITY;
+    static const int NUM_SIZE_CLASSES;
+
+    static inline int sizeClass(quint64 size) {
+        return qMin(size / SIZE_CLASS_GRANULARITY, quint64(NUM_SIZE_CLASSES - 1));
+    }
+
+    KisChunk tryAllocateFromTail(quint64 size, bool *success);
+    bool takeFreeGap(quint64 size, FreeGap *gap);
+    void addFreeGap(quint64 begin, quint64 size, KisChunkDataListIterator next);
+    void removeFreeGap(quint64 begin);
 
 private:
     quint64 m_storeMaxSize;
@@ -153,8 +185,15 @@ private:
 
 
     KisChunkDataList m_list;
-    KisChunkDataListIterator m_iterator;
     quint64 m_storeSize;
+
+    /**
+     * The beginning of the free space after the last chunk
+     */
+    quint64 m_tailBegin;
+
+    QMap<quint64, FreeGap> m_freeGaps;
+    QVector<QSet<quint64> > m_sizeClasses;
     DECLARE_FAIL_COUNTER()
 };
 
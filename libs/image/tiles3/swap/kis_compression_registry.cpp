@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_compression_registry.h"
+
+#include <config-compression.h>
+
+#include "kis_lzf_compression.h"
+
+#ifdef HAVE_LZ4
+#include "kis_lz4_compression.h"
+#endif
+
+#ifdef HAVE_ZSTD
+#include "kis_zstd_compression.h"
+#endif
+
+
+bool KisCompressionRegistry::isSupported(quint8 id)
+{
+    switch (id) {
+    case LZF:
+        return true;
+#ifdef HAVE_LZ4
+    case LZ4:
+        return true;
+#endif
+#ifdef HAVE_ZSTD
+    case ZSTD:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+KisAbstractCompression* KisCompressionRegistry::create(quint8 id)
+{
+    switch (id) {
+    case LZF:
+        return new KisLzfCompression();
+#ifdef HAVE_LZ4
+    case LZ4:
+        return new KisLz4Compression();
+#endif
+#ifdef HAVE_ZSTD
+    case ZSTD:
+        return new KisZstdCompression();
+#endif
+    default:
+        return 0;
+    }
+}
+
+QString KisCompressionRegistry::name(quint8 id)
+{
+    switch (id) {
+    case LZF:
+        return "LZF";
+    case LZ4:
+        return "LZ4";
+    case ZSTD:
+        return "ZSTD";
+    default:
+        return "NONE";
+    }
+}
+
+quint8 KisCompressionRegistry::idFromName(const QString &name)
+{
+    for (quint8 id = LZF; id < NUM_CODECS; id++) {
+        if (name == KisCompressionRegistry::name(id)) {
+            return id;
+        }
+    }
+
+    return NONE;
+}
+
+quint8 KisCompressionRegistry::supportedOrFallback(quint8 id)
+{
+    return isSupported(id) ? id : quint8(LZF);
+}
+
+QList<quint8> KisCompressionRegistry::supportedCodecs()
+{
+    QList<quint8> codecs;
+
+    for (quint8 id = LZF; id < NUM_CODECS; id++) {
+        if (isSupported(id)) {
+            codecs << id;
+        }
+    }
+
+    return codecs;
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_COMPRESSION_REGISTRY_H
+#define __KIS_COMPRESSION_REGISTRY_H
+
+#include "kritaimage_export.h"
+#include <QString>
+#include <QList>
+
+class KisAbstractCompression;
+
+/**
+ * Keeps the list of compression codecs available for the tiles.
+ *
+ * Every codec has a one-byte ID which is stored in the first byte
+ * of each compressed tile buffer (see KisTileCompressor2). ID 0 is
+ * reserved for uncompressed data and ID 1 is LZF, which matches the
+ * flags written by the older versions of Krita, so the legacy data
+ * is still readable.
+ *
+ * LZ4 and Zstandard are optional and are available only if Krita
+ * was built with the corresponding libraries.
+ */
+class KRITAIMAGE_EXPORT KisCompressionRegistry
+{
+public:
+    enum CodecId {
+        NONE = 0,
+        LZF = 1,
+        LZ4 = 2,
+        ZSTD = 3,
+
+        NUM_CODECS
+    };
+
+    /**
+     * \return true if the codec \p id has been compiled in
+     */
+    static bool isSupported(quint8 id);
+
+    /**
+     * Creates a new compression object for codec \p id.
+     * \return null if the codec is not supported
+     */
+    static KisAbstractCompression* create(quint8 id);
+
+    /**
+     * The name of the codec as it is written in the tile headers
+     * of the .kra files, e.g. "LZF"
+     */
+    static QString name(quint8 id);
+
+    /**
+     * \return the ID of the codec \p name or NONE if the
+     *         name is unknown
+     */
+    static quint8 idFromName(const QString &name);
+
+    /**
+     * \return \p id if it is supported and LZF otherwise
+     */
+    static quint8 supportedOrFallback(quint8 id);
+
+    static QList<quint8> supportedCodecs();
+
+private:
+    KisCompressionRegistry();
+};
+
+#endif /* __KIS_COMPRESSION_REGISTRY_H */
@@ -0,0 +1,236 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_delta_data_store.h"
+
+#include "kis_image_config.h"
+#include "kis_tile_compressor_2.h"
+#include "tiles3/kis_tile_data.h"
+
+
+namespace {
+
+inline void xorData(quint8 *dst, const quint8 *src, qint32 size)
+{
+    qint32 i = 0;
+
+    for (; i + qint32(sizeof(quint64)) <= size; i += sizeof(quint64)) {
+        quint64 d;
+        quint64 s;
+        memcpy(&d, dst + i, sizeof(quint64));
+        memcpy(&s, src + i, sizeof(quint64));
+        d ^= s;
+        memcpy(dst + i, &d, sizeof(quint64));
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+}
+
+KisDeltaDataStore::KisDeltaDataStore()
+    : m_compressor(0),
+      m_maxDeltaRatio(0.5),
+      m_memoryMetric(0),
+      m_compressedSize(0),
+      m_foldedMemoryMetric(0)
+{
+    loadConfig();
+}
+
+KisDeltaDataStore::~KisDeltaDataStore()
+{
+    delete m_compressor;
+}
+
+void KisDeltaDataStore::loadConfig()
+{
+    KisImageConfig config(true);
+
+    const quint8 codecId = KisCompressionRegistry::idFromName(config.swapTileCompression());
+
+    delete m_compressor;
+    m_compressor = new KisTileCompressor2(codecId);
+}
+
+void KisDeltaDataStore::testingRereadConfig()
+{
+    QMutexLocker locker(&m_lock);
+    loadConfig();
+}
+
+quint64 KisDeltaDataStore::numTiles() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_deltas.size();
+}
+
+bool KisDeltaDataStore::packTileData(KisTileData *td, KisTileData *base)
+{
+    Q_ASSERT(td->data());
+    Q_ASSERT(base->data());
+    Q_ASSERT(td->pixelSize() == base->pixelSize());
+
+    QMutexLocker locker(&m_lock);
+
+    const qint32 tileDataSize = KisTileData::WIDTH * KisTileData::HEIGHT * td->pixelSize();
+
+    const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
+    if(m_buffer.size() < expectedBufferSize)
+        m_buffer.resize(expectedBufferSize);
+
+    /**
+     * The compressor works with tile data objects only, so we
+     * calculate the delta in place and revert it back if the
+     * result turned out to be too big.
+     */
+    xorData(td->data(), base->data(), tileDataSize);
+
+    qint32 bytesWritten;
+    m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
+
+    if (bytesWritten > m_maxDeltaRatio * tileDataSize) {
+        xorData(td->data(), base->data(), tileDataSize);
+        return false;
+    }
+
+    Delta delta;
+    delta.base = base;
+    delta.data = QByteArray(m_buffer.constData(), bytesWritten);
+
+    base->ref();
+    td->releaseMemory();
+
+    m_deltas.insert(td, delta);
+
+    m_memoryMetric += td->pixelSize();
+    m_compressedSize += bytesWritten;
+
+    return true;
+}
+
+KisTileData* KisDeltaDataStore::unpackTileData(KisTileData *td)
+{
+    Q_ASSERT(!td->data());
+
+    QMutexLocker locker(&m_lock);
+
+    Delta delta = m_deltas.take(td);
+    Q_ASSERT(delta.base);
+    Q_ASSERT(delta.base->data());
+
+    const qint32 tileDataSize = KisTileData::WIDTH * KisTileData::HEIGHT * td->pixelSize();
+
+    td->allocateMemory();
+
+    if (delta.folded) {
+        memcpy(td->data(), delta.base->data(), tileDataSize);
+        m_foldedTileData.remove(delta.base, td);
+        m_foldedMemoryMetric -= td->pixelSize();
+    } else {
+        /**
+         * The delta lives in memory and was written by the same
+         * compressor, so a failure here means the data is corrupted.
+         * Like the swap space does on its errors, we cannot recover.
+         */
+        if (!m_compressor->decompressTileData((quint8*) delta.data.data(), delta.data.size(), td)) {
+            qFatal("KisDeltaDataStore: failed to decompress the tile delta");
+        }
+
+        xorData(td->data(), delta.base->data(), tileDataSize);
+
+        m_memoryMetric -= td->pixelSize();
+        m_compressedSize -= delta.data.size();
+    }
+
+    return delta.base;
+}
+
+void KisDeltaDataStore::foldTileData(KisTileData *td, KisTileData *base)
+{
+    Q_ASSERT(td->data());
+    Q_ASSERT(base->data());
+
+    QMutexLocker locker(&m_lock);
+
+    Delta delta;
+    delta.base = base;
+    delta.folded = true;
+
+    td->releaseMemory();
+    m_deltas.insert(td, delta);
+    m_foldedTileData.insert(base, td);
+
+    m_foldedMemoryMetric += td->pixelSize();
+}
+
+bool KisDeltaDataStore::isFolded(KisTileData *td) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_deltas.value(td).folded;
+}
+
+QList<KisTileData*> KisDeltaDataStore::foldedTileData(KisTileData *base) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_foldedTileData.values(base);
+}
+
+KisTileData* KisDeltaDataStore::deltaBase(KisTileData *td) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_deltas.value(td).base;
+}
+
+KisTileData* KisDeltaDataStore::forgetTileData(KisTileData *td)
+{
+    QMutexLocker locker(&m_lock);
+
+    Delta delta = m_deltas.take(td);
+    Q_ASSERT(delta.base);
+
+    if (delta.folded) {
+        m_foldedTileData.remove(delta.base, td);
+        m_foldedMemoryMetric -= td->pixelSize();
+    } else {
+        m_memoryMetric -= td->pixelSize();
+        m_compressedSize -= delta.data.size();
+    }
+
+    return delta.base;
+}
+
+qint64 KisDeltaDataStore::totalMemoryMetric() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_memoryMetric;
+}
+
+qint64 KisDeltaDataStore::compressedSize() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_compressedSize;
+}
+
+qint64 KisDeltaDataStore::foldedMemoryMetric() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_foldedMemoryMetric;
+}
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef __KIS_DELTA_DATA_STORE_H
+#define __KIS_DELTA_DATA_STORE_H
+
+#include "kritaimage_export.h"
+
+#include <QMutex>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+
+class KisTileData;
+class KisAbstractTileCompressor;
+
+/**
+ * Stores the historical tile data in a form of a compressed
+ * delta against a newer revision of the same tile (the base).
+ *
+ * The delta is a bytewise XOR of the two tiles, so for the usual
+ * case of a small brush stroke touching a tile most of the delta
+ * is zero and it compresses down to a few hundred bytes with the
+ * swap compressor.
+ *
+ * The store holds a reference to the base tile data for as long
+ * as the delta exists, so the base is guaranteed to be immutable
+ * (it is acquired by a memento item) and alive.
+ *
+ * The store also keeps the tile data folded by the deduplication
+ * pass. Such tile data is an exact copy of its base, so no delta is
+ * stored at all. The base is not immutable in this case, so the folded
+ * tile data should be restored before the base is changed (see
+ * foldedTileData()).
+ */
+class KRITAIMAGE_EXPORT KisDeltaDataStore
+{
+public:
+    KisDeltaDataStore();
+    ~KisDeltaDataStore();
+
+    /**
+     * Returns number of tile data objects stored as deltas
+     */
+    quint64 numTiles() const;
+
+    /**
+     * Tries to replace the data of \a td with a compressed delta
+     * against \a base. If the delta doesn't compress well enough,
+     * the tile data is left untouched and false is returned.
+     *
+     * On success the memory of \a td is released and \a base is
+     * referenced by the store.
+     *
+     * LOCKING: the lock on \a td should be taken by the caller for
+     *          writing and \a base must be blocked from swapping
+     */
+    bool packTileData(KisTileData *td, KisTileData *base);
+
+    /**
+     * Restores the data of \a td from the stored delta. Returns the
+     * base tile data, whose reference should be dropped by the
+     * caller after all the locks are released.
+     *
+     * LOCKING: the lock on \a td should be taken by the caller for
+     *          writing and the base must be blocked from swapping
+     */
+    KisTileData* unpackTileData(KisTileData *td);
+
+    /**
+     * Registers \a td as an exact copy of \a base and releases the
+     * memory of \a td. The caller must have referenced \a base, the
+     * reference is passed to the store.
+     *
+     * LOCKING: the locks on both \a td and \a base should be
+     *          taken by the caller for writing
+     */
+    void foldTileData(KisTileData *td, KisTileData *base);
+
+    /**
+     * Returns true if \a td is an exact copy of its base
+     * stored by foldTileData()
+     *
+     * LOCKING: the lock on \a td should be taken by the caller
+     */
+    bool isFolded(KisTileData *td) const;
+
+    /**
+     * Returns all the tile data objects folded into \a base
+     *
+     * LOCKING: the lock on \a base should be taken by the caller
+     */
+    QList<KisTileData*> foldedTileData(KisTileData *base) const;
+
+    /**
+     * Returns the base the \a td is stored against or null if
+     * the tile data is not stored in the delta store.
+     *
+     * LOCKING: the lock on \a td should be taken by the caller
+     */
+    KisTileData* deltaBase(KisTileData *td) const;
+
+    /**
+     * Forget the delta stored for \a td. This should be done before
+     * deleting the tile data. Returns the base tile data, whose
+     * reference should be dropped by the caller after all the locks
+     * are released.
+     */
+    KisTileData* forgetTileData(KisTileData *td);
+
+    /**
+     * Returns the metric of the tiles stored as deltas
+     * in *uncompressed* form!
+     */
+    qint64 totalMemoryMetric() const;
+
+    /**
+     * Returns the number of bytes actually occupied by the deltas
+     */
+    qint64 compressedSize() const;
+
+    /**
+     * Returns the metric of the tiles folded into their copies
+     */
+    qint64 foldedMemoryMetric() const;
+
+    void testingRereadConfig();
+
+private:
+    void loadConfig();
+
+private:
+    struct Delta {
+        Delta() : base(0), folded(false) {}
+
+        KisTileData *base;
+        QByteArray data;
+        bool folded;
+    };
+
+    QHash<KisTileData*, Delta> m_deltas;
+
+    /**
+     * The folded tile data objects indexed by their bases
+     */
+    QMultiHash<KisTileData*, KisTileData*> m_foldedTileData;
+
+    QByteArray m_buffer;
+    KisAbstractTileCompressor *m_compressor;
+
+    /**
+     * The delta is kept only if it is smaller than this
+     * fraction of the uncompressed tile
+     */
+    qreal m_maxDeltaRatio;
+
+    qint64 m_memoryMetric;
+    qint64 m_compressedSize;
+    qint64 m_foldedMemoryMetric;
+
+    mutable QMutex m_lock;
+};
+
+#endif /* __KIS_DELTA_DATA_STORE_H */
+
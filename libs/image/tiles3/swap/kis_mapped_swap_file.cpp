@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_debug.h"
+#include "kis_mapped_swap_file.h"
+
+#include <QDir>
+
+#if defined Q_OS_UNIX && Q_PROCESSOR_WORDSIZE == 8
+#define HAVE_WHOLE_FILE_MAPPING
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
+
+
+KisMappedSwapFile::KisMappedSwapFile(const QString &swapDir, quint64 maxSize, quint64 slabSize)
+    : m_base(0),
+      m_reservedSize(maxSize),
+      m_mappedSize(0),
+      m_slabSize(slabSize),
+      m_pageSize(4096)
+{
+#ifdef HAVE_WHOLE_FILE_MAPPING
+    const QString path = swapDir.isEmpty() ? QDir::tempPath() : swapDir;
+    QDir d(path);
+    if (!d.exists()) {
+        d.mkpath(path);
+    }
+    m_file.setFileTemplate(path + QDir::separator() + SWP_PREFIX);
+
+    if (!m_file.open() || m_file.fileName().isEmpty()) {
+        qWarning() << "Could not create or open swapfile";
+        return;
+    }
+
+    m_pageSize = sysconf(_SC_PAGESIZE);
+
+    /**
+     * Reserve the address space only. The pages are not backed by
+     * anything until the file is mapped over them in ensureMapped()
+     */
+    void *ptr = mmap(0, m_reservedSize, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (ptr == MAP_FAILED) {
+        warnKrita << "KisMappedSwapFile: failed to reserve" << m_reservedSize << "bytes of address space";
+        return;
+    }
+
+    m_base = static_cast<quint8*>(ptr);
+#else
+    Q_UNUSED(swapDir);
+#endif
+}
+
+KisMappedSwapFile::~KisMappedSwapFile()
+{
+#ifdef HAVE_WHOLE_FILE_MAPPING
+    if (m_base) {
+        munmap(m_base, m_reservedSize);
+    }
+#endif
+}
+
+bool KisMappedSwapFile::isValid() const
+{
+    return m_base;
+}
+
+bool KisMappedSwapFile::ensureMapped(quint64 end)
+{
+#ifdef HAVE_WHOLE_FILE_MAPPING
+    while (end >= m_mappedSize) {
+        const quint64 slabSize = qMin(m_slabSize, m_reservedSize - m_mappedSize);
+        if (!slabSize) return false;
+
+        if (!m_file.resize(m_mappedSize + slabSize)) return false;
+
+        void *ptr = mmap(m_base + m_mappedSize, slabSize,
+                         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                         m_file.handle(), m_mappedSize);
+
+        if (ptr == MAP_FAILED) return false;
+
+        m_mappedSize += slabSize;
+    }
+    return true;
+#else
+    Q_UNUSED(end);
+    return false;
+#endif
+}
+
+quint8* KisMappedSwapFile::getReadChunkPtr(const KisChunkData &readChunk)
+{
+    Q_ASSERT(readChunk.m_end < m_mappedSize);
+    return m_base + readChunk.m_begin;
+}
+
+quint8* KisMappedSwapFile::getWriteChunkPtr(const KisChunkData &writeChunk)
+{
+    if (!ensureMapped(writeChunk.m_end)) {
+        qFatal("KisMappedSwapFile: failed to grow the swap file");
+    }
+
+    return m_base + writeChunk.m_begin;
+}
+
+void KisMappedSwapFile::adviseWillNeed(const KisChunkData &chunk)
+{
+#ifdef HAVE_WHOLE_FILE_MAPPING
+    if (chunk.m_end >= m_mappedSize) return;
+
+    // round the range outwards to the page boundaries
+    const quint64 begin = chunk.m_begin & ~(m_pageSize - 1);
+    const quint64 end = chunk.m_end + 1;
+
+    madvise(m_base + begin, end - begin, MADV_WILLNEED);
+#else
+    Q_UNUSED(chunk);
+#endif
+}
+
+void KisMappedSwapFile::adviseDontNeed(const KisChunkData &range)
+{
+#ifdef HAVE_WHOLE_FILE_MAPPING
+    /**
+     * Round the range inwards to the page boundaries, so that the
+     * pages shared with the neighbouring chunks are not dropped.
+     * The mapping is shared, so the data is not lost anyway, the
+     * kernel just doesn't need to keep the pages resident.
+     */
+    const quint64 begin = (range.m_begin + m_pageSize - 1) & ~(m_pageSize - 1);
+    const quint64 end = qMin(range.m_end + 1, m_mappedSize) & ~(m_pageSize - 1);
+
+    if (end > begin) {
+        madvise(m_base + begin, end - begin, MADV_DONTNEED);
+    }
+#else
+    Q_UNUSED(range);
+#endif
+}
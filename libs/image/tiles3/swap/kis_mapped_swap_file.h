@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef __KIS_MAPPED_SWAP_FILE_H
+#define __KIS_MAPPED_SWAP_FILE_H
+
+#include <QTemporaryFile>
+
+#include "kis_abstract_swap_space.h"
+
+
+/**
+ * A swap backend that maps the whole swap file into memory instead
+ * of moving small windows over it like KisMemoryWindow does.
+ *
+ * The address space for the maximum size of the swap is reserved
+ * in the constructor, and the file is mapped into it slab by slab
+ * as the swap grows, so the pointers to the chunks never change and
+ * no remapping happens during swapping.
+ *
+ * The kernel is hinted about the access pattern with madvise(): the
+ * chunks written by the swapper are marked as not needed, and the
+ * chunks that are going to be swapped in are marked as needed.
+ *
+ * Only available on 64-bit Unix systems. Check isValid() after
+ * construction and fall back to KisMemoryWindow if it fails.
+ */
+class KisMappedSwapFile : public KisAbstractSwapSpace
+{
+public:
+    KisMappedSwapFile(const QString &swapDir, quint64 maxSize, quint64 slabSize);
+    ~KisMappedSwapFile();
+
+    bool isValid() const;
+
+    using KisAbstractSwapSpace::getReadChunkPtr;
+    using KisAbstractSwapSpace::getWriteChunkPtr;
+
+    quint8* getReadChunkPtr(const KisChunkData &readChunk);
+    quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
+
+    void adviseWillNeed(const KisChunkData &chunk);
+    void adviseDontNeed(const KisChunkData &range);
+
+private:
+    bool ensureMapped(quint64 end);
+
+private:
+    QTemporaryFile m_file;
+
+    quint8 *m_base;
+    quint64 m_reservedSize;
+    quint64 m_mappedSize;
+    quint64 m_slabSize;
+    quint64 m_pageSize;
+};
+
+#endif /* __KIS_MAPPED_SWAP_FILE_H */
+
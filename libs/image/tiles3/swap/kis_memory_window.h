@@ -21,12 +21,12 @@
 
 #include <QTemporaryFile>
 
-#include "kis_chunk_allocator.h"
+#include "kis_abstract_swap_space.h"
 
 
 #define DEFAULT_WINDOW_SIZE (16*MiB)
 
-class KisMemoryWindow
+class KisMemoryWindow : public KisAbstractSwapSpace
 {
 public:
     /**
@@ -35,13 +35,8 @@ public:
     KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE);
     ~KisMemoryWindow();
 
-    inline quint8* getReadChunkPtr(KisChunk readChunk) {
-        return getReadChunkPtr(readChunk.data());
-    }
-
-    inline quint8* getWriteChunkPtr(KisChunk writeChunk) {
-        return getWriteChunkPtr(writeChunk.data());
-    }
+    using KisAbstractSwapSpace::getReadChunkPtr;
+    using KisAbstractSwapSpace::getWriteChunkPtr;
 
     quint8* getReadChunkPtr(const KisChunkData &readChunk);
     quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
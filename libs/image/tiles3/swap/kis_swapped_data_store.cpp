@@ -17,8 +17,11 @@
  */
 
 //#include "kis_debug.h"
+#include <climits>
+
 #include "kis_swapped_data_store.h"
 #include "kis_memory_window.h"
+#include "kis_mapped_swap_file.h"
 #include "kis_image_config.h"
 
 #include "kis_tile_compressor_2.h"
@@ -26,7 +29,10 @@
 //#define COMPRESSOR_VERSION 2
 
 KisSwappedDataStore::KisSwappedDataStore()
-    : m_memoryMetric(0)
+    : m_swapSpace(0),
+      m_swappedOutBegin(ULLONG_MAX),
+      m_swappedOutEnd(0),
+      m_memoryMetric(0)
 {
     KisImageConfig config;
     const quint64 maxSwapSize = config.maxSwapSize() * MiB;
@@ -34,10 +40,24 @@ KisSwappedDataStore::KisSwappedDataStore()
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
-    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    if (config.swapWholeFileMapping()) {
+        KisMappedSwapFile *mappedFile =
+            new KisMappedSwapFile(config.swapDir(), maxSwapSize, swapSlabSize);
+
+        if (mappedFile->isValid()) {
+            m_swapSpace = mappedFile;
+        } else {
+            delete mappedFile;
+        }
+    }
+
+    if (!m_swapSpace) {
+        m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    }
+
+    const quint8 codecId = KisCompressionRegistry::idFromName(config.swapTileCompression());
+    m_compressor = new KisTileCompressor2(codecId);
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
@@ -77,6 +97,9 @@ void KisSwappedDataStore::swapOutTileData(KisTileData *td)
     quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
     memcpy(ptr, m_buffer.data(), bytesWritten);
 
+    m_swappedOutBegin = qMin(m_swappedOutBegin, chunk.begin());
+    m_swappedOutEnd = qMax(m_swappedOutEnd, chunk.end());
+
     td->releaseMemory();
     td->setSwapChunk(chunk);
 
@@ -102,6 +125,30 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
     m_memoryMetric -= td->pixelSize();
 }
 
+void KisSwappedDataStore::adviseWillNeed(KisTileData *td)
+{
+    QMutexLocker locker(&m_lock);
+    m_swapSpace->adviseWillNeed(td->swapChunk().data());
+}
+
+void KisSwappedDataStore::releaseSwappedOutPages()
+{
+    QMutexLocker locker(&m_lock);
+
+    if (m_swappedOutBegin > m_swappedOutEnd) return;
+
+    /**
+     * The range may contain chunks that are still going to be read,
+     * but that is not a problem, since the mapping is shared and the
+     * kernel will just read the pages back on access.
+     */
+    m_swapSpace->adviseDontNeed(KisChunkData(m_swappedOutBegin,
+                                             m_swappedOutEnd - m_swappedOutBegin + 1));
+
+    m_swappedOutBegin = ULLONG_MAX;
+    m_swappedOutEnd = 0;
+}
+
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
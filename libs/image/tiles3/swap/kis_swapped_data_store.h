@@ -29,7 +29,7 @@ class QMutex;
 class KisTileData;
 class KisAbstractTileCompressor;
 class KisChunkAllocator;
-class KisMemoryWindow;
+class KisAbstractSwapSpace;
 
 class KRITAIMAGE_EXPORT KisSwappedDataStore
 {
@@ -65,6 +65,20 @@ public:
      */
     void forgetTileData(KisTileData *td);
 
+    /**
+     * Hints the swap backend that the data of \a td is going to be
+     * swapped in soon.
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    void adviseWillNeed(KisTileData *td);
+
+    /**
+     * Hints the swap backend that the data swapped out since the
+     * last call is not going to be accessed soon.
+     */
+    void releaseSwappedOutPages();
+
     /**
      * Retorns the metric of the total memory stored in the swap
      * in *uncompressed* form!
@@ -81,7 +95,14 @@ private:
     KisAbstractTileCompressor *m_compressor;
 
     KisChunkAllocator *m_allocator;
-    KisMemoryWindow *m_swapSpace;
+    KisAbstractSwapSpace *m_swapSpace;
+
+    /**
+     * The range of the swap written since the last
+     * call to releaseSwappedOutPages()
+     */
+    quint64 m_swappedOutBegin;
+    quint64 m_swappedOutEnd;
 
     QMutex m_lock;
 
@@ -17,22 +17,44 @@
  */
 
 #include "kis_tile_compressor_2.h"
-#include "kis_lzf_compression.h"
+#include "kis_abstract_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(quint8 codecId)
 {
-    m_compression = new KisLzfCompression();
+    for (int i = 0; i < KisCompressionRegistry::NUM_CODECS; i++) {
+        m_codecs[i] = 0;
+    }
+
+    m_codecId = KisCompressionRegistry::supportedOrFallback(codecId);
+    m_compressionName = KisCompressionRegistry::name(m_codecId);
+    m_compression = compressionForCodec(m_codecId);
 }
 
 KisTileCompressor2::~KisTileCompressor2()
 {
-    delete m_compression;
+    for (int i = 0; i < KisCompressionRegistry::NUM_CODECS; i++) {
+        delete m_codecs[i];
+    }
+}
+
+quint8 KisTileCompressor2::codecId() const
+{
+    return m_codecId;
+}
+
+KisAbstractCompression* KisTileCompressor2::compressionForCodec(quint8 codecId)
+{
+    if (codecId >= KisCompressionRegistry::NUM_CODECS) return 0;
+
+    if (!m_codecs[codecId]) {
+        m_codecs[codecId] = KisCompressionRegistry::create(codecId);
+    }
+
+    return m_codecs[codecId];
 }
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
@@ -75,7 +97,16 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        /**
+         * The actual codec of the tile is stored in its data flag,
+         * the name in the header is needed for the older versions
+         * of Krita only. Still we can refuse the unknown codecs early.
+         */
+        if (!KisCompressionRegistry::isSupported(KisCompressionRegistry::idFromName(compressionName))) {
+            warnFile << "Unsupported tile compression:" << compressionName;
+            return false;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
@@ -129,8 +160,8 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
-        buffer[0] = COMPRESSED_DATA_FLAG;
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
+        buffer[0] = m_codecId;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
@@ -148,12 +179,18 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
     const qint32 pixelSize = tileData->pixelSize();
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
 
-    if(buffer[0] == COMPRESSED_DATA_FLAG) {
+    if(buffer[0] != RAW_DATA_FLAG) {
+        KisAbstractCompression *compression = compressionForCodec(buffer[0]);
+        if (!compression) {
+            warnTiles << "Tile data is compressed with an unsupported codec" << buffer[0];
+            return false;
+        }
+
         prepareWorkBuffers(tileDataSize);
 
         qint32 bytesWritten;
-        bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                               (quint8*)m_linearizationBuffer.data(), tileDataSize);
         if (bytesWritten == tileDataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
                                                       tileData->data(),
@@ -20,13 +20,26 @@
 #define __KIS_TILE_COMPRESSOR_2_H
 
 #include "kis_abstract_tile_compressor.h"
+#include "kis_compression_registry.h"
 
 class KisAbstractCompression;
 
+/**
+ * Every compressed tile starts with a one-byte flag. It is either
+ * RAW_DATA_FLAG, when the data was incompressible, or the ID of the
+ * codec that compressed it (see KisCompressionRegistry). The flag
+ * written by the LZF codec is the same as the old
+ * COMPRESSED_DATA_FLAG, so the tiles compressed by the older
+ * versions of Krita are decompressed as usual.
+ *
+ * The compressor always writes with the codec passed to the
+ * constructor, but can read the tiles written with any supported
+ * codec.
+ */
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    KisTileCompressor2(quint8 codecId = KisCompressionRegistry::LZF);
     virtual ~KisTileCompressor2();
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store);
@@ -38,6 +51,8 @@ public:
     bool decompressTileData(quint8 *buffer, qint32 bufferSize, KisTileData *tileData);
     qint32 tileDataBufferSize(KisTileData *tileData);
 
+    quint8 codecId() const;
+
 private:
     /**
      * Quite self describing
@@ -49,16 +64,25 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    KisAbstractCompression* compressionForCodec(quint8 codecId);
+
 private:
-    static const qint8 RAW_DATA_FLAG = 0;
-    static const qint8 COMPRESSED_DATA_FLAG = 1;
+    static const quint8 RAW_DATA_FLAG = KisCompressionRegistry::NONE;
 
 private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+
+    quint8 m_codecId;
+    QString m_compressionName;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+
+    /**
+     * Lazily created decompressors for the tiles written
+     * by codecs other than m_codecId
+     */
+    KisAbstractCompression *m_codecs[KisCompressionRegistry::NUM_CODECS];
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
@@ -25,13 +25,20 @@
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
 public:
-    static KisAbstractTileCompressorSP create(qint32 version) {
+    /**
+     * \param codecId the codec used for writing the tiles, see
+     *        KisCompressionRegistry. It is ignored by the legacy
+     *        compressor. The tiles are always read with the codec
+     *        they were written with.
+     */
+    static KisAbstractTileCompressorSP create(qint32 version,
+                                              quint8 codecId = KisCompressionRegistry::LZF) {
         switch(version) {
         case 1:
             return new KisLegacyTileCompressor();
             break;
         case 2:
-            return new KisTileCompressor2();
+            return new KisTileCompressor2(codecId);
             break;
         default:
             qFatal("Unknown version of the tiles");
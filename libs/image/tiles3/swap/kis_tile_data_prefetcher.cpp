@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+#include "tiles3/kis_tile_data_store.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QAtomicInt>
+#include <QGlobalStatic>
+
+
+const int KisTileDataPrefetcher::MAX_QUEUE_SIZE = 4096;
+const int KisTileDataPrefetcher::BATCH_SIZE = 64;
+
+Q_GLOBAL_STATIC(KisTileDataPrefetcher, s_instance)
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+    QMutex lock;
+    QWaitCondition waitCondition;
+    QQueue<KisTileData*> queue;
+    bool shouldExitFlag = false;
+
+    QAtomicInt numPrefetchedTiles;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher()
+    : QThread(),
+      m_d(new Private())
+{
+    start(QThread::LowPriority);
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    terminatePrefetcher();
+    delete m_d;
+}
+
+KisTileDataPrefetcher* KisTileDataPrefetcher::instance()
+{
+    return s_instance;
+}
+
+void KisTileDataPrefetcher::prefetch(const QVector<KisTileSP> &tiles)
+{
+    if (tiles.isEmpty()) return;
+
+    QVector<KisTileData*> droppedData;
+
+    {
+        QMutexLocker locker(&m_d->lock);
+
+        Q_FOREACH (KisTileSP tile, tiles) {
+            m_d->queue.enqueue(tile->referenceTileData());
+        }
+
+        /**
+         * The hints become outdated pretty quickly, so if the consumer
+         * cannot keep up, just drop the oldest ones
+         */
+        while (m_d->queue.size() > MAX_QUEUE_SIZE) {
+            droppedData.append(m_d->queue.dequeue());
+        }
+
+        m_d->waitCondition.wakeOne();
+    }
+
+    /**
+     * Dropping the last reference frees the tile data, which
+     * takes the store locks, so do it without holding ours
+     */
+    Q_FOREACH (KisTileData *td, droppedData) {
+        td->deref();
+    }
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    QQueue<KisTileData*> droppedData;
+
+    {
+        QMutexLocker locker(&m_d->lock);
+        m_d->shouldExitFlag = true;
+        droppedData.swap(m_d->queue);
+        m_d->waitCondition.wakeOne();
+    }
+    wait();
+
+    Q_FOREACH (KisTileData *td, droppedData) {
+        td->deref();
+    }
+}
+
+qint64 KisTileDataPrefetcher::numPrefetchedTiles() const
+{
+    return m_d->numPrefetchedTiles;
+}
+
+void KisTileDataPrefetcher::run()
+{
+    QVector<KisTileData*> batch;
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    while (1) {
+        {
+            QMutexLocker locker(&m_d->lock);
+
+            while (m_d->queue.isEmpty() && !m_d->shouldExitFlag) {
+                m_d->waitCondition.wait(&m_d->lock);
+            }
+
+            if (m_d->shouldExitFlag) return;
+
+            while (!m_d->queue.isEmpty() && batch.size() < BATCH_SIZE) {
+                batch.append(m_d->queue.dequeue());
+            }
+        }
+
+        /**
+         * First let the swap backend start reading all the
+         * chunks of the batch, so that the disk requests could
+         * be served in parallel. If no tile uses the data anymore,
+         * the tile is gone and there is nothing to load.
+         */
+        Q_FOREACH (KisTileData *td, batch) {
+            if (td->numUsers() > 0) {
+                store->adviseWillNeed(td);
+            }
+        }
+
+        /**
+         * Loading the data from the swap also resets its age,
+         * so the swapper will not try to push it back immediately.
+         */
+        Q_FOREACH (KisTileData *td, batch) {
+            if (td->numUsers() > 0) {
+                store->prefetchTileData(td);
+                m_d->numPrefetchedTiles.ref();
+            }
+
+            td->deref();
+        }
+
+        batch.clear();
+    }
+}
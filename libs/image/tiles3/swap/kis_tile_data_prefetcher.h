@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef KIS_TILE_DATA_PREFETCHER_H_
+#define KIS_TILE_DATA_PREFETCHER_H_
+
+#include <QThread>
+#include <QVector>
+
+#include "kritaimage_export.h"
+#include "tiles3/kis_tile.h"
+
+
+/**
+ * The prefetcher is a helper thread that loads tiles back from
+ * the swap file before anyone actually needs them. The iterators
+ * and the update walkers pass it tiles they are going to read
+ * soon, so the decompression is done in the background instead of
+ * blocking the painting thread inside KisTile::lockForRead().
+ *
+ * The hints are not guaranteed to be processed. If the queue is
+ * overflowed, the oldest requests are dropped.
+ *
+ * The queue doesn't keep the tiles alive. It references their
+ * tile data objects instead, which doesn't trigger COW, and skips
+ * the data which is not used by any tile anymore.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileDataPrefetcher();
+    virtual ~KisTileDataPrefetcher();
+
+    static KisTileDataPrefetcher* instance();
+
+    /**
+     * Queue the tiles for loading into memory. The call never blocks
+     * on the swap file itself.
+     */
+    void prefetch(const QVector<KisTileSP> &tiles);
+
+    void terminatePrefetcher();
+
+    /**
+     * The number of tiles that have been touched by the prefetcher
+     * since its creation. Used for testing purposes only.
+     */
+    qint64 numPrefetchedTiles() const;
+
+private:
+    void run();
+
+private:
+    static const int MAX_QUEUE_SIZE;
+    static const int BATCH_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* KIS_TILE_DATA_PREFETCHER_H_ */
+
@@ -96,6 +96,7 @@ void KisTileDataSwapper::run()
 
         QThread::msleep(DELAY);
 
+        m_d->store->processDeltaCompressionQueue();
         doJob();
     }
 }
@@ -233,6 +234,10 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 
     strategy::endIteration(m_d->store, iter);
 
+    if(freedMetric > 0) {
+        m_d->store->releaseSwappedOutPages();
+    }
+
     return freedMetric;
 }
 
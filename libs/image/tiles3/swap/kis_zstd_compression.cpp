@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_zstd_compression.h"
+
+#include <config-compression.h>
+
+#ifdef HAVE_ZSTD
+
+#include <zstd.h>
+
+
+KisZstdCompression::KisZstdCompression(int compressionLevel)
+    : m_compressionLevel(compressionLevel),
+      m_compressionContext(ZSTD_createCCtx()),
+      m_decompressionContext(ZSTD_createDCtx())
+{
+    Q_CHECK_PTR(m_compressionContext);
+    Q_CHECK_PTR(m_decompressionContext);
+}
+
+KisZstdCompression::~KisZstdCompression()
+{
+    ZSTD_freeCCtx(m_compressionContext);
+    ZSTD_freeDCtx(m_decompressionContext);
+}
+
+qint32 KisZstdCompression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    const size_t result = ZSTD_compressCCtx(m_compressionContext,
+                                            output, outputLength,
+                                            input, inputLength,
+                                            m_compressionLevel);
+
+    return !ZSTD_isError(result) ? qint32(result) : 0;
+}
+
+qint32 KisZstdCompression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    const size_t result = ZSTD_decompressDCtx(m_decompressionContext,
+                                              output, outputLength,
+                                              input, inputLength);
+
+    return !ZSTD_isError(result) ? qint32(result) : 0;
+}
+
+qint32 KisZstdCompression::outputBufferSize(qint32 dataSize)
+{
+    return ZSTD_compressBound(dataSize);
+}
+
+#endif /* HAVE_ZSTD */
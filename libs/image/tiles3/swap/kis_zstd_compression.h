@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_ZSTD_COMPRESSION_H
+#define __KIS_ZSTD_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+/**
+ * Zstandard gives noticeably better ratio than LZF at a
+ * comparable speed, so it is used for saving the layers
+ * into .kra files.
+ *
+ * The compression contexts are reused between the calls,
+ * so the object must not be shared between threads.
+ */
+class KRITAIMAGE_EXPORT KisZstdCompression : public KisAbstractCompression
+{
+public:
+    KisZstdCompression(int compressionLevel = DEFAULT_LEVEL);
+    virtual ~KisZstdCompression();
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength);
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength);
+
+    qint32 outputBufferSize(qint32 dataSize);
+
+public:
+    static const int DEFAULT_LEVEL = 3;
+
+private:
+    Q_DISABLE_COPY(KisZstdCompression)
+
+    int m_compressionLevel;
+    ZSTD_CCtx_s *m_compressionContext;
+    ZSTD_DCtx_s *m_decompressionContext;
+};
+
+#endif /* __KIS_ZSTD_COMPRESSION_H */
@@ -23,6 +23,7 @@
 
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_compression_registry.h"
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -221,6 +222,38 @@ void KisCompressionTests::testLzfOverflow()
     delete compression;
 }
 
+void KisCompressionTests::testLz4RoundTrip()
+{
+    KisAbstractCompression *compression =
+        KisCompressionRegistry::create(KisCompressionRegistry::LZ4);
+
+    if (!compression) {
+        QSKIP("Krita is built without LZ4 support");
+    }
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+    testOverflow(compression);
+
+    delete compression;
+}
+
+void KisCompressionTests::testZstdRoundTrip()
+{
+    KisAbstractCompression *compression =
+        KisCompressionRegistry::create(KisCompressionRegistry::ZSTD);
+
+    if (!compression) {
+        QSKIP("Krita is built without zstd support");
+    }
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+    testOverflow(compression);
+
+    delete compression;
+}
+
 void KisCompressionTests::benchmarkMemCpy()
 {
     QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
@@ -261,6 +294,33 @@ void KisCompressionTests::benchmarkDecompressionLzfTwoPass()
     benchmarkDecompressionTwoPass(compression);
     delete compression;
 }
+#define CODEC_BENCHMARK(function, codecId)                                  \
+    KisAbstractCompression *compression = KisCompressionRegistry::create(codecId); \
+    if (!compression) {                                                     \
+        QSKIP("The codec is not supported by this build");                  \
+    }                                                                       \
+    function(compression);                                                  \
+    delete compression
+
+void KisCompressionTests::benchmarkCompressionLz4TwoPass()
+{
+    CODEC_BENCHMARK(benchmarkCompressionTwoPass, KisCompressionRegistry::LZ4);
+}
+
+void KisCompressionTests::benchmarkDecompressionLz4TwoPass()
+{
+    CODEC_BENCHMARK(benchmarkDecompressionTwoPass, KisCompressionRegistry::LZ4);
+}
+
+void KisCompressionTests::benchmarkCompressionZstdTwoPass()
+{
+    CODEC_BENCHMARK(benchmarkCompressionTwoPass, KisCompressionRegistry::ZSTD);
+}
+
+void KisCompressionTests::benchmarkDecompressionZstdTwoPass()
+{
+    CODEC_BENCHMARK(benchmarkDecompressionTwoPass, KisCompressionRegistry::ZSTD);
+}
 
 QTEST_MAIN(KisCompressionTests)
 
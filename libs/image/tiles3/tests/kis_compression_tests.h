@@ -41,6 +41,8 @@ private:
 private Q_SLOTS:
     void testLzfRoundTrip();
     void testLzfOverflow();
+    void testLz4RoundTrip();
+    void testZstdRoundTrip();
 
     void benchmarkMemCpy();
 
@@ -48,6 +50,11 @@ private Q_SLOTS:
     void benchmarkCompressionLzfTwoPass();
     void benchmarkDecompressionLzf();
     void benchmarkDecompressionLzfTwoPass();
+
+    void benchmarkCompressionLz4TwoPass();
+    void benchmarkDecompressionLz4TwoPass();
+    void benchmarkCompressionZstdTwoPass();
+    void benchmarkDecompressionZstdTwoPass();
 };
 
 #endif /* KIS_COMPRESSION_TESTS_H */
@@ -22,6 +22,7 @@
 #include "kis_debug.h"
 
 #include "../swap/kis_memory_window.h"
+#include "../swap/kis_mapped_swap_file.h"
 
 void KisMemoryWindowTest::testWindow()
 {
@@ -52,6 +53,50 @@ void KisMemoryWindowTest::testWindow()
     QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
 }
 
+void KisMemoryWindowTest::testMappedSwapFile()
+{
+    const quint64 slabSize = MiB;
+    KisMappedSwapFile memory(QString(), 16 * slabSize, slabSize);
+
+    if (!memory.isValid()) {
+        QSKIP("Whole file mapping is not supported on this system");
+    }
+
+    const quint8 chunkLength = 100;
+
+    quint8 oddBuf[chunkLength];
+    memset(oddBuf, 0xee, chunkLength);
+
+    // the second chunk crosses the boundary of the slabs
+    KisChunkData chunk1(0, chunkLength);
+    KisChunkData chunk2(slabSize - chunkLength / 2, chunkLength);
+    KisChunkData chunk3(5 * slabSize, chunkLength);
+
+    quint8 *ptr;
+
+    ptr = memory.getWriteChunkPtr(chunk1);
+    memcpy(ptr, oddBuf, chunkLength);
+
+    ptr = memory.getWriteChunkPtr(chunk2);
+    memcpy(ptr, oddBuf, chunkLength);
+
+    ptr = memory.getWriteChunkPtr(chunk3);
+    memcpy(ptr, oddBuf, chunkLength);
+
+    // dropping the pages must not lose the data
+    memory.adviseDontNeed(KisChunkData(0, 6 * slabSize));
+    memory.adviseWillNeed(chunk2);
+
+    ptr = memory.getReadChunkPtr(chunk1);
+    QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
+
+    ptr = memory.getReadChunkPtr(chunk2);
+    QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
+
+    ptr = memory.getReadChunkPtr(chunk3);
+    QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
+}
+
 void KisMemoryWindowTest::testTopReports()
 {
 
@@ -22,6 +22,7 @@
 #include "tiles3/kis_tiled_data_manager.h"
 #include "tiles3/swap/kis_legacy_tile_compressor.h"
 #include "tiles3/swap/kis_tile_compressor_2.h"
+#include "tiles3/swap/kis_compression_registry.h"
 
 #include "tiles_test_utils.h"
 
@@ -179,6 +180,55 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testLowLevelRoundTripAllCodecs()
+{
+    Q_FOREACH (quint8 codecId, KisCompressionRegistry::supportedCodecs()) {
+        KisTileCompressor2 *compressor = new KisTileCompressor2(codecId);
+        QCOMPARE(compressor->codecId(), codecId);
+
+        doRoundTrip(compressor);
+        doLowLevelRoundTrip(compressor);
+        doLowLevelRoundTripIncompressible(compressor);
+        delete compressor;
+    }
+}
+
+void KisTileCompressorsTest::testReadLzfDataWithOtherCodec()
+{
+    const qint32 pixelSize = 1;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager dm(pixelSize, &oddPixel1);
+    KisTileSP tile = dm.getTile(0, 0, true);
+    tile->lockForWrite();
+
+    KisTileData *td = tile->tileData();
+
+    /**
+     * The data written by the LZF codec should be readable by
+     * the compressors configured for any other codec, because
+     * this is the format of all the existing swap and .kra data
+     */
+    KisTileCompressor2 lzfCompressor(KisCompressionRegistry::LZF);
+
+    qint32 bufferSize = lzfCompressor.tileDataBufferSize(td);
+    quint8 *buffer = new quint8[bufferSize];
+    qint32 bytesWritten;
+    lzfCompressor.compressTileData(td, buffer, bufferSize, bytesWritten);
+    QCOMPARE(buffer[0], quint8(KisCompressionRegistry::LZF));
+
+    Q_FOREACH (quint8 codecId, KisCompressionRegistry::supportedCodecs()) {
+        KisTileCompressor2 compressor(codecId);
+
+        memset(td->data(), oddPixel2, TILESIZE);
+        QVERIFY(compressor.decompressTileData(buffer, bytesWritten, td));
+        QVERIFY(memoryIsFilled(oddPixel1, td->data(), TILESIZE));
+    }
+
+    delete[] buffer;
+    tile->unlock();
+}
 
 QTEST_MAIN(KisTileCompressorsTest)
 
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tile_data_slab_allocator_test.h"
+#include <QTest>
+
+#include "kis_debug.h"
+
+#include "../kis_tile_data_slab_allocator.h"
+
+#define CHUNK_SIZE (16 * 64 * 64)
+#define CHUNKS_PER_SLAB (KisTileDataSlabAllocator::SLAB_SIZE / CHUNK_SIZE)
+#define NUM_SLABS (KisTileDataSlabAllocator::MAX_CACHED_FREE_SLABS + 3)
+#define NUM_CHUNKS (NUM_SLABS * CHUNKS_PER_SLAB)
+
+
+void KisTileDataSlabAllocatorTest::testAllocation()
+{
+    KisTileDataSlabAllocator allocator(CHUNK_SIZE);
+    QVector<quint8*> chunks;
+
+    for (int i = 0; i < NUM_CHUNKS; i++) {
+        quint8 *ptr = allocator.allocate();
+        QVERIFY(ptr);
+        memset(ptr, i, CHUNK_SIZE);
+        chunks.append(ptr);
+    }
+
+    QCOMPARE(allocator.numSlabs(), NUM_SLABS);
+
+    for (int i = 0; i < NUM_CHUNKS; i++) {
+        QCOMPARE(chunks[i][0], quint8(i));
+        QCOMPARE(chunks[i][CHUNK_SIZE - 1], quint8(i));
+    }
+
+    /**
+     * All the slabs are full, so the freed chunk must be reused
+     */
+    quint8 *freedPtr = chunks[NUM_CHUNKS / 2];
+    allocator.free(freedPtr);
+    QCOMPARE(allocator.allocate(), freedPtr);
+
+    Q_FOREACH (quint8 *ptr, chunks) {
+        QVERIFY(allocator.free(ptr));
+    }
+
+    /**
+     * The buffers allocated elsewhere are not accepted
+     */
+    quint8 *foreignPtr = (quint8*) malloc(CHUNK_SIZE);
+    QVERIFY(!allocator.free(foreignPtr));
+    free(foreignPtr);
+}
+
+void KisTileDataSlabAllocatorTest::testReleaseSlabs()
+{
+    KisTileDataSlabAllocator allocator(CHUNK_SIZE);
+    QVector<quint8*> chunks;
+
+    for (int i = 0; i < NUM_CHUNKS; i++) {
+        chunks.append(allocator.allocate());
+    }
+
+    QVERIFY(allocator.numSlabs() > KisTileDataSlabAllocator::MAX_CACHED_FREE_SLABS + 1);
+
+    /**
+     * Keep the first chunk only, all the slabs except the first
+     * one should be returned to the system automatically, apart
+     * from the cached ones
+     */
+    for (int i = 1; i < NUM_CHUNKS; i++) {
+        allocator.free(chunks[i]);
+    }
+
+    QCOMPARE(allocator.numFreeSlabs(), KisTileDataSlabAllocator::MAX_CACHED_FREE_SLABS);
+    QCOMPARE(allocator.numSlabs(), KisTileDataSlabAllocator::MAX_CACHED_FREE_SLABS + 1);
+
+    QCOMPARE(allocator.releaseFreeSlabs(),
+             qint64(KisTileDataSlabAllocator::MAX_CACHED_FREE_SLABS) * KisTileDataSlabAllocator::SLAB_SIZE);
+
+    QCOMPARE(allocator.numFreeSlabs(), 0);
+    QCOMPARE(allocator.numSlabs(), 1);
+    QCOMPARE(allocator.totalSlabMemory(), qint64(KisTileDataSlabAllocator::SLAB_SIZE));
+
+    allocator.free(chunks[0]);
+}
+
+QTEST_MAIN(KisTileDataSlabAllocatorTest)
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tile_hash_table_test.h"
+#include <QTest>
+
+#include <QAtomicInt>
+#include <QScopedPointer>
+#include <QThread>
+
+#include "kis_debug.h"
+
+#include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+
+#define PIXEL_SIZE 4
+
+/**
+ * The tiles created before the readers start
+ */
+#define NUM_INITIAL_COLS 32
+#define NUM_INITIAL_ROWS 32
+
+/**
+ * The writer adds rows until the table has grown this many times
+ */
+#define NUM_REHASHES 4
+
+#define NUM_READERS 4
+
+
+class TileReaderThread : public QThread
+{
+public:
+    TileReaderThread(KisTileHashTable *ht, QAtomicInt *stop)
+        : m_ht(ht),
+          m_stop(stop)
+    {
+    }
+
+    void run() {
+        do {
+            for (qint32 row = 0; row < NUM_INITIAL_ROWS; row++) {
+                for (qint32 col = 0; col < NUM_INITIAL_COLS; col++) {
+                    KisTileSP tile = m_ht->getExistedTile(col, row);
+
+                    if (!tile || tile->col() != col || tile->row() != row) {
+                        m_failures.ref();
+                    }
+                }
+            }
+        } while (!m_stop->load());
+    }
+
+    int numFailures() const {
+        return m_failures.load();
+    }
+
+private:
+    KisTileHashTable *m_ht;
+    QAtomicInt *m_stop;
+    QAtomicInt m_failures;
+};
+
+void KisTileHashTableTest::testLookupDuringRehash()
+{
+    quint8 defaultPixel[PIXEL_SIZE];
+    memset(defaultPixel, 0, PIXEL_SIZE);
+
+    KisTileData *defaultTileData =
+        KisTileDataStore::instance()->createDefaultTileData(PIXEL_SIZE, defaultPixel);
+
+    QScopedPointer<KisTileHashTable> ht(new KisTileHashTable(0));
+    ht->setDefaultTileData(defaultTileData);
+
+    bool newTile;
+
+    for (qint32 row = 0; row < NUM_INITIAL_ROWS; row++) {
+        for (qint32 col = 0; col < NUM_INITIAL_COLS; col++) {
+            ht->getTileLazy(col, row, newTile);
+        }
+    }
+
+    const qint32 initialTableSize = ht->tableSize();
+
+    QAtomicInt stop;
+    QVector<TileReaderThread*> readers;
+
+    for (int i = 0; i < NUM_READERS; i++) {
+        TileReaderThread *reader = new TileReaderThread(ht.data(), &stop);
+        reader->start();
+        readers << reader;
+    }
+
+    /**
+     * Add the tiles below the initial ones, so that the table is
+     * grown several times while the readers are looking up the
+     * initial tiles
+     */
+    qint32 row = NUM_INITIAL_ROWS;
+    int numExistingTiles = 0;
+
+    while (ht->tableSize() < (initialTableSize << NUM_REHASHES)) {
+        for (qint32 col = 0; col < NUM_INITIAL_COLS; col++) {
+            ht->getTileLazy(col, row, newTile);
+            if (!newTile) {
+                numExistingTiles++;
+            }
+        }
+        row++;
+    }
+
+    stop.store(1);
+
+    int numFailures = 0;
+
+    Q_FOREACH (TileReaderThread *reader, readers) {
+        reader->wait();
+        numFailures += reader->numFailures();
+    }
+
+    qDeleteAll(readers);
+
+    QCOMPARE(numFailures, 0);
+    QCOMPARE(numExistingTiles, 0);
+
+    QCOMPARE(ht->numTiles(), row * NUM_INITIAL_COLS);
+
+    for (qint32 r = 0; r < row; r++) {
+        for (qint32 col = 0; col < NUM_INITIAL_COLS; col++) {
+            QVERIFY(ht->tileExists(col, r));
+        }
+    }
+}
+
+QTEST_MAIN(KisTileHashTableTest)
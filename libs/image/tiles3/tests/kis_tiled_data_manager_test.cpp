@@ -20,6 +20,9 @@
 #include <QTest>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+#include "kis_image_config.h"
 
 #include "tiles_test_utils.h"
 
@@ -541,6 +544,260 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 
 //#include <valgrind/callgrind.h>
 
+void KisTiledDataManagerTest::testTileUniformity()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    KisTileSP tile = dm.getTile(0, 0, false);
+    tile->lockForRead();
+    QVERIFY(tile->isUniform());
+    tile->unlock();
+
+    tile = dm.getTile(0, 0, true);
+    tile->lockForWrite();
+    tile->data()[100] = 1;
+    QVERIFY(!tile->isUniform());
+    tile->unlock();
+
+    tile->lockForRead();
+    QVERIFY(!tile->isUniform());
+    tile->unlock();
+
+    tile->lockForWrite();
+    tile->data()[100] = 0;
+    tile->unlock();
+
+    tile->lockForRead();
+    QVERIFY(tile->isUniform());
+    tile->unlock();
+
+    // the tile is not reported as uniform while it is being written to
+    tile->lockForWrite();
+    QVERIFY(!tile->isUniform());
+    tile->unlock();
+
+    quint8 oddPixel = 128;
+    dm.clear(QRect(0, 0, 64, 64), &oddPixel);
+
+    tile = dm.getTile(0, 0, false);
+    tile->lockForRead();
+    QVERIFY(tile->isUniform());
+    QCOMPARE(tile->data()[100], oddPixel);
+    tile->unlock();
+}
+
+#define COLUMN2COLOR(col) (col%255)
+
+void KisTiledDataManagerTest::testPrefetch()
+{
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 numCols = 10;
+
+    for(qint32 col = 0; col < numCols; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), COLUMN2COLOR(col), TILESIZE);
+        tile->unlock();
+    }
+
+    KisTileDataStore::instance()->debugSwapAll();
+    QVERIFY(KisTileDataStore::instance()->hasSwappedTiles());
+
+    const qint32 tilesInMemory = KisTileDataStore::instance()->numTilesInMemory();
+    const qint64 prefetchedBefore = KisTileDataPrefetcher::instance()->numPrefetchedTiles();
+
+    dm.prefetch(QRect(0, 0, numCols * KisTileData::WIDTH, KisTileData::HEIGHT));
+
+    for (int i = 0; i < 100; i++) {
+        if (KisTileDataPrefetcher::instance()->numPrefetchedTiles() >= prefetchedBefore + numCols) break;
+        QTest::qWait(10);
+    }
+
+    QCOMPARE(KisTileDataPrefetcher::instance()->numPrefetchedTiles(), prefetchedBefore + numCols);
+    QCOMPARE(KisTileDataStore::instance()->numTilesInMemory(), tilesInMemory + numCols);
+
+    for(qint32 col = 0; col < numCols; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlock();
+    }
+}
+
+void KisTiledDataManagerTest::testHistoryDeltaCompression()
+{
+    KisImageConfig config;
+    config.setHistoryDeltaCompression(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->testingRereadConfig();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    KisMementoSP memento1 = dm.getMemento();
+    dm.clear(0, 0, 64, 64, 128);
+
+    KisMementoSP memento2 = dm.getMemento();
+    dm.clear(10, 10, 4, 4, 129);
+    dm.commit();
+
+    for (int i = 0; i < 100 && store->m_deltaStore.numTiles() < 1; i++) {
+        store->processDeltaCompressionQueue();
+        QTest::qWait(10);
+    }
+
+    QCOMPARE(store->m_deltaStore.numTiles(), quint64(1));
+    QVERIFY(store->memoryStatistics().historicalDeltaSavedSize > 0);
+
+    dm.rollback(memento2);
+
+    KisTileSP tile = dm.getTile(0, 0, false);
+    tile->lockForRead();
+    QVERIFY(memoryIsFilled(128, tile->data(), TILESIZE));
+    tile->unlock();
+    tile = 0;
+
+    QCOMPARE(store->m_deltaStore.numTiles(), quint64(0));
+
+    dm.rollforward(memento2);
+
+    tile = dm.getTile(0, 0, false);
+    tile->lockForRead();
+    QCOMPARE(tile->data()[10 * 64 + 10], quint8(129));
+    QCOMPARE(tile->data()[0], quint8(128));
+    tile->unlock();
+    tile = 0;
+
+    config.setHistoryDeltaCompression(false);
+    store->testingRereadConfig();
+}
+
+void KisTiledDataManagerTest::testDeduplication()
+{
+    KisImageConfig config;
+    config.setTileDeduplication(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->testingRereadConfig();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm1(1, &defaultPixel);
+    KisTiledDataManager dm2(1, &defaultPixel);
+
+    dm1.clear(0, 0, 64, 64, 77);
+    dm2.clear(0, 0, 64, 64, 77);
+
+    QVERIFY(store->deduplicateTileData() >= 1);
+    QVERIFY(store->memoryStatistics().deduplicatedSize > 0);
+
+    KisTileSP tile1 = dm1.getTile(0, 0, false);
+    KisTileSP tile2 = dm2.getTile(0, 0, false);
+
+    tile1->lockForRead();
+    tile2->lockForRead();
+    QVERIFY(memoryIsFilled(77, tile1->data(), TILESIZE));
+    QVERIFY(memoryIsFilled(77, tile2->data(), TILESIZE));
+    tile2->unlock();
+    tile1->unlock();
+
+    tile1->lockForWrite();
+    memset(tile1->data(), 78, TILESIZE);
+    tile1->unlock();
+
+    tile2->lockForRead();
+    QVERIFY(memoryIsFilled(77, tile2->data(), TILESIZE));
+    tile2->unlock();
+
+    tile1 = 0;
+    tile2 = 0;
+
+    config.setTileDeduplication(false);
+    store->testingRereadConfig();
+}
+
+void KisTiledDataManagerTest::testWriteDeduplicatedTiles()
+{
+    KisImageConfig config;
+    config.setTileDeduplication(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->testingRereadConfig();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm1(1, &defaultPixel);
+    KisTiledDataManager dm2(1, &defaultPixel);
+
+    KisMementoSP memento1 = dm1.getMemento();
+    dm1.clear(0, 0, 64, 64, 77);
+    dm1.commit();
+
+    // the tiles are written, but not committed yet,
+    // so their tile data have a single user
+    KisMementoSP memento2 = dm1.getMemento();
+
+    KisTileSP tile1 = dm1.getTile(0, 0, true);
+    tile1->lockForWrite();
+    memset(tile1->data(), 78, TILESIZE);
+    tile1->unlock();
+
+    KisTileSP tile2 = dm2.getTile(0, 0, true);
+    tile2->lockForWrite();
+    memset(tile2->data(), 78, TILESIZE);
+    tile2->unlock();
+
+    QVERIFY(store->deduplicateTileData() >= 1);
+
+    KisTileData *tileData1 = tile1->tileData();
+    KisTileData *tileData2 = tile2->tileData();
+
+    // neither the owner nor the folded copy go through COW
+    tile1->lockForWrite();
+    memset(tile1->data(), 79, TILESIZE);
+    tile1->unlock();
+    QCOMPARE(tile1->tileData(), tileData1);
+
+    tile2->lockForWrite();
+    memset(tile2->data(), 80, TILESIZE);
+    tile2->unlock();
+    QCOMPARE(tile2->tileData(), tileData2);
+
+    tile1->lockForRead();
+    tile2->lockForRead();
+    QVERIFY(memoryIsFilled(79, tile1->data(), TILESIZE));
+    QVERIFY(memoryIsFilled(80, tile2->data(), TILESIZE));
+    tile2->unlock();
+    tile1->unlock();
+
+    tile1 = 0;
+    tile2 = 0;
+
+    // the undo history is not affected by the deduplication
+    dm1.commit();
+    dm1.rollback(memento2);
+
+    tile1 = dm1.getTile(0, 0, false);
+    tile1->lockForRead();
+    QVERIFY(memoryIsFilled(77, tile1->data(), TILESIZE));
+    tile1->unlock();
+    tile1 = 0;
+
+    dm1.rollforward(memento2);
+
+    tile1 = dm1.getTile(0, 0, false);
+    tile1->lockForRead();
+    QVERIFY(memoryIsFilled(79, tile1->data(), TILESIZE));
+    tile1->unlock();
+    tile1 = 0;
+
+    config.setTileDeduplication(false);
+    store->testingRereadConfig();
+}
+
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
 {
     quint8 defaultPixel = 0;
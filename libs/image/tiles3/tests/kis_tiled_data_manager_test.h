@@ -52,6 +52,11 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testTileUniformity();
+    void testPrefetch();
+    void testHistoryDeltaCompression();
+    void testDeduplication();
+    void testWriteDeduplicatedTiles();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
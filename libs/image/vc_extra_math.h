@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __VC_EXTRA_MATH_H
+#define __VC_EXTRA_MATH_H
+
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
+#if defined HAVE_VC
+
+/**
+ * Vectorized math functions missing in Vc. The class is templated by
+ * the implementation, so that the functions compiled for different
+ * architectures do not get merged by the linker.
+ */
+template<Vc::Implementation _impl>
+struct VcExtraMath
+{
+    /**
+     * erf() approximation from Abramowitz and Stegun (7.1.26),
+     * the absolute error is below 1.5e-7, which is far below the
+     * precision of the float itself
+     */
+    static inline Vc::float_v erf(Vc::float_v::AsArg x) {
+        const Vc::float_v vOne(Vc::One);
+
+        const Vc::float_v p(0.3275911f);
+        const Vc::float_v a1(0.254829592f);
+        const Vc::float_v a2(-0.284496736f);
+        const Vc::float_v a3(1.421413741f);
+        const Vc::float_v a4(-1.453152027f);
+        const Vc::float_v a5(1.061405429f);
+
+        Vc::float_v xa = Vc::abs(x);
+        Vc::float_v t = vOne / (vOne + p * xa);
+
+        Vc::float_v poly = ((((a5 * t + a4) * t + a3) * t + a2) * t + a1) * t;
+        Vc::float_v result = vOne - poly * Vc::exp(-xa * xa);
+
+        result(x < Vc::float_v(Vc::Zero)) = -result;
+        return result;
+    }
+
+    /**
+     * Linear interpolation in a lookup table. The caller guarantees
+     * that \p index lies in [0, size - 2] for all the lanes.
+     */
+    static inline Vc::float_v interpolateTable(const float *table, Vc::float_v::AsArg index) {
+        Vc::float_v::IndexType i0 = Vc::simd_cast<Vc::float_v::IndexType>(index);
+        Vc::float_v frac = index - Vc::simd_cast<Vc::float_v>(i0);
+
+        Vc::float_v v0(table, i0);
+        Vc::float_v v1(table, i0 + 1);
+
+        return v0 + (v1 - v0) * frac;
+    }
+};
+
+#endif /* defined HAVE_VC */
+
+#endif /* __VC_EXTRA_MATH_H */
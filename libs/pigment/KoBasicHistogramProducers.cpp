@@ -80,6 +80,35 @@ void KoBasicHistogramProducer::clear()
     }
 }
 
+bool KoBasicHistogramProducer::addBins(const KoHistogramProducer *other)
+{
+    const KoBasicHistogramProducer *basic = dynamic_cast<const KoBasicHistogramProducer*>(other);
+
+    if (!basic ||
+        basic->m_id.id() != m_id.id() ||
+        basic->m_channels != m_channels ||
+        basic->m_nrOfBins != m_nrOfBins ||
+        basic->m_from != m_from ||
+        basic->m_width != m_width) {
+
+        return false;
+    }
+
+    for (int i = 0; i < m_channels; i++) {
+        const vBins &srcBins = basic->m_bins[i];
+        vBins &dstBins = m_bins[i];
+
+        for (int j = 0; j < m_nrOfBins; j++) {
+            dstBins[j] += srcBins[j];
+        }
+        m_outRight[i] += basic->m_outRight[i];
+        m_outLeft[i] += basic->m_outLeft[i];
+    }
+    m_count += basic->m_count;
+
+    return true;
+}
+
 void KoBasicHistogramProducer::makeExternalToInternal()
 {
     // This function assumes that the pixel is has no 'gaps'. That is to say: if we start
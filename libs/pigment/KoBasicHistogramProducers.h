@@ -39,6 +39,8 @@ public:
 
     virtual void clear();
 
+    virtual bool addBins(const KoHistogramProducer *other);
+
     virtual void setView(qreal from, qreal size) {
         m_from = from; m_width = size;
     }
@@ -28,6 +28,7 @@
 #include "KoColorProfile.h"
 #include "KoColorSpace.h"
 #include "KoCopyColorConversionTransformation.h"
+#include "KoLutColorConversionTransformation.h"
 #include "KoMultipleColorConversionTransformation.h"
 
 
@@ -255,6 +256,9 @@ KoColorConversionTransformation* KoColorConversionSystem::createColorConverter(c
                      nodeFor(dstColorSpace));
     Q_ASSERT(path.length() > 0);
     KoColorConversionTransformation* transfo = createTransformationFromPath(path, srcColorSpace, dstColorSpace, renderingIntent, conversionFlags);
+    if (conversionFlags.testFlag(KoColorConversionTransformation::LutApproximation)) {
+        transfo = KoLutColorConversionTransformation::tryCreate(transfo);
+    }
     Q_ASSERT(*transfo->srcColorSpace() == *srcColorSpace);
     Q_ASSERT(*transfo->dstColorSpace() == *dstColorSpace);
     Q_ASSERT(transfo);
@@ -58,7 +58,11 @@ public:
         BlackpointCompensation  = 0x2000,
         NoWhiteOnWhiteFixup     = 0x0004,    // Don't fix scum dot
         HighQuality             = 0x0400,    // Use more memory to give better accurancy
-        LowQuality              = 0x0800    // Use less memory to minimize resouces
+        LowQuality              = 0x0800,    // Use less memory to minimize resouces
+        LutApproximation        = 0x40000000, // Krita only: approximate the conversion with a precomputed table,
+                                              // see KoLutColorConversionTransformation. Never passed to lcms.
+        Dither                  = 0x20000000  // Krita only: use ordered dithering when reducing the bit depth,
+                                              // see KoColorSpace::convertPixelRowTo(). Never passed to lcms.
     };
     Q_DECLARE_FLAGS(ConversionFlags, ConversionFlag)
 
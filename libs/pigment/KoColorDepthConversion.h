@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KO_COLOR_DEPTH_CONVERSION_H
+#define __KO_COLOR_DEPTH_CONVERSION_H
+
+#include <QtGlobal>
+
+#include "KoColorSpaceMaths.h"
+
+/**
+ * Kernels for converting pixels between two color spaces that differ
+ * only in the channel type, e.g. RGBA 16-bit and RGBA 8-bit with the
+ * same profile.
+ *
+ * The loops have compile-time strides and no dependencies between the
+ * iterations, so the compiler unrolls and vectorizes them.
+ */
+namespace KoColorDepthConversion
+{
+
+/**
+ * Returns the threshold of the 8x8 ordered (Bayer) dither matrix at
+ * position (\p x, \p y), normalized into (0, 1). The matrix element is
+ * the bit-reversed interleaving of (x ^ y) and y.
+ */
+inline float orderedDitherThreshold(int x, int y)
+{
+    const int a = y & 7;
+    const int b = (x ^ y) & 7;
+
+    const int value =
+        ((b & 1) << 5) | ((a & 1) << 4) |
+        ((b & 2) << 2) | ((a & 2) << 1) |
+        ((b & 4) >> 1) | ((a & 4) >> 2);
+
+    return (value + 0.5f) / 64.0f;
+}
+
+/**
+ * Scales \p nChannels channels from \p src to \p dst. The pixels
+ * are contiguous, so the channels are processed as a flat array.
+ */
+template<typename src_channel_type, typename dst_channel_type>
+inline void scaleChannels(const src_channel_type *src, dst_channel_type *dst, qint32 nChannels)
+{
+    for (qint32 i = 0; i < nChannels; i++) {
+        dst[i] = KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(src[i]);
+    }
+}
+
+/**
+ * Reduces the bit depth of \p nPixels pixels of a row with ordered
+ * dithering. (\p x, \p y) is the image position of the first pixel,
+ * so that the pattern stays continuous over the rows and the tiles.
+ *
+ * Values that are representable in \p dst_channel_type are converted
+ * exactly, the alpha channel is never dithered.
+ */
+template<typename src_channel_type, typename dst_channel_type, int channels_nb, int alpha_pos>
+inline void ditherChannels(const src_channel_type *src, dst_channel_type *dst, qint32 nPixels, int x, int y)
+{
+    const float srcToDst =
+        float(KoColorSpaceMathsTraits<dst_channel_type>::unitValue) /
+        float(KoColorSpaceMathsTraits<src_channel_type>::unitValue);
+    const float dstUnit = KoColorSpaceMathsTraits<dst_channel_type>::unitValue;
+
+    float thresholds[8];
+    for (int i = 0; i < 8; i++) {
+        thresholds[i] = orderedDitherThreshold(x + i, y);
+    }
+
+    for (qint32 i = 0; i < nPixels; i++) {
+        const float threshold = thresholds[i & 7];
+
+        for (int c = 0; c < channels_nb; c++) {
+            const src_channel_type value = src[i * channels_nb + c];
+
+            if (c == alpha_pos) {
+                dst[i * channels_nb + c] = KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(value);
+            } else {
+                const float result = float(value) * srcToDst + threshold;
+                dst[i * channels_nb + c] = dst_channel_type(qBound(0.0f, result, dstUnit));
+            }
+        }
+    }
+}
+
+}
+
+#endif /* __KO_COLOR_DEPTH_CONVERSION_H */
@@ -30,6 +30,7 @@
 #include "KoColorConversionSystem.h"
 #include "KoColorSpaceRegistry.h"
 #include "KoColorProfile.h"
+#include "KoColorModelStandardIds.h"
 #include "KoCopyColorConversionTransformation.h"
 #include "KoFallBackColorTransformation.h"
 #include "KoUniqueNumberForIdServer.h"
@@ -328,6 +329,16 @@ QList<KoCompositeOp*> KoColorSpace::compositeOps() const
     return d->compositeOps.values();
 }
 
+void KoColorSpace::differences(const quint8 *src, const quint8 *pixels, quint8 *diffs, qint32 nPixels) const
+{
+    const qint32 pixelSize = this->pixelSize();
+
+    for (qint32 i = 0; i < nPixels; i++) {
+        diffs[i] = difference(src, pixels);
+        pixels += pixelSize;
+    }
+}
+
 KoMixColorsOp* KoColorSpace::mixColorsOp() const
 {
     return d->mixColorsOp;
@@ -435,6 +446,44 @@ bool KoColorSpace::convertPixelsTo(const quint8 * src,
     return true;
 }
 
+bool KoColorSpace::convertPixelRowTo(const quint8 * src,
+                                     quint8 * dst,
+                                     const KoColorSpace * dstColorSpace,
+                                     quint32 numPixels, int x, int y,
+                                     KoColorConversionTransformation::Intent renderingIntent,
+                                     KoColorConversionTransformation::ConversionFlags conversionFlags) const
+{
+    const KoColorConversionTransformation::ConversionFlags plainFlags =
+        conversionFlags & ~KoColorConversionTransformation::Dither;
+
+    if (!(conversionFlags & KoColorConversionTransformation::Dither) ||
+        dstColorSpace->colorDepthId() != Integer8BitsColorDepthID ||
+        colorDepthId() == Integer8BitsColorDepthID) {
+
+        return convertPixelsTo(src, dst, dstColorSpace, numPixels, renderingIntent, plainFlags);
+    }
+
+    /**
+     * Go through the 16-bit version of the destination color space, the
+     * colorspaces know how to dither their own channels down to 8 bits
+     */
+    const KoColorSpace *intermediateColorSpace =
+        KoColorSpaceRegistry::instance()->colorSpace(dstColorSpace->colorModelId().id(),
+                                                     Integer16BitsColorDepthID.id(),
+                                                     dstColorSpace->profile());
+
+    if (!intermediateColorSpace || *intermediateColorSpace == *this) {
+        return convertPixelsTo(src, dst, dstColorSpace, numPixels, renderingIntent, plainFlags);
+    }
+
+    QVector<quint8> buffer(numPixels * intermediateColorSpace->pixelSize());
+    convertPixelsTo(src, buffer.data(), intermediateColorSpace, numPixels, renderingIntent, plainFlags);
+
+    return intermediateColorSpace->convertPixelRowTo(buffer.constData(), dst, dstColorSpace,
+                                                     numPixels, x, y,
+                                                     renderingIntent, conversionFlags);
+}
+
 
 void KoColorSpace::bitBlt(const KoColorSpace* srcSpace, const KoCompositeOp::ParameterInfo& params, const KoCompositeOp* op,
                           KoColorConversionTransformation::Intent renderingIntent,
@@ -784,8 +833,15 @@ QImage KoColorSpace::convertToQImage(const quint8 *data, qint32 width, qint32 he
 
     const KoColorSpace * dstCS = KoColorSpaceRegistry::instance()->rgb8(dstProfile);
 
-    if (data)
+    if (data && (conversionFlags & KoColorConversionTransformation::Dither)) {
+        // the dither pattern depends on the position, so convert row by row
+        for (qint32 y = 0; y < height; y++) {
+            this->convertPixelRowTo(data + y * width * pixelSize(), img.scanLine(y), dstCS,
+                                    width, 0, y, renderingIntent, conversionFlags);
+        }
+    } else if (data) {
         this->convertPixelsTo(const_cast<quint8 *>(data), img.bits(), dstCS, width * height, renderingIntent, conversionFlags);
+    }
 
     return img;
 }
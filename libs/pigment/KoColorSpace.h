@@ -371,6 +371,22 @@ public:
                                  KoColorConversionTransformation::Intent renderingIntent,
                                  KoColorConversionTransformation::ConversionFlags conversionFlags) const;
 
+    /**
+     * Convert a run of \p numPixels pixels of a row, starting at the image
+     * position (\p x, \p y), to the specified color space.
+     *
+     * Same as convertPixelsTo(), but when \p conversionFlags contain
+     * KoColorConversionTransformation::Dither and the bit depth is reduced
+     * to 8 bits, the result is dithered with an ordered pattern anchored
+     * at the image origin, so that the pattern is continuous over the
+     * rows and the tiles.
+     */
+    virtual bool convertPixelRowTo(const quint8 * src,
+                                   quint8 * dst, const KoColorSpace * dstColorSpace,
+                                   quint32 numPixels, int x, int y,
+                                   KoColorConversionTransformation::Intent renderingIntent,
+                                   KoColorConversionTransformation::ConversionFlags conversionFlags) const;
+
 //============================== Manipulation functions ==========================//
 
 
@@ -385,6 +401,13 @@ public:
     virtual quint8 opacityU8(const quint8 * pixel) const = 0;
     virtual qreal opacityF(const quint8 * pixel) const = 0;
 
+    /**
+     * Copies the alpha values of \p nPixels pixels, downscaled to 8-bit,
+     * into \p alpha. It is the same as calling opacityU8() for every
+     * pixel of the run, but without a virtual call per pixel.
+     */
+    virtual void copyOpacityU8(const quint8 * pixels, quint8 * alpha, qint32 nPixels) const = 0;
+
     /**
      * Set the alpha channel of the given run of pixels to the given value.
      *
@@ -478,6 +501,17 @@ public:
      */
     virtual quint8 differenceA(const quint8* src1, const quint8* src2) const = 0;
 
+    /**
+     * Calculates difference() between the color \p src and each of
+     * \p nPixels pixels stored in \p pixels and writes the results
+     * into \p diffs.
+     *
+     * The default implementation calls difference() for every pixel.
+     * Colorspaces with expensive difference() (e.g. the ones converting
+     * into Lab) should reimplement it in a batched way.
+     */
+    virtual void differences(const quint8 *src, const quint8 *pixels, quint8 *diffs, qint32 nPixels) const;
+
     /**
      * @return the mix color operation of this colorspace (do not delete it locally, it's deleted by the colorspace).
      */
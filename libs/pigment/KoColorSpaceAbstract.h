@@ -33,7 +33,66 @@
 #include "KoMixColorsOpImpl.h"
 
 #include "KoConvolutionOpImpl.h"
+#include "KoColorDepthConversion.h"
 #include "KoInvertColorTransformation.h"
+#include "KoOptimizedMixColorsOpFactory.h"
+
+namespace _Private {
+
+template<typename channels_type>
+struct OptimizedMixOpsCreator
+{
+    static KoMixColorsOp* createMixColorsOp() { return 0; }
+    static KoConvolutionOp* createConvolutionOp() { return 0; }
+};
+
+template<>
+struct OptimizedMixOpsCreator<quint8>
+{
+    static KoMixColorsOp* createMixColorsOp() { return KoOptimizedMixColorsOpFactory::createMixColorsOp32(); }
+    static KoConvolutionOp* createConvolutionOp() { return KoOptimizedMixColorsOpFactory::createConvolutionOp32(); }
+};
+
+template<>
+struct OptimizedMixOpsCreator<quint16>
+{
+    static KoMixColorsOp* createMixColorsOp() { return KoOptimizedMixColorsOpFactory::createMixColorsOp64(); }
+    static KoConvolutionOp* createConvolutionOp() { return KoOptimizedMixColorsOpFactory::createConvolutionOp64(); }
+};
+
+template<>
+struct OptimizedMixOpsCreator<float>
+{
+    static KoMixColorsOp* createMixColorsOp() { return KoOptimizedMixColorsOpFactory::createMixColorsOp128(); }
+    static KoConvolutionOp* createConvolutionOp() { return KoOptimizedMixColorsOpFactory::createConvolutionOp128(); }
+};
+
+/**
+ * The colorspaces with four channels and alpha in the last one get the
+ * vectorized mixing ops (if they are available on this CPU), the rest
+ * use the generic ones.
+ */
+template<class _CSTrait>
+struct MixOpsSelector
+{
+    static const bool hasOptimizedLayout = _CSTrait::channels_nb == 4 && _CSTrait::alpha_pos == 3;
+
+    static KoMixColorsOp* createMixColorsOp() {
+        KoMixColorsOp *op = hasOptimizedLayout ?
+            OptimizedMixOpsCreator<typename _CSTrait::channels_type>::createMixColorsOp() : 0;
+
+        return op ? op : new KoMixColorsOpImpl<_CSTrait>();
+    }
+
+    static KoConvolutionOp* createConvolutionOp() {
+        KoConvolutionOp *op = hasOptimizedLayout ?
+            OptimizedMixOpsCreator<typename _CSTrait::channels_type>::createConvolutionOp() : 0;
+
+        return op ? op : new KoConvolutionOpImpl<_CSTrait>();
+    }
+};
+
+}
 
 
 /**
@@ -51,7 +110,9 @@ class KoColorSpaceAbstract : public KoColorSpace
 {
 public:
     KoColorSpaceAbstract(const QString &id, const QString &name) :
-        KoColorSpace(id, name, new KoMixColorsOpImpl< _CSTrait>(), new KoConvolutionOpImpl< _CSTrait>()) {
+        KoColorSpace(id, name,
+                     _Private::MixOpsSelector<_CSTrait>::createMixColorsOp(),
+                     _Private::MixOpsSelector<_CSTrait>::createConvolutionOp()) {
     }
 
     virtual quint32 colorChannelCount() const {
@@ -102,6 +163,10 @@ public:
         return _CSTrait::opacityF(U8_pixel);
     }
 
+    virtual void copyOpacityU8(const quint8 * pixels, quint8 * alpha, qint32 nPixels) const {
+        _CSTrait::copyOpacityU8(pixels, alpha, nPixels);
+    }
+
     virtual void setOpacity(quint8 * pixels, quint8 alpha, qint32 nPixels) const {
         _CSTrait::setOpacity(pixels, alpha, nPixels);
     }
@@ -150,59 +215,75 @@ public:
                                  KoColorConversionTransformation::Intent renderingIntent,
                                  KoColorConversionTransformation::ConversionFlags conversionFlags) const
     {
-        
         // check whether we have the same profile and color model, but only a different bit
         // depth; in that case we don't convert as such, but scale
-        bool scaleOnly = false;
-
-        // Note: getting the id() is really, really expensive, so only do that if
-        // we are sure there is a difference between the colorspaces
-        if (!(*this == *dstColorSpace)) {
-            scaleOnly = dstColorSpace->colorModelId().id() == colorModelId().id() &&
-                         dstColorSpace->colorDepthId().id() != colorDepthId().id() &&
-                         dstColorSpace->profile()->name()   == profile()->name();
-        }
-        
-        if (scaleOnly && dynamic_cast<const KoColorSpaceAbstract*>(dstColorSpace)) {
-            typedef typename _CSTrait::channels_type channels_type;
-            
+        if (canScaleTo(dstColorSpace)) {
             switch(dstColorSpace->channels()[0]->channelValueType())
             {
             case KoChannelInfo::UINT8:
-                scalePixels<_CSTrait::pixelSize, 1, channels_type, quint8>(src, dst, numPixels);
+                scalePixels<quint8>(src, dst, numPixels);
                 return true;
-//             case KoChannelInfo::INT8:
-//                 scalePixels<_CSTrait::pixelSize, 1, channels_type, qint8>(src, dst, numPixels);
-//                 return true;
             case KoChannelInfo::UINT16:
-                scalePixels<_CSTrait::pixelSize, 2, channels_type, quint16>(src, dst, numPixels);
-                return true;
-            case KoChannelInfo::INT16:
-                scalePixels<_CSTrait::pixelSize, 2, channels_type, qint16>(src, dst, numPixels);
-                return true;
-            case KoChannelInfo::UINT32:
-                scalePixels<_CSTrait::pixelSize, 4, channels_type, quint32>(src, dst, numPixels);
+                scalePixels<quint16>(src, dst, numPixels);
                 return true;
             default:
                 break;
             }
         }
-        
+
         return KoColorSpace::convertPixelsTo(src, dst, dstColorSpace, numPixels, renderingIntent, conversionFlags);
     }
-    
+
+    virtual bool convertPixelRowTo(const quint8 *src,
+                                   quint8 *dst, const KoColorSpace *dstColorSpace,
+                                   quint32 numPixels, int x, int y,
+                                   KoColorConversionTransformation::Intent renderingIntent,
+                                   KoColorConversionTransformation::ConversionFlags conversionFlags) const
+    {
+        typedef typename _CSTrait::channels_type channels_type;
+
+        if ((conversionFlags & KoColorConversionTransformation::Dither) &&
+            KoColorSpaceMathsTraits<channels_type>::bits == 16 &&
+            canScaleTo(dstColorSpace) &&
+            dstColorSpace->channels()[0]->channelValueType() == KoChannelInfo::UINT8) {
+
+            KoColorDepthConversion::ditherChannels<channels_type, quint8, _CSTrait::channels_nb, _CSTrait::alpha_pos>(
+                _CSTrait::nativeArray(src), dst, numPixels, x, y);
+            return true;
+        }
+
+        return KoColorSpace::convertPixelRowTo(src, dst, dstColorSpace, numPixels, x, y, renderingIntent, conversionFlags);
+    }
+
 private:
-    template<int srcPixelSize, int dstChannelSize, class TSrcChannel, class TDstChannel>
+    static bool isIntegerChannel(const KoColorSpace *cs) {
+        const KoChannelInfo::enumChannelValueType type = cs->channels()[0]->channelValueType();
+        return type == KoChannelInfo::UINT8 || type == KoChannelInfo::UINT16;
+    }
+
+    /**
+     * The integer colorspaces of the same model share the channel
+     * order, so the conversion between them is a plain scaling of the
+     * channels. The floating point ones may have a different order
+     * (RGBA vs. BGRA), they are handled by the conversion system.
+     */
+    bool canScaleTo(const KoColorSpace *dstColorSpace) const {
+        // Note: getting the id() is really, really expensive, so only do that if
+        // we are sure there is a difference between the colorspaces
+        if (*this == *dstColorSpace) return false;
+
+        return dstColorSpace->channelCount() == _CSTrait::channels_nb &&
+            isIntegerChannel(this) && isIntegerChannel(dstColorSpace) &&
+            dstColorSpace->colorModelId().id() == colorModelId().id() &&
+            dstColorSpace->colorDepthId().id() != colorDepthId().id() &&
+            dstColorSpace->profile()->name()   == profile()->name();
+    }
+
+    template<class TDstChannel>
     void scalePixels(const quint8* src, quint8* dst, quint32 numPixels) const {
-        qint32 dstPixelSize = dstChannelSize * _CSTrait::channels_nb;
-        
-        for(quint32 i=0; i<numPixels; ++i) {
-            const TSrcChannel* srcPixel = reinterpret_cast<const TSrcChannel*>(src + i * srcPixelSize);
-            TDstChannel*       dstPixel = reinterpret_cast<TDstChannel*>(dst + i * dstPixelSize);
-            
-            for(quint32 c=0; c<_CSTrait::channels_nb; ++c)
-                dstPixel[c] = Arithmetic::scale<TDstChannel>(srcPixel[c]);
-        }
+        KoColorDepthConversion::scaleChannels(_CSTrait::nativeArray(src),
+                                              reinterpret_cast<TDstChannel*>(dst),
+                                              numPixels * _CSTrait::channels_nb);
     }
 };
 
@@ -21,6 +21,7 @@
 #define _KO_COLORSPACE_TRAITS_H_
 
 #include <QVector>
+#include <cstring>
 
 #include "KoColorSpaceConstants.h"
 #include "KoColorSpaceMaths.h"
@@ -77,25 +78,40 @@ struct KoColorSpaceTrait {
         channels_type c = nativeArray(U8_pixel)[alpha_pos];
         return  KoColorSpaceMaths<channels_type, qreal>::scaleToA(c);
     }
+
+    /**
+     * Copy the alpha channel of \p nPixels pixels into \p alpha in the 0..255 range
+     */
+    inline static void copyOpacityU8(const quint8 * pixels, quint8 * alpha, qint32 nPixels) {
+        if (alpha_pos < 0) {
+            memset(alpha, OPACITY_OPAQUE_U8, nPixels);
+            return;
+        }
+
+        const channels_type *alphaChannel = nativeArray(pixels) + alpha_pos;
+        for (qint32 i = 0; i < nPixels; i++) {
+            alpha[i] = KoColorSpaceMaths<channels_type, quint8>::scaleToA(alphaChannel[i * channels_nb]);
+        }
+    }
     
     /**
      * Set the alpha channel for this pixel from a value in the 0..255 range
      */
     inline static void setOpacity(quint8 * pixels, quint8 alpha, qint32 nPixels) {
         if (alpha_pos < 0) return;
-        qint32 psize = pixelSize;
         channels_type valpha =  KoColorSpaceMaths<quint8, channels_type>::scaleToA(alpha);
-        for (; nPixels > 0; --nPixels, pixels += psize) {
-            nativeArray(pixels)[alpha_pos] = valpha;
+        channels_type *alphaChannel = nativeArray(pixels) + alpha_pos;
+        for (qint32 i = 0; i < nPixels; i++) {
+            alphaChannel[i * channels_nb] = valpha;
         }
     }
     
     inline static void setOpacity(quint8 * pixels, qreal alpha, qint32 nPixels) {
         if (alpha_pos < 0) return;
-        qint32 psize = pixelSize;
         channels_type valpha =  KoColorSpaceMaths<qreal, channels_type>::scaleToA(alpha);
-        for (; nPixels > 0; --nPixels, pixels += psize) {
-            nativeArray(pixels)[alpha_pos] = valpha;
+        channels_type *alphaChannel = nativeArray(pixels) + alpha_pos;
+        for (qint32 i = 0; i < nPixels; i++) {
+            alphaChannel[i * channels_nb] = valpha;
         }
     }
     
@@ -162,34 +178,44 @@ struct KoColorSpaceTrait {
             nativeArray(pixel)[i] = c;
         }
     }
+    /**
+     * The span functions below address the alpha channel with a
+     * compile-time stride and have no dependencies between the
+     * iterations, so the compiler can unroll and vectorize them.
+     */
     inline static void multiplyAlpha(quint8 * pixels, quint8 alpha, qint32 nPixels) {
         if (alpha_pos < 0) return;
 
         channels_type valpha =  KoColorSpaceMaths<quint8, channels_type>::scaleToA(alpha);
+        channels_type *alphaChannel = nativeArray(pixels) + alpha_pos;
 
-        for (; nPixels > 0; --nPixels, pixels += pixelSize) {
-            channels_type* alphapixel = nativeArray(pixels) + alpha_pos;
-            *alphapixel = KoColorSpaceMaths<channels_type>::multiply(*alphapixel, valpha);
+        for (qint32 i = 0; i < nPixels; i++) {
+            channels_type &a = alphaChannel[i * channels_nb];
+            a = KoColorSpaceMaths<channels_type>::multiply(a, valpha);
         }
     }
 
     inline static void applyAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) {
         if (alpha_pos < 0) return;
 
-        for (; nPixels > 0; --nPixels, pixels += pixelSize, ++alpha) {
-            channels_type valpha =  KoColorSpaceMaths<quint8, channels_type>::scaleToA(*alpha);
-            channels_type* alphapixel = nativeArray(pixels) + alpha_pos;
-            *alphapixel = KoColorSpaceMaths<channels_type>::multiply(*alphapixel, valpha);
+        channels_type *alphaChannel = nativeArray(pixels) + alpha_pos;
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            const channels_type valpha =  KoColorSpaceMaths<quint8, channels_type>::scaleToA(alpha[i]);
+            channels_type &a = alphaChannel[i * channels_nb];
+            a = KoColorSpaceMaths<channels_type>::multiply(a, valpha);
         }
     }
 
     inline static void applyInverseAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) {
         if (alpha_pos < 0) return;
 
-        for (; nPixels > 0; --nPixels, pixels += pixelSize, ++alpha) {
-            channels_type valpha =  KoColorSpaceMaths<quint8, channels_type>::scaleToA(OPACITY_OPAQUE_U8 - *alpha);
-            channels_type* alphapixel = nativeArray(pixels) + alpha_pos;
-            *alphapixel = KoColorSpaceMaths<channels_type>::multiply(*alphapixel, valpha);
+        channels_type *alphaChannel = nativeArray(pixels) + alpha_pos;
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            const channels_type valpha =  KoColorSpaceMaths<quint8, channels_type>::scaleToA(OPACITY_OPAQUE_U8 - alpha[i]);
+            channels_type &a = alphaChannel[i * channels_nb];
+            a = KoColorSpaceMaths<channels_type>::multiply(a, valpha);
         }
     }
 
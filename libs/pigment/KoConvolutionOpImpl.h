@@ -98,6 +98,18 @@ public:
             }
         }
 
+        writeConvolvedPixel(totals, totalWeight, totalWeightTransparent, dst, factor, offset, channelFlags);
+    }
+
+protected:
+
+    /**
+     * Writes the result of the convolution from the weighted sums of the
+     * channels. Shared with the optimized versions of the op.
+     */
+    static void writeConvolvedPixel(const qreal *totals, qreal totalWeight, qreal totalWeightTransparent,
+                                    quint8 *dst, qreal factor, qreal offset, const QBitArray & channelFlags) {
+
         typename _CSTrait::channels_type* dstColor = _CSTrait::nativeArray(dst);
 
         bool allChannels = channelFlags.isEmpty();
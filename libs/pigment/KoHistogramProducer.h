@@ -70,6 +70,18 @@ public:
      */
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace* colorSpace) = 0;
 
+    /**
+     * Adds the bins of \p other to the bins of this producer. It is used for
+     * merging the histograms calculated for separate parts of the image.
+     * \p other should be of the same type and have the same view.
+     *
+     * @return false if the producers cannot be merged
+     */
+    virtual bool addBins(const KoHistogramProducer *other) {
+        Q_UNUSED(other);
+        return false;
+    }
+
     // Methods to set what exactly is being added to the bins
     virtual void setView(qreal from, qreal width) = 0;
     virtual void setSkipTransparent(bool set) {
@@ -0,0 +1,482 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "KoLutColorConversionTransformation.h"
+
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoChannelInfo.h>
+
+namespace {
+
+const int MAX_INPUTS = 4;
+const int MAX_OUTPUTS = 4;
+
+/**
+ * The number of pseudo-random colors used for measuring
+ * the precision of the table
+ */
+const int NUM_ERROR_SAMPLES = 4096;
+
+template <typename channel_type>
+struct LutChannelTraits;
+
+template <>
+struct LutChannelTraits<quint8> {
+    static inline float unitValue() { return 255.0f; }
+    static inline quint8 fromFloat(float value) {
+        return quint8(qBound(0.0f, value + 0.5f, 255.0f));
+    }
+};
+
+template <>
+struct LutChannelTraits<quint16> {
+    static inline float unitValue() { return 65535.0f; }
+    static inline quint16 fromFloat(float value) {
+        return quint16(qBound(0.0f, value + 0.5f, 65535.0f));
+    }
+};
+
+template <>
+struct LutChannelTraits<float> {
+    static inline float unitValue() { return 1.0f; }
+    static inline float fromFloat(float value) {
+        return value;
+    }
+};
+
+float unitValue(KoChannelInfo::enumChannelValueType type)
+{
+    return type == KoChannelInfo::UINT8 ? LutChannelTraits<quint8>::unitValue() :
+           type == KoChannelInfo::UINT16 ? LutChannelTraits<quint16>::unitValue() :
+           LutChannelTraits<float>::unitValue();
+}
+
+bool isSupportedChannelType(KoChannelInfo::enumChannelValueType type, bool allowFloat)
+{
+    return type == KoChannelInfo::UINT8 ||
+        type == KoChannelInfo::UINT16 ||
+        (allowFloat && type == KoChannelInfo::FLOAT32);
+}
+
+/**
+ * Checks that all the channels of \p cs have the same supported
+ * type, one of them is alpha and the number of the color channels
+ * is in [minColorChannels, maxColorChannels]
+ */
+bool hasSupportedLayout(const KoColorSpace *cs, bool allowFloat, int minColorChannels, int maxColorChannels)
+{
+    const QList<KoChannelInfo*> channels = cs->channels();
+    if (channels.isEmpty()) return false;
+
+    const KoChannelInfo::enumChannelValueType type = channels.first()->channelValueType();
+    if (!isSupportedChannelType(type, allowFloat)) return false;
+
+    int numColorChannels = 0;
+    int numAlphaChannels = 0;
+
+    Q_FOREACH (const KoChannelInfo *channel, channels) {
+        if (channel->channelValueType() != type) return false;
+
+        if (channel->channelType() == KoChannelInfo::COLOR) {
+            numColorChannels++;
+        } else {
+            numAlphaChannels++;
+        }
+    }
+
+    return numAlphaChannels == 1 &&
+        numColorChannels >= minColorChannels &&
+        numColorChannels <= maxColorChannels;
+}
+
+/**
+ * Tetrahedral interpolation inside a cube of the grid. The cube is
+ * split into six tetrahedra along its main diagonal; the one containing
+ * the point is chosen by the order of the fractional coordinates.
+ */
+inline void evaluateTetrahedral(const float *table, int gridSize, int numOutputs,
+                                float x, float y, float z, float *result)
+{
+    const int ix = qMin(int(x), gridSize - 2);
+    const int iy = qMin(int(y), gridSize - 2);
+    const int iz = qMin(int(z), gridSize - 2);
+
+    const float rx = x - ix;
+    const float ry = y - iy;
+    const float rz = z - iz;
+
+    const int strideZ = numOutputs;
+    const int strideY = gridSize * strideZ;
+    const int strideX = gridSize * strideY;
+
+    const float *c000 = table + ix * strideX + iy * strideY + iz * strideZ;
+    const float *c111 = c000 + strideX + strideY + strideZ;
+    const float *c1;
+    const float *c2;
+    float w1, w2, w3;
+
+    if (rx >= ry) {
+        if (ry >= rz) {
+            c1 = c000 + strideX; c2 = c1 + strideY; w1 = rx; w2 = ry; w3 = rz;
+        } else if (rx >= rz) {
+            c1 = c000 + strideX; c2 = c1 + strideZ; w1 = rx; w2 = rz; w3 = ry;
+        } else {
+            c1 = c000 + strideZ; c2 = c1 + strideX; w1 = rz; w2 = rx; w3 = ry;
+        }
+    } else {
+        if (rx >= rz) {
+            c1 = c000 + strideY; c2 = c1 + strideX; w1 = ry; w2 = rx; w3 = rz;
+        } else if (ry >= rz) {
+            c1 = c000 + strideY; c2 = c1 + strideZ; w1 = ry; w2 = rz; w3 = rx;
+        } else {
+            c1 = c000 + strideZ; c2 = c1 + strideY; w1 = rz; w2 = ry; w3 = rx;
+        }
+    }
+
+    for (int i = 0; i < numOutputs; i++) {
+        result[i] = c000[i] +
+            w1 * (c1[i] - c000[i]) +
+            w2 * (c2[i] - c1[i]) +
+            w3 * (c111[i] - c2[i]);
+    }
+}
+
+}
+
+struct Q_DECL_HIDDEN KoLutColorConversionTransformation::Private
+{
+    typedef void (*TransformFunc)(const Private *d, const quint8 *src, quint8 *dst, qint32 nPixels);
+
+    int gridSize;
+    int numInputs;
+    int numOutputs;
+    qreal maxError;
+
+    // all the offsets are measured in channels, not in bytes
+    int srcColorOffsets[MAX_INPUTS];
+    int srcAlphaOffset;
+    int srcPixelStride;
+    KoChannelInfo::enumChannelValueType srcType;
+
+    int dstColorOffsets[MAX_OUTPUTS];
+    int dstAlphaOffset;
+    int dstPixelStride;
+    KoChannelInfo::enumChannelValueType dstType;
+
+    /**
+     * The values of the destination color channels for every node of
+     * the grid. The last input channel changes the slowest.
+     */
+    QVector<float> table;
+
+    TransformFunc transformFunc;
+
+    void initLayout(const KoColorSpace *cs,
+                    int *colorOffsets, int *alphaOffset, int *pixelStride,
+                    KoChannelInfo::enumChannelValueType *type, int *numColorChannels);
+
+    void setSrcValue(quint8 *pixel, int offset, float normalizedValue) const;
+    float dstValue(const quint8 *pixel, int offset) const;
+
+    void bakeTable(const KoColorConversionTransformation *exactTransform);
+    void measureError(const KoColorConversionTransformation *exactTransform);
+
+    template <typename src_channel_type>
+    static TransformFunc selectTransformFunc(KoChannelInfo::enumChannelValueType dstType);
+
+    template <typename src_channel_type, typename dst_channel_type>
+    static void transformImpl(const Private *d, const quint8 *src, quint8 *dst, qint32 nPixels);
+};
+
+void KoLutColorConversionTransformation::Private::initLayout(const KoColorSpace *cs,
+                                                             int *colorOffsets, int *alphaOffset, int *pixelStride,
+                                                             KoChannelInfo::enumChannelValueType *type, int *numColorChannels)
+{
+    const QList<KoChannelInfo*> channels = cs->channels();
+    const int channelSize = channels.first()->size();
+
+    *numColorChannels = 0;
+
+    Q_FOREACH (const KoChannelInfo *channel, channels) {
+        const int offset = channel->pos() / channelSize;
+
+        if (channel->channelType() == KoChannelInfo::COLOR) {
+            colorOffsets[(*numColorChannels)++] = offset;
+        } else {
+            *alphaOffset = offset;
+        }
+    }
+
+    *pixelStride = cs->pixelSize() / channelSize;
+    *type = channels.first()->channelValueType();
+}
+
+void KoLutColorConversionTransformation::Private::setSrcValue(quint8 *pixel, int offset, float normalizedValue) const
+{
+    if (srcType == KoChannelInfo::UINT8) {
+        pixel[offset] =
+            LutChannelTraits<quint8>::fromFloat(normalizedValue * LutChannelTraits<quint8>::unitValue());
+    } else {
+        reinterpret_cast<quint16*>(pixel)[offset] =
+            LutChannelTraits<quint16>::fromFloat(normalizedValue * LutChannelTraits<quint16>::unitValue());
+    }
+}
+
+float KoLutColorConversionTransformation::Private::dstValue(const quint8 *pixel, int offset) const
+{
+    return dstType == KoChannelInfo::UINT8 ? reinterpret_cast<const quint8*>(pixel)[offset] :
+           dstType == KoChannelInfo::UINT16 ? reinterpret_cast<const quint16*>(pixel)[offset] :
+           reinterpret_cast<const float*>(pixel)[offset];
+}
+
+void KoLutColorConversionTransformation::Private::bakeTable(const KoColorConversionTransformation *exactTransform)
+{
+    const int srcPixelSize = exactTransform->srcColorSpace()->pixelSize();
+    const int dstPixelSize = exactTransform->dstColorSpace()->pixelSize();
+
+    int numNodes = 1;
+    for (int i = 0; i < numInputs; i++) {
+        numNodes *= gridSize;
+    }
+
+    QVector<quint8> srcPixels(numNodes * srcPixelSize);
+    QVector<quint8> dstPixels(numNodes * dstPixelSize);
+
+    quint8 *srcPtr = srcPixels.data();
+    for (int node = 0; node < numNodes; node++) {
+        // the index of the node is ((k * G + x) * G + y) * G + z,
+        // where 'x' is the first color channel and 'k' the fourth one
+        int rest = node;
+        const int z = rest % gridSize; rest /= gridSize;
+        const int y = rest % gridSize; rest /= gridSize;
+        const int x = rest % gridSize; rest /= gridSize;
+        const int k = rest;
+
+        const int coords[MAX_INPUTS] = {x, y, z, k};
+
+        for (int i = 0; i < numInputs; i++) {
+            setSrcValue(srcPtr, srcColorOffsets[i], float(coords[i]) / (gridSize - 1));
+        }
+        setSrcValue(srcPtr, srcAlphaOffset, 1.0f);
+
+        srcPtr += srcPixelSize;
+    }
+
+    exactTransform->transform(srcPixels.constData(), dstPixels.data(), numNodes);
+
+    table.resize(numNodes * numOutputs);
+
+    const quint8 *dstPtr = dstPixels.constData();
+    float *tablePtr = table.data();
+
+    for (int node = 0; node < numNodes; node++) {
+        for (int i = 0; i < numOutputs; i++) {
+            *tablePtr++ = dstValue(dstPtr, dstColorOffsets[i]);
+        }
+        dstPtr += dstPixelSize;
+    }
+}
+
+void KoLutColorConversionTransformation::Private::measureError(const KoColorConversionTransformation *exactTransform)
+{
+    const int srcPixelSize = exactTransform->srcColorSpace()->pixelSize();
+    const int dstPixelSize = exactTransform->dstColorSpace()->pixelSize();
+
+    QVector<quint8> srcPixels(NUM_ERROR_SAMPLES * srcPixelSize);
+    QVector<quint8> exactPixels(NUM_ERROR_SAMPLES * dstPixelSize);
+    QVector<quint8> lutPixels(NUM_ERROR_SAMPLES * dstPixelSize);
+
+    // a simple LCG is enough here, but the samples must be the same
+    // on every run to keep the decision deterministic
+    quint32 seed = 0x9e3779b9;
+
+    quint8 *srcPtr = srcPixels.data();
+    for (int i = 0; i < NUM_ERROR_SAMPLES; i++) {
+        for (int ch = 0; ch < numInputs; ch++) {
+            seed = seed * 1664525 + 1013904223;
+            setSrcValue(srcPtr, srcColorOffsets[ch], float(seed >> 8) / float(0xffffff));
+        }
+        setSrcValue(srcPtr, srcAlphaOffset, 1.0f);
+        srcPtr += srcPixelSize;
+    }
+
+    exactTransform->transform(srcPixels.constData(), exactPixels.data(), NUM_ERROR_SAMPLES);
+    transformFunc(this, srcPixels.constData(), lutPixels.data(), NUM_ERROR_SAMPLES);
+
+    const float unit = unitValue(dstType);
+    const quint8 *exactPtr = exactPixels.constData();
+    const quint8 *lutPtr = lutPixels.constData();
+
+    maxError = 0.0;
+
+    for (int i = 0; i < NUM_ERROR_SAMPLES; i++) {
+        for (int ch = 0; ch < numOutputs; ch++) {
+            const qreal error = qAbs(dstValue(lutPtr, dstColorOffsets[ch]) -
+                                     dstValue(exactPtr, dstColorOffsets[ch])) / unit;
+            maxError = qMax(maxError, error);
+        }
+        exactPtr += dstPixelSize;
+        lutPtr += dstPixelSize;
+    }
+}
+
+template <typename src_channel_type>
+KoLutColorConversionTransformation::Private::TransformFunc
+KoLutColorConversionTransformation::Private::selectTransformFunc(KoChannelInfo::enumChannelValueType dstType)
+{
+    return dstType == KoChannelInfo::UINT8 ? &transformImpl<src_channel_type, quint8> :
+           dstType == KoChannelInfo::UINT16 ? &transformImpl<src_channel_type, quint16> :
+           &transformImpl<src_channel_type, float>;
+}
+
+template <typename src_channel_type, typename dst_channel_type>
+void KoLutColorConversionTransformation::Private::transformImpl(const Private *d, const quint8 *srcU8, quint8 *dstU8, qint32 nPixels)
+{
+    const src_channel_type *src = reinterpret_cast<const src_channel_type*>(srcU8);
+    dst_channel_type *dst = reinterpret_cast<dst_channel_type*>(dstU8);
+
+    const float gridScale = float(d->gridSize - 1) / LutChannelTraits<src_channel_type>::unitValue();
+    const float alphaScale =
+        LutChannelTraits<dst_channel_type>::unitValue() / LutChannelTraits<src_channel_type>::unitValue();
+
+    const int numOutputs = d->numOutputs;
+    const float *table = d->table.constData();
+    const int sliceSize = d->gridSize * d->gridSize * d->gridSize * numOutputs;
+
+    float result[MAX_OUTPUTS];
+    float nextSlice[MAX_OUTPUTS];
+
+    for (qint32 i = 0; i < nPixels; i++) {
+        const float x = src[d->srcColorOffsets[0]] * gridScale;
+        const float y = src[d->srcColorOffsets[1]] * gridScale;
+        const float z = src[d->srcColorOffsets[2]] * gridScale;
+
+        if (d->numInputs == 3) {
+            evaluateTetrahedral(table, d->gridSize, numOutputs, x, y, z, result);
+        } else {
+            const float k = src[d->srcColorOffsets[3]] * gridScale;
+            const int ik = qMin(int(k), d->gridSize - 2);
+            const float rk = k - ik;
+
+            const float *slice = table + ik * sliceSize;
+            evaluateTetrahedral(slice, d->gridSize, numOutputs, x, y, z, result);
+            evaluateTetrahedral(slice + sliceSize, d->gridSize, numOutputs, x, y, z, nextSlice);
+
+            for (int ch = 0; ch < numOutputs; ch++) {
+                result[ch] += rk * (nextSlice[ch] - result[ch]);
+            }
+        }
+
+        for (int ch = 0; ch < numOutputs; ch++) {
+            dst[d->dstColorOffsets[ch]] = LutChannelTraits<dst_channel_type>::fromFloat(result[ch]);
+        }
+
+        dst[d->dstAlphaOffset] =
+            LutChannelTraits<dst_channel_type>::fromFloat(src[d->srcAlphaOffset] * alphaScale);
+
+        src += d->srcPixelStride;
+        dst += d->dstPixelStride;
+    }
+}
+
+KoLutColorConversionTransformation::KoLutColorConversionTransformation(const KoColorConversionTransformation *exactTransform, int gridSize)
+    : KoColorConversionTransformation(exactTransform->srcColorSpace(),
+                                      exactTransform->dstColorSpace(),
+                                      exactTransform->renderingIntent(),
+                                      exactTransform->conversionFlags())
+    , d(new Private)
+{
+    const KoColorSpace *srcCs = srcColorSpace();
+    const KoColorSpace *dstCs = dstColorSpace();
+
+    Q_ASSERT(isSupported(srcCs, dstCs));
+
+    d->gridSize = gridSize > 0 ? qBound(2, gridSize, 256) : defaultGridSize(srcCs);
+    d->maxError = 0.0;
+
+    d->initLayout(srcCs, d->srcColorOffsets, &d->srcAlphaOffset, &d->srcPixelStride, &d->srcType, &d->numInputs);
+    d->initLayout(dstCs, d->dstColorOffsets, &d->dstAlphaOffset, &d->dstPixelStride, &d->dstType, &d->numOutputs);
+
+    d->transformFunc =
+        d->srcType == KoChannelInfo::UINT8 ?
+        Private::selectTransformFunc<quint8>(d->dstType) :
+        Private::selectTransformFunc<quint16>(d->dstType);
+
+    d->bakeTable(exactTransform);
+    d->measureError(exactTransform);
+}
+
+KoLutColorConversionTransformation::~KoLutColorConversionTransformation()
+{
+    delete d;
+}
+
+bool KoLutColorConversionTransformation::isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    return hasSupportedLayout(srcCs, false, 3, MAX_INPUTS) &&
+        hasSupportedLayout(dstCs, true, 1, MAX_OUTPUTS);
+}
+
+int KoLutColorConversionTransformation::defaultGridSize(const KoColorSpace *srcCs)
+{
+    return srcCs->colorChannelCount() > 3 ? 17 : 33;
+}
+
+qreal KoLutColorConversionTransformation::defaultMaxError()
+{
+    return 1.0 / 255.0;
+}
+
+KoColorConversionTransformation* KoLutColorConversionTransformation::tryCreate(KoColorConversionTransformation *exactTransform,
+                                                                               int gridSize,
+                                                                               qreal maxAllowedError)
+{
+    if (!isSupported(exactTransform->srcColorSpace(), exactTransform->dstColorSpace())) {
+        return exactTransform;
+    }
+
+    KoLutColorConversionTransformation *lutTransform =
+        new KoLutColorConversionTransformation(exactTransform, gridSize);
+
+    // a small epsilon to accept exactly one step of the destination
+    if (lutTransform->maxError() > maxAllowedError + 1e-6) {
+        delete lutTransform;
+        return exactTransform;
+    }
+
+    delete exactTransform;
+    return lutTransform;
+}
+
+int KoLutColorConversionTransformation::gridSize() const
+{
+    return d->gridSize;
+}
+
+qreal KoLutColorConversionTransformation::maxError() const
+{
+    return d->maxError;
+}
+
+void KoLutColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    d->transformFunc(d, src, dst, nPixels);
+}
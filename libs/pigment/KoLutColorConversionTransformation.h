@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _KO_LUT_COLOR_CONVERSION_TRANSFORMATION_H_
+#define _KO_LUT_COLOR_CONVERSION_TRANSFORMATION_H_
+
+#include "KoColorConversionTransformation.h"
+
+#include "kritapigment_export.h"
+
+/**
+ * A color conversion transformation that approximates another (exact)
+ * transformation with a precomputed lookup table.
+ *
+ * The exact transformation is sampled once on a regular grid of
+ * gridSize() nodes per source color channel. The pixels are then
+ * converted with tetrahedral interpolation between the nodes. Sources
+ * with four color channels (CMYK) use a stack of 3D tables that is
+ * interpolated linearly along the last channel. The alpha channel is
+ * converted directly, without the table.
+ *
+ * Only 8- and 16-bit integer sources with three or four color channels
+ * are supported. The destination may be 8-bit, 16-bit or 32-bit float.
+ *
+ * After the table is baked, it is compared with the exact transformation
+ * on a fixed set of sample colors. maxError() reports the largest
+ * deviation found, in normalized channel units (1.0 is the full range
+ * of an integer channel).
+ *
+ * Usually you don't create the transformation directly. Pass
+ * KoColorConversionTransformation::LutApproximation to the color
+ * conversion functions, and KoColorConversionSystem will use the table
+ * when it is supported and precise enough.
+ */
+class KRITAPIGMENT_EXPORT KoLutColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    /**
+     * Bakes the table for \p exactTransform. The exact transformation
+     * is not used after the constructor returns and is not owned by
+     * this object.
+     *
+     * @param gridSize the number of nodes per color channel. Pass 0
+     *        to use defaultGridSize().
+     */
+    KoLutColorConversionTransformation(const KoColorConversionTransformation *exactTransform, int gridSize = 0);
+    ~KoLutColorConversionTransformation();
+
+    /**
+     * @return true if the conversion from \p srcCs to \p dstCs can be
+     *         approximated with the table
+     */
+    static bool isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs);
+
+    /**
+     * @return the grid size used for sources of \p srcCs by default:
+     *         33 nodes for three color channels, 17 for four
+     */
+    static int defaultGridSize(const KoColorSpace *srcCs);
+
+    /**
+     * @return the maximum error for the table to be used for display
+     *         conversions (one step of an 8-bit channel)
+     */
+    static qreal defaultMaxError();
+
+    /**
+     * Replaces \p exactTransform with a table based approximation, if
+     * possible.
+     *
+     * If the conversion is supported and the measured error does not
+     * exceed \p maxAllowedError, \p exactTransform is deleted and the
+     * table based transformation is returned. Otherwise \p exactTransform
+     * itself is returned.
+     */
+    static KoColorConversionTransformation* tryCreate(KoColorConversionTransformation *exactTransform,
+                                                      int gridSize = 0,
+                                                      qreal maxAllowedError = defaultMaxError());
+
+    /**
+     * @return the number of grid nodes per color channel
+     */
+    int gridSize() const;
+
+    /**
+     * @return the largest deviation from the exact transformation
+     *         measured after baking the table
+     */
+    qreal maxError() const;
+
+    virtual void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const;
+
+private:
+    struct Private;
+    Private * const d;
+};
+
+#endif
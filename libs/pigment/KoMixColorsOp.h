@@ -56,6 +56,22 @@ public:
      */
     virtual void mixColors(const quint8 * const*colors, const qint16 *weights, quint32 nColors, quint8 *dst) const = 0;
     virtual void mixColors(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst) const = 0;
+
+    /**
+     * Mix a row of pixels in one call.
+     * @param colors \p nPixels groups of \p nColors pixels each. The groups
+     *               follow each other in the array without gaps.
+     * @param weights the coefficients of the pixels of a group, the same
+     *                for all the groups
+     * @param nColors the number of pixels in a group
+     * @param dst the destination row, the result of the group \c i is
+     *            written into the pixel \c i
+     * @param nPixels the number of groups (and destination pixels)
+     *
+     * The result is the same as calling mixColors() for every group, but
+     * the virtual call and the setup are done once per row.
+     */
+    virtual void mixColorsRow(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, quint32 nPixels) const = 0;
 };
 
 #endif
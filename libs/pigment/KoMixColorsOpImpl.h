@@ -22,6 +22,7 @@
 #define KOMIXCOLORSOPIMPL_H
 
 #include "KoMixColorsOp.h"
+#include "KoColorSpaceMaths.h"
 
 template<class _CSTrait>
 class KoMixColorsOpImpl : public KoMixColorsOp
@@ -38,7 +39,19 @@ public:
         mixColorsImpl(PointerToArray(colors, _CSTrait::pixelSize), weights, nColors, dst);
     }
 
-private:
+    virtual void mixColorsRow(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, quint32 nPixels) const {
+        const int groupSize = nColors * _CSTrait::pixelSize;
+
+        for (quint32 i = 0; i < nPixels; i++) {
+            mixColorsImpl(PointerToArray(colors, _CSTrait::pixelSize), weights, nColors, dst);
+            colors += groupSize;
+            dst += _CSTrait::pixelSize;
+        }
+    }
+
+protected:
+    typedef typename KoColorSpaceMathsTraits<typename _CSTrait::channels_type>::compositetype compositetype;
+
     struct ArrayOfPointers {
         ArrayOfPointers(const quint8 * const* colors)
             : m_colors(colors)
@@ -111,6 +124,14 @@ private:
             weights++;
         }
 
+        writeMixedPixel(totals, totalAlpha, dst);
+    }
+
+    /**
+     * Writes the mixed pixel from the sums of the channels premultiplied
+     * by alpha and weight. Shared with the optimized versions of the op.
+     */
+    static void writeMixedPixel(const compositetype *totals, compositetype totalAlpha, quint8 *dst) {
         // set totalAlpha to the minimum between its value and the unit value of the channels
         const int sumOfWeights = 255;
 
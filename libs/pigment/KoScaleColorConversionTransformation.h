@@ -21,6 +21,8 @@
 
 #include <KoColorConversionTransformation.h>
 #include <KoColorConversionTransformationFactory.h>
+#include "KoColorDepthConversion.h"
+
 /**
  * This transformation allows to convert between two color spaces with the same
  * color model but different channel type.
@@ -33,11 +35,9 @@ public:
         Q_ASSERT(srcCs->colorModelId() == dstCs->colorModelId());
     }
     virtual void transform(const quint8 *srcU8, quint8 *dstU8, qint32 nPixels) const {
-        const typename _src_CSTraits_::channels_type* src = _src_CSTraits_::nativeArray(srcU8);
-        typename _dst_CSTraits_::channels_type* dst = _dst_CSTraits_::nativeArray(dstU8);
-        for (quint32 i = 0; i < _src_CSTraits_::channels_nb * nPixels; i++) {
-            dst[i] = KoColorSpaceMaths<typename _src_CSTraits_::channels_type, typename _dst_CSTraits_::channels_type>::scaleToA(src[i]);
-        }
+        KoColorDepthConversion::scaleChannels(_src_CSTraits_::nativeArray(srcU8),
+                                              _dst_CSTraits_::nativeArray(dstU8),
+                                              _src_CSTraits_::channels_nb * nPixels);
     }
 };
 
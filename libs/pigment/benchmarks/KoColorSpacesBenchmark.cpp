@@ -21,6 +21,10 @@
 #include <QTest>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorTransformation.h>
+#include <KoColorProfile.h>
+#include <KoLutColorConversionTransformation.h>
 
 #define NB_PIXELS 1000000
 
@@ -146,4 +150,153 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+void KoColorSpacesBenchmark::benchmarkConversion_data()
+{
+    QTest::addColumn<QString>("srcModelID");
+    QTest::addColumn<QString>("srcDepthID");
+    QTest::addColumn<QString>("dstModelID");
+    QTest::addColumn<QString>("dstDepthID");
+
+    const QString rgb = RGBAColorModelID.id();
+    const QString lab = LABAColorModelID.id();
+    const QString u8 = Integer8BitsColorDepthID.id();
+    const QString u16 = Integer16BitsColorDepthID.id();
+    const QString f32 = Float32BitsColorDepthID.id();
+
+    QTest::newRow("rgb8 -> rgb16") << rgb << u8 << rgb << u16;
+    QTest::newRow("rgb16 -> rgb8") << rgb << u16 << rgb << u8;
+    QTest::newRow("rgb8 -> lab16") << rgb << u8 << lab << u16;
+    QTest::newRow("lab16 -> rgb8") << lab << u16 << rgb << u8;
+    QTest::newRow("rgb16 -> rgbF32") << rgb << u16 << rgb << f32;
+}
+
+void KoColorSpacesBenchmark::benchmarkConversion()
+{
+    QFETCH(QString, srcModelID);
+    QFETCH(QString, srcDepthID);
+    QFETCH(QString, dstModelID);
+    QFETCH(QString, dstDepthID);
+
+    const KoColorSpace* srcColorSpace = KoColorSpaceRegistry::instance()->colorSpace(srcModelID, srcDepthID, 0);
+    const KoColorSpace* dstColorSpace = KoColorSpaceRegistry::instance()->colorSpace(dstModelID, dstDepthID, 0);
+
+    if (!srcColorSpace || !dstColorSpace) {
+        QSKIP("Color space is not available");
+    }
+
+    quint8* src = new quint8[NB_PIXELS * srcColorSpace->pixelSize()];
+    quint8* dst = new quint8[NB_PIXELS * dstColorSpace->pixelSize()];
+
+    for (int i = 0; i < NB_PIXELS * int(srcColorSpace->pixelSize()); ++i) {
+        src[i] = i % 251;
+    }
+
+    QBENCHMARK {
+        srcColorSpace->convertPixelsTo(src, dst, dstColorSpace, NB_PIXELS,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+    }
+
+    delete[] src;
+    delete[] dst;
+}
+
+void KoColorSpacesBenchmark::benchmarkBrightnessContrastAdjustment_data()
+{
+    QTest::addColumn<QString>("modelID");
+    QTest::addColumn<QString>("depthID");
+
+    QTest::newRow("rgb8") << RGBAColorModelID.id() << Integer8BitsColorDepthID.id();
+    QTest::newRow("rgb16") << RGBAColorModelID.id() << Integer16BitsColorDepthID.id();
+}
+
+void KoColorSpacesBenchmark::benchmarkBrightnessContrastAdjustment()
+{
+    START_BENCHMARK
+
+    quint16 transferValues[256];
+    for (int i = 0; i < 256; ++i) {
+        transferValues[i] = qBound(0, 512 * i - 16384, 65535);
+    }
+
+    KoColorTransformation *adjustment = colorSpace->createBrightnessContrastAdjustment(transferValues);
+    QVERIFY(adjustment);
+
+    QBENCHMARK {
+        adjustment->transform(data, data, NB_PIXELS);
+    }
+
+    delete adjustment;
+    END_BENCHMARK
+}
+
+void KoColorSpacesBenchmark::benchmarkLutConversion_data()
+{
+    QTest::addColumn<QString>("modelID");
+    QTest::addColumn<bool>("useLut");
+
+    QTest::newRow("rgb8 -> sRGB, exact") << RGBAColorModelID.id() << false;
+    QTest::newRow("rgb8 -> sRGB, lut") << RGBAColorModelID.id() << true;
+    QTest::newRow("cmyk8 -> sRGB, exact") << CMYKAColorModelID.id() << false;
+    QTest::newRow("cmyk8 -> sRGB, lut") << CMYKAColorModelID.id() << true;
+}
+
+void KoColorSpacesBenchmark::benchmarkLutConversion()
+{
+    QFETCH(QString, modelID);
+    QFETCH(bool, useLut);
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+    const KoColorSpace *dstColorSpace = registry->rgb8();
+    const KoColorSpace *srcColorSpace = 0;
+
+    if (modelID == RGBAColorModelID.id()) {
+        // the default RGB profile is sRGB, so take any other one
+        const QString csId = registry->colorSpaceId(RGBAColorModelID, Integer8BitsColorDepthID);
+        Q_FOREACH (const KoColorProfile *profile, registry->profilesFor(csId)) {
+            if (profile->name() != dstColorSpace->profile()->name()) {
+                srcColorSpace = registry->colorSpace(RGBAColorModelID.id(), Integer8BitsColorDepthID.id(), profile);
+                break;
+            }
+        }
+    } else {
+        srcColorSpace = registry->colorSpace(modelID, Integer8BitsColorDepthID.id(), 0);
+    }
+
+    if (!srcColorSpace) {
+        QSKIP("Color space is not available");
+    }
+
+    KoColorConversionTransformation *exact =
+        srcColorSpace->createColorConverter(dstColorSpace,
+                                            KoColorConversionTransformation::internalRenderingIntent(),
+                                            KoColorConversionTransformation::internalConversionFlags());
+
+    KoColorConversionTransformation *transform = exact;
+
+    if (useLut) {
+        KoLutColorConversionTransformation *lut = new KoLutColorConversionTransformation(exact);
+        transform = lut;
+    }
+
+    quint8* src = new quint8[NB_PIXELS * srcColorSpace->pixelSize()];
+    quint8* dst = new quint8[NB_PIXELS * dstColorSpace->pixelSize()];
+
+    for (int i = 0; i < NB_PIXELS * int(srcColorSpace->pixelSize()); ++i) {
+        src[i] = (i * 7919) % 251;
+    }
+
+    QBENCHMARK {
+        transform->transform(src, dst, NB_PIXELS);
+    }
+
+    if (transform != exact) {
+        delete transform;
+    }
+    delete exact;
+
+    delete[] src;
+    delete[] dst;
+}
+
 QTEST_MAIN(KoColorSpacesBenchmark)
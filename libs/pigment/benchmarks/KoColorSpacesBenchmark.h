@@ -39,6 +39,12 @@ private Q_SLOTS:
     void benchmarkSetAlphaIndividualCall();
     void benchmarkSetAlpha2IndividualCall_data();
     void benchmarkSetAlpha2IndividualCall();
+    void benchmarkConversion_data();
+    void benchmarkConversion();
+    void benchmarkBrightnessContrastAdjustment_data();
+    void benchmarkBrightnessContrastAdjustment();
+    void benchmarkLutConversion_data();
+    void benchmarkLutConversion();
 };
 
 #endif
@@ -87,5 +87,41 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarken()
     }
 }
 
+void KoCompositeOpsBenchmark::benchmarkCompositeOverU16Legacy()
+{
+    KoCompositeOp *compositeOp = new KoCompositeOpOver<KoBgrU16Traits>(KoColorSpaceRegistry::instance()->rgb16());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+    delete compositeOp;
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverU16()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createOverOp64(KoColorSpaceRegistry::instance()->rgb16());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+    delete compositeOp;
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenU16Legacy()
+{
+    KoCompositeOp *compositeOp = new KoCompositeOpAlphaDarken<KoBgrU16Traits>(KoColorSpaceRegistry::instance()->rgb16());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+    delete compositeOp;
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenU16()
+{
+    KoCompositeOp *compositeOp = KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(KoColorSpaceRegistry::instance()->rgb16());
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+    delete compositeOp;
+}
+
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
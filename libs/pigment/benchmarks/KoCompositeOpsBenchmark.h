@@ -33,6 +33,11 @@ private Q_SLOTS:
     void benchmarkCompositeOver();
     void benchmarkCompositeAlphaDarken();
 
+    void benchmarkCompositeOverU16Legacy();
+    void benchmarkCompositeOverU16();
+    void benchmarkCompositeAlphaDarkenU16Legacy();
+    void benchmarkCompositeAlphaDarkenU16();
+
 private:
     quint8 * m_dstBuffer;
     quint8 * m_srcBuffer;
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "KoPixelSpanBenchmark.h"
+
+#include <QTest>
+#include <QVector>
+
+#include <KoColorSpaceRegistry.h>
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+
+#define NB_PIXELS 1000000
+
+/**
+ * The iterators return at most a tile row of consequent pixels,
+ * so the span versions are called for 64 pixels at once
+ */
+#define SPAN_SIZE 64
+
+namespace {
+
+void createRows()
+{
+    QTest::addColumn<QString>("depthID");
+
+    QTest::newRow("rgb8") << Integer8BitsColorDepthID.id();
+    QTest::newRow("rgb16") << Integer16BitsColorDepthID.id();
+    QTest::newRow("rgbf32") << Float32BitsColorDepthID.id();
+}
+
+}
+
+#define START_BENCHMARK \
+    QFETCH(QString, depthID); \
+    \
+    const KoColorSpace* colorSpace = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthID, 0); \
+    const int pixelSize = colorSpace->pixelSize(); \
+    QVector<quint8> pixels(NB_PIXELS * pixelSize); \
+    QVector<quint8> alpha(NB_PIXELS); \
+    for (int i = 0; i < NB_PIXELS; i++) { \
+        alpha[i] = i % 256; \
+    } \
+    colorSpace->setOpacity(pixels.data(), OPACITY_OPAQUE_U8, NB_PIXELS); \
+    quint8 *data = pixels.data(); \
+    quint8 *mask = alpha.data();
+
+void KoPixelSpanBenchmark::benchmarkOpacityU8PerPixel_data()
+{
+    createRows();
+}
+
+void KoPixelSpanBenchmark::benchmarkOpacityU8PerPixel()
+{
+    START_BENCHMARK
+    QBENCHMARK {
+        for (int i = 0; i < NB_PIXELS; i++) {
+            mask[i] = colorSpace->opacityU8(data + i * pixelSize);
+        }
+    }
+}
+
+void KoPixelSpanBenchmark::benchmarkCopyOpacityU8_data()
+{
+    createRows();
+}
+
+void KoPixelSpanBenchmark::benchmarkCopyOpacityU8()
+{
+    START_BENCHMARK
+    QBENCHMARK {
+        for (int i = 0; i < NB_PIXELS; i += SPAN_SIZE) {
+            colorSpace->copyOpacityU8(data + i * pixelSize, mask + i, qMin(SPAN_SIZE, NB_PIXELS - i));
+        }
+    }
+}
+
+void KoPixelSpanBenchmark::benchmarkApplyAlphaU8MaskPerPixel_data()
+{
+    createRows();
+}
+
+void KoPixelSpanBenchmark::benchmarkApplyAlphaU8MaskPerPixel()
+{
+    START_BENCHMARK
+    QBENCHMARK {
+        for (int i = 0; i < NB_PIXELS; i++) {
+            colorSpace->applyAlphaU8Mask(data + i * pixelSize, mask + i, 1);
+        }
+    }
+}
+
+void KoPixelSpanBenchmark::benchmarkApplyAlphaU8Mask_data()
+{
+    createRows();
+}
+
+void KoPixelSpanBenchmark::benchmarkApplyAlphaU8Mask()
+{
+    START_BENCHMARK
+    QBENCHMARK {
+        for (int i = 0; i < NB_PIXELS; i += SPAN_SIZE) {
+            colorSpace->applyAlphaU8Mask(data + i * pixelSize, mask + i, qMin(SPAN_SIZE, NB_PIXELS - i));
+        }
+    }
+}
+
+void KoPixelSpanBenchmark::benchmarkMultiplyAlphaPerPixel_data()
+{
+    createRows();
+}
+
+void KoPixelSpanBenchmark::benchmarkMultiplyAlphaPerPixel()
+{
+    START_BENCHMARK
+    Q_UNUSED(mask);
+    QBENCHMARK {
+        for (int i = 0; i < NB_PIXELS; i++) {
+            colorSpace->multiplyAlpha(data + i * pixelSize, 250, 1);
+        }
+    }
+}
+
+void KoPixelSpanBenchmark::benchmarkMultiplyAlpha_data()
+{
+    createRows();
+}
+
+void KoPixelSpanBenchmark::benchmarkMultiplyAlpha()
+{
+    START_BENCHMARK
+    Q_UNUSED(mask);
+    QBENCHMARK {
+        for (int i = 0; i < NB_PIXELS; i += SPAN_SIZE) {
+            colorSpace->multiplyAlpha(data + i * pixelSize, 250, qMin(SPAN_SIZE, NB_PIXELS - i));
+        }
+    }
+}
+
+QTEST_MAIN(KoPixelSpanBenchmark)
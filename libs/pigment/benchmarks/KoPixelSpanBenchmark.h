@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KO_PIXEL_SPAN_BENCHMARK_H
+#define __KO_PIXEL_SPAN_BENCHMARK_H
+
+#include <QObject>
+
+/**
+ * Compares the per-pixel virtual calls of the alpha related
+ * KoColorSpace methods with their span versions
+ */
+class KoPixelSpanBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkOpacityU8PerPixel_data();
+    void benchmarkOpacityU8PerPixel();
+    void benchmarkCopyOpacityU8_data();
+    void benchmarkCopyOpacityU8();
+
+    void benchmarkApplyAlphaU8MaskPerPixel_data();
+    void benchmarkApplyAlphaU8MaskPerPixel();
+    void benchmarkApplyAlphaU8Mask_data();
+    void benchmarkApplyAlphaU8Mask();
+
+    void benchmarkMultiplyAlphaPerPixel_data();
+    void benchmarkMultiplyAlphaPerPixel();
+    void benchmarkMultiplyAlpha_data();
+    void benchmarkMultiplyAlpha();
+};
+
+#endif /* __KO_PIXEL_SPAN_BENCHMARK_H */
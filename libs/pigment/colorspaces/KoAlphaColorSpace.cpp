@@ -303,6 +303,15 @@ quint8 KoAlphaColorSpace::differenceA(const quint8 *src1, const quint8 *src2) co
     return difference(src1, src2);
 }
 
+void KoAlphaColorSpace::differences(const quint8 *src, const quint8 *pixels, quint8 *diffs, qint32 nPixels) const
+{
+    const int srcValue = src[PIXEL_MASK];
+
+    for (qint32 i = 0; i < nPixels; i++) {
+        diffs[i] = qAbs(pixels[i] - srcValue);
+    }
+}
+
 QString KoAlphaColorSpace::channelValueText(const quint8 *pixel, quint32 channelIndex) const
 {
     Q_ASSERT(channelIndex < channelCount());
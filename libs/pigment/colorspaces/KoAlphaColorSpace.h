@@ -74,6 +74,7 @@ public:
 
     virtual quint8 difference(const quint8 *src1, const quint8 *src2) const;
     virtual quint8 differenceA(const quint8 *src1, const quint8 *src2) const;
+    virtual void differences(const quint8 *src, const quint8 *pixels, quint8 *diffs, qint32 nPixels) const;
 
     virtual quint32 colorChannelCount() const {
         return 0;
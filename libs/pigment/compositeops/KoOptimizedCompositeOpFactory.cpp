@@ -42,6 +42,16 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp32(const KoColorSpace
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32> >(cs);
 }
 
+KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp64(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64> >(cs);
+}
+
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOp128(const KoColorSpace *cs)
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken128> >(cs);
@@ -51,3 +61,18 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp128(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128> >(cs);
 }
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp32(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedGenericOpFactoryPerArch<quint8> >(KoOptimizedGenericOpParams(cs, id, description, category));
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp64(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedGenericOpFactoryPerArch<quint16> >(KoOptimizedGenericOpParams(cs, id, description, category));
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp128(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedGenericOpFactoryPerArch<float> >(KoOptimizedGenericOpParams(cs, id, description, category));
+}
@@ -24,6 +24,7 @@
 
 class KoCompositeOp;
 class KoColorSpace;
+class QString;
 
 /**
  * The creation of the optimized composite ops is moved into a separate
@@ -42,8 +43,24 @@ class KRITAPIGMENT_EXPORT KoOptimizedCompositeOpFactory
 public:
     static KoCompositeOp* createAlphaDarkenOp32(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOp64(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOp64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOp128(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp128(const KoColorSpace *cs);
+
+    /**
+     * Vectorized versions of the separable blending modes (Multiply,
+     * Screen, Overlay, etc.) for 8-bit, 16-bit and 32-bit float
+     * C1_C2_C3_A colorspaces.
+     *
+     * \return the composite op or null if the mode \p id has no
+     *         vectorized version (or the vectorization is not
+     *         available on this CPU). Then KoCompositeOpGenericSC
+     *         should be used instead.
+     */
+    static KoCompositeOp* createGenericOp32(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category);
+    static KoCompositeOp* createGenericOp64(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category);
+    static KoCompositeOp* createGenericOp128(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
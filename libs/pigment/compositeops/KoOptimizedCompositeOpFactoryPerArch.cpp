@@ -23,9 +23,13 @@
 
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
 #include "KoOptimizedCompositeOpAlphaDarken32.h"
+#include "KoOptimizedCompositeOpAlphaDarken64.h"
 #include "KoOptimizedCompositeOpAlphaDarken128.h"
 #include "KoOptimizedCompositeOpOver32.h"
+#include "KoOptimizedCompositeOpOver64.h"
 #include "KoOptimizedCompositeOpOver128.h"
+#include "KoOptimizedCompositeOpGeneric.h"
+#include "KoOptimizedMixColorsOpImpl.h"
 
 #include <QString>
 #include "DebugPigment.h"
@@ -52,6 +56,22 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>::create<Vc::C
     return new KoOptimizedCompositeOpOver32<Vc::CurrentImplementation::current()>(param);
 }
 
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return new KoOptimizedCompositeOpAlphaDarken64<Vc::CurrentImplementation::current()>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return new KoOptimizedCompositeOpOver64<Vc::CurrentImplementation::current()>(param);
+}
+
 template<>
 template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken128>::ReturnType
@@ -68,6 +88,78 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<Vc::
     return new KoOptimizedCompositeOpOver128<Vc::CurrentImplementation::current()>(param);
 }
 
+template<>
+template<>
+KoOptimizedGenericOpFactoryPerArch<quint8>::ReturnType
+KoOptimizedGenericOpFactoryPerArch<quint8>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return KoOptimizedCompositeOpGenericCreator<Vc::CurrentImplementation::current(), quint8>::create(param);
+}
+
+template<>
+template<>
+KoOptimizedGenericOpFactoryPerArch<quint16>::ReturnType
+KoOptimizedGenericOpFactoryPerArch<quint16>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return KoOptimizedCompositeOpGenericCreator<Vc::CurrentImplementation::current(), quint16>::create(param);
+}
+
+template<>
+template<>
+KoOptimizedGenericOpFactoryPerArch<float>::ReturnType
+KoOptimizedGenericOpFactoryPerArch<float>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return KoOptimizedCompositeOpGenericCreator<Vc::CurrentImplementation::current(), float>::create(param);
+}
+
+template<>
+template<>
+KoOptimizedMixColorsOpFactoryPerArch<quint8>::ReturnType
+KoOptimizedMixColorsOpFactoryPerArch<quint8>::create<Vc::CurrentImplementation::current()>(ParamType)
+{
+    return new KoOptimizedMixColorsOpImpl<Vc::CurrentImplementation::current(), KoBgrU8Traits>();
+}
+
+template<>
+template<>
+KoOptimizedMixColorsOpFactoryPerArch<quint16>::ReturnType
+KoOptimizedMixColorsOpFactoryPerArch<quint16>::create<Vc::CurrentImplementation::current()>(ParamType)
+{
+    return new KoOptimizedMixColorsOpImpl<Vc::CurrentImplementation::current(), KoBgrU16Traits>();
+}
+
+template<>
+template<>
+KoOptimizedMixColorsOpFactoryPerArch<float>::ReturnType
+KoOptimizedMixColorsOpFactoryPerArch<float>::create<Vc::CurrentImplementation::current()>(ParamType)
+{
+    return new KoOptimizedMixColorsOpImpl<Vc::CurrentImplementation::current(), KoRgbF32Traits>();
+}
+
+template<>
+template<>
+KoOptimizedConvolutionOpFactoryPerArch<quint8>::ReturnType
+KoOptimizedConvolutionOpFactoryPerArch<quint8>::create<Vc::CurrentImplementation::current()>(ParamType)
+{
+    return new KoOptimizedConvolutionOpImpl<Vc::CurrentImplementation::current(), KoBgrU8Traits>();
+}
+
+template<>
+template<>
+KoOptimizedConvolutionOpFactoryPerArch<quint16>::ReturnType
+KoOptimizedConvolutionOpFactoryPerArch<quint16>::create<Vc::CurrentImplementation::current()>(ParamType)
+{
+    return new KoOptimizedConvolutionOpImpl<Vc::CurrentImplementation::current(), KoBgrU16Traits>();
+}
+
+template<>
+template<>
+KoOptimizedConvolutionOpFactoryPerArch<float>::ReturnType
+KoOptimizedConvolutionOpFactoryPerArch<float>::create<Vc::CurrentImplementation::current()>(ParamType)
+{
+    return new KoOptimizedConvolutionOpImpl<Vc::CurrentImplementation::current(), KoRgbF32Traits>();
+}
+
 #define __stringify(_s) #_s
 #define stringify(_s) __stringify(_s)
 
@@ -23,9 +23,12 @@
 
 #include <compositeops/KoVcMultiArchBuildSupport.h>
 
+#include <QString>
 
 class KoCompositeOp;
 class KoColorSpace;
+class KoMixColorsOp;
+class KoConvolutionOp;
 
 
 template<Vc::Implementation _impl>
@@ -34,6 +37,12 @@ class KoOptimizedCompositeOpAlphaDarken32;
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpOver32;
 
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarken64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64;
+
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpAlphaDarken128;
 
@@ -50,6 +59,63 @@ struct KoOptimizedCompositeOpFactoryPerArch
     static ReturnType create(ParamType param);
 };
 
+/**
+ * Parameters of a generic separable composite op, \see
+ * KoOptimizedCompositeOpFactory::createGenericOp32()
+ */
+struct KoOptimizedGenericOpParams
+{
+    KoOptimizedGenericOpParams(const KoColorSpace *_colorSpace,
+                               const QString &_id,
+                               const QString &_description,
+                               const QString &_category)
+        : colorSpace(_colorSpace),
+          id(_id),
+          description(_description),
+          category(_category)
+    {
+    }
+
+    const KoColorSpace *colorSpace;
+    QString id;
+    QString description;
+    QString category;
+};
+
+template<typename channels_type>
+struct KoOptimizedGenericOpFactoryPerArch
+{
+    typedef const KoOptimizedGenericOpParams& ParamType;
+    typedef KoCompositeOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType param);
+};
+
+/**
+ * Vectorized mixing ops for four channel colorspaces with alpha in
+ * the last channel, \see KoOptimizedMixColorsOpFactory
+ */
+template<typename channels_type>
+struct KoOptimizedMixColorsOpFactoryPerArch
+{
+    typedef void* ParamType;
+    typedef KoMixColorsOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType);
+};
+
+template<typename channels_type>
+struct KoOptimizedConvolutionOpFactoryPerArch
+{
+    typedef void* ParamType;
+    typedef KoConvolutionOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType);
+};
+
 struct KoReportCurrentArch
 {
     typedef void* ParamType;
@@ -40,6 +40,22 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>::create<Vc::S
     return new KoCompositeOpOver<KoBgrU8Traits>(param);
 }
 
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoBgrU16Traits>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpOver<KoBgrU16Traits>(param);
+}
+
 template<>
 template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken128>::ReturnType
@@ -56,6 +72,89 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<Vc::
     return new KoCompositeOpOver<KoRgbF32Traits>(param);
 }
 
+/**
+ * The generic separable ops have no special scalar version, the
+ * callers fall back to KoCompositeOpGenericSC
+ */
+template<>
+template<>
+KoOptimizedGenericOpFactoryPerArch<quint8>::ReturnType
+KoOptimizedGenericOpFactoryPerArch<quint8>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedGenericOpFactoryPerArch<quint16>::ReturnType
+KoOptimizedGenericOpFactoryPerArch<quint16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedGenericOpFactoryPerArch<float>::ReturnType
+KoOptimizedGenericOpFactoryPerArch<float>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    return 0;
+}
+
+/**
+ * The mixing ops have no special scalar version either, the colorspaces
+ * use KoMixColorsOpImpl and KoConvolutionOpImpl
+ */
+template<>
+template<>
+KoOptimizedMixColorsOpFactoryPerArch<quint8>::ReturnType
+KoOptimizedMixColorsOpFactoryPerArch<quint8>::create<Vc::ScalarImpl>(ParamType)
+{
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedMixColorsOpFactoryPerArch<quint16>::ReturnType
+KoOptimizedMixColorsOpFactoryPerArch<quint16>::create<Vc::ScalarImpl>(ParamType)
+{
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedMixColorsOpFactoryPerArch<float>::ReturnType
+KoOptimizedMixColorsOpFactoryPerArch<float>::create<Vc::ScalarImpl>(ParamType)
+{
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedConvolutionOpFactoryPerArch<quint8>::ReturnType
+KoOptimizedConvolutionOpFactoryPerArch<quint8>::create<Vc::ScalarImpl>(ParamType)
+{
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedConvolutionOpFactoryPerArch<quint16>::ReturnType
+KoOptimizedConvolutionOpFactoryPerArch<quint16>::create<Vc::ScalarImpl>(ParamType)
+{
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedConvolutionOpFactoryPerArch<float>::ReturnType
+KoOptimizedConvolutionOpFactoryPerArch<float>::create<Vc::ScalarImpl>(ParamType)
+{
+    return 0;
+}
+
 template<>
 KoReportCurrentArch::ReturnType
 KoReportCurrentArch::create<Vc::ScalarImpl>(ParamType)
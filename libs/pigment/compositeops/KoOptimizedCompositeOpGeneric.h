@@ -0,0 +1,577 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
+
+#include <limits>
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+#include "KoOptimizedCompositeOpFactoryPerArch.h"
+
+
+/**
+ * Helper functions for the blending functions below. All of them
+ * are overloaded for float and Vc::float_v, so that the same blending
+ * function could be used both in the vector and in the scalar code.
+ *
+ * Everything here is templated by the implementation to avoid ODR
+ * violations between the objects compiled for different architectures.
+ */
+template<Vc::Implementation _impl>
+struct KoStreamedBlendMath
+{
+    static ALWAYS_INLINE float select(bool condition, float a, float b) {
+        return condition ? a : b;
+    }
+
+    static ALWAYS_INLINE Vc::float_v select(Vc::float_m condition, Vc::float_v::AsArg a, Vc::float_v::AsArg b) {
+        return Vc::iif(condition, a, b);
+    }
+
+    static ALWAYS_INLINE float min(float a, float b) {
+        return qMin(a, b);
+    }
+
+    static ALWAYS_INLINE Vc::float_v min(Vc::float_v::AsArg a, Vc::float_v::AsArg b) {
+        return Vc::min(a, b);
+    }
+
+    static ALWAYS_INLINE float max(float a, float b) {
+        return qMax(a, b);
+    }
+
+    static ALWAYS_INLINE Vc::float_v max(Vc::float_v::AsArg a, Vc::float_v::AsArg b) {
+        return Vc::max(a, b);
+    }
+
+    /**
+     * Integer colorspaces clamp the result of the blending into
+     * [0, unitValue] range, floating point ones keep it as it is
+     */
+    template<bool clampResult, typename T>
+    static ALWAYS_INLINE T clamp(T value) {
+        return clampResult ? min(max(value, T(0.0f)), T(1.0f)) : value;
+    }
+};
+
+/**
+ * Vectorizable versions of the separable blending functions from
+ * KoCompositeOpFunctions.h. They operate on the values normalized into
+ * [0.0, 1.0] range and should follow the scalar versions as close
+ * as possible.
+ */
+struct KoStreamedBlendMultiply {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return src * dst;
+    }
+};
+
+struct KoStreamedBlendScreen {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return src + dst - src * dst;
+    }
+};
+
+struct KoStreamedBlendHardLight {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        typedef KoStreamedBlendMath<_impl> M;
+
+        const T src2 = src + src;
+        const T src2Screen = src2 - T(1.0f);
+
+        const T screen = src2Screen + dst - src2Screen * dst;
+        const T multiply = M::template clamp<clampResult>(src2 * dst);
+
+        return M::select(src > T(0.5f), screen, multiply);
+    }
+};
+
+struct KoStreamedBlendOverlay {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return KoStreamedBlendHardLight::apply<_impl, clampResult>(dst, src);
+    }
+};
+
+struct KoStreamedBlendColorDodge {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        typedef KoStreamedBlendMath<_impl> M;
+
+        /**
+         * The division may produce inf or NaN values, but they
+         * are filtered out by the selects below
+         */
+        const T invSrc = T(1.0f) - src;
+        T result = M::template clamp<clampResult>(dst / invSrc);
+        result = M::select(invSrc < dst, T(1.0f), result);
+        return M::select(dst == T(0.0f), T(0.0f), result);
+    }
+};
+
+struct KoStreamedBlendColorBurn {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        typedef KoStreamedBlendMath<_impl> M;
+
+        const T invDst = T(1.0f) - dst;
+        T result = T(1.0f) - M::template clamp<clampResult>(invDst / src);
+        result = M::select(src < invDst, T(0.0f), result);
+        return M::select(dst == T(1.0f), T(1.0f), result);
+    }
+};
+
+struct KoStreamedBlendAddition {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return KoStreamedBlendMath<_impl>::template clamp<clampResult>(src + dst);
+    }
+};
+
+struct KoStreamedBlendSubtract {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return KoStreamedBlendMath<_impl>::template clamp<clampResult>(dst - src);
+    }
+};
+
+struct KoStreamedBlendLinearBurn {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return KoStreamedBlendMath<_impl>::template clamp<clampResult>(src + dst - T(1.0f));
+    }
+};
+
+struct KoStreamedBlendDifference {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        typedef KoStreamedBlendMath<_impl> M;
+        return M::max(src, dst) - M::min(src, dst);
+    }
+};
+
+struct KoStreamedBlendExclusion {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        const T x = src * dst;
+        return KoStreamedBlendMath<_impl>::template clamp<clampResult>(dst + src - (x + x));
+    }
+};
+
+struct KoStreamedBlendDarken {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return KoStreamedBlendMath<_impl>::min(src, dst);
+    }
+};
+
+struct KoStreamedBlendLighten {
+    template<Vc::Implementation _impl, bool clampResult, typename T>
+    static ALWAYS_INLINE T apply(T src, T dst) {
+        return KoStreamedBlendMath<_impl>::max(src, dst);
+    }
+};
+
+
+/**
+ * Loads and stores C1_C2_C3_A pixels converting the channels into
+ * normalized floats. The order of the color channels is not important,
+ * since the blending functions are separable.
+ */
+template<typename channels_type, Vc::Implementation _impl>
+struct KoStreamedPixelIO;
+
+template<Vc::Implementation _impl>
+struct KoStreamedPixelIO<quint8, _impl>
+{
+    static ALWAYS_INLINE float scaleToFloat(quint8 value) {
+        return float(value) * (1.0f / 255.0f);
+    }
+
+    static ALWAYS_INLINE quint8 scaleFromFloat(float value) {
+        return KoStreamedMath<_impl>::round_float_to_uint(value * 255.0f);
+    }
+
+    template<bool aligned>
+    static ALWAYS_INLINE void fetch(const quint8 *data,
+                                    Vc::float_v &c1, Vc::float_v &c2, Vc::float_v &c3,
+                                    Vc::float_v &alpha) {
+
+        const Vc::float_v uint8MaxRec1(1.0f / 255.0f);
+
+        KoStreamedMath<_impl>::template fetch_colors_32<aligned>(data, c1, c2, c3);
+        alpha = KoStreamedMath<_impl>::template fetch_alpha_32<aligned>(data);
+
+        c1 *= uint8MaxRec1;
+        c2 *= uint8MaxRec1;
+        c3 *= uint8MaxRec1;
+        alpha *= uint8MaxRec1;
+    }
+
+    static ALWAYS_INLINE void write(quint8 *data,
+                                    Vc::float_v::AsArg c1, Vc::float_v::AsArg c2, Vc::float_v::AsArg c3,
+                                    Vc::float_v::AsArg alpha) {
+
+        const Vc::float_v uint8Max(255.0f);
+
+        KoStreamedMath<_impl>::write_channels_32(data,
+                                                 alpha * uint8Max,
+                                                 c1 * uint8Max,
+                                                 c2 * uint8Max,
+                                                 c3 * uint8Max);
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedPixelIO<quint16, _impl>
+{
+    static ALWAYS_INLINE float scaleToFloat(quint16 value) {
+        return float(value) * (1.0f / 65535.0f);
+    }
+
+    static ALWAYS_INLINE quint16 scaleFromFloat(float value) {
+        return quint16(value * 65535.0f + 0.5f);
+    }
+
+    template<bool aligned>
+    static ALWAYS_INLINE void fetch(const quint8 *data,
+                                    Vc::float_v &c1, Vc::float_v &c2, Vc::float_v &c3,
+                                    Vc::float_v &alpha) {
+
+        const Vc::float_v uint16MaxRec1(1.0f / 65535.0f);
+
+        KoStreamedMath<_impl>::fetch_colors_64(data, c1, c2, c3);
+        alpha = KoStreamedMath<_impl>::fetch_alpha_64(data);
+
+        c1 *= uint16MaxRec1;
+        c2 *= uint16MaxRec1;
+        c3 *= uint16MaxRec1;
+        alpha *= uint16MaxRec1;
+    }
+
+    static ALWAYS_INLINE void write(quint8 *data,
+                                    Vc::float_v::AsArg c1, Vc::float_v::AsArg c2, Vc::float_v::AsArg c3,
+                                    Vc::float_v::AsArg alpha) {
+
+        const Vc::float_v uint16Max(65535.0f);
+
+        KoStreamedMath<_impl>::write_channels_64(data,
+                                                 alpha * uint16Max,
+                                                 c1 * uint16Max,
+                                                 c2 * uint16Max,
+                                                 c3 * uint16Max);
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedPixelIO<float, _impl>
+{
+    struct Pixel {
+        float c1;
+        float c2;
+        float c3;
+        float alpha;
+    };
+
+    static ALWAYS_INLINE float scaleToFloat(float value) {
+        return value;
+    }
+
+    static ALWAYS_INLINE float scaleFromFloat(float value) {
+        return value;
+    }
+
+    template<bool aligned>
+    static ALWAYS_INLINE void fetch(const quint8 *data,
+                                    Vc::float_v &c1, Vc::float_v &c2, Vc::float_v &c3,
+                                    Vc::float_v &alpha) {
+
+        const Vc::float_v::IndexType indexes(Vc::IndexesFromZero);
+        Vc::InterleavedMemoryWrapper<Pixel, Vc::float_v> pixels(reinterpret_cast<Pixel*>(const_cast<quint8*>(data)));
+        (c1, c2, c3, alpha) = pixels[indexes];
+    }
+
+    static ALWAYS_INLINE void write(quint8 *data,
+                                    Vc::float_v::AsArg c1, Vc::float_v::AsArg c2, Vc::float_v::AsArg c3,
+                                    Vc::float_v::AsArg alpha) {
+
+        const Vc::float_v::IndexType indexes(Vc::IndexesFromZero);
+        Vc::InterleavedMemoryWrapper<Pixel, Vc::float_v> pixels(reinterpret_cast<Pixel*>(data));
+        pixels[indexes] = (c1, c2, c3, alpha);
+    }
+};
+
+
+/**
+ * A vectorized version of KoCompositeOpGenericSC for C1_C2_C3_A
+ * colorspaces. \p BlendFunc is one of the KoStreamedBlend* functions.
+ */
+template<typename channels_type, class BlendFunc, bool alphaLocked, bool allChannelsFlag>
+struct GenericSCCompositor {
+    struct OptionalParams {
+        OptionalParams(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    static const bool clampResult = std::numeric_limits<channels_type>::is_integer;
+    static const qint32 alpha_pos = 3;
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        typedef KoStreamedPixelIO<channels_type, _impl> PixelIO;
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+        Vc::float_v src_alpha;
+
+        PixelIO::template fetch<src_aligned>(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= Vc::float_v(opacity);
+
+        if (haveMask) {
+            const Vc::float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        const Vc::float_v zeroValue(Vc::Zero);
+        const Vc::float_v oneValue(Vc::One);
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+        Vc::float_v dst_alpha;
+
+        PixelIO::template fetch<true>(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        const Vc::float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+
+        /**
+         * The pixels with new_alpha == 0 keep their colors, the same
+         * way the scalar version does
+         */
+        const Vc::float_m emptyPixels = new_alpha == zeroValue;
+        Vc::float_v new_alpha_rec = oneValue / new_alpha;
+        new_alpha_rec.setZero(emptyPixels);
+
+        const Vc::float_v srcOnly = src_alpha * (oneValue - dst_alpha) * new_alpha_rec;
+        const Vc::float_v dstOnly = dst_alpha * (oneValue - src_alpha) * new_alpha_rec;
+        const Vc::float_v both = src_alpha * dst_alpha * new_alpha_rec;
+
+        const Vc::float_v result_c1 =
+            src_c1 * srcOnly + dst_c1 * dstOnly +
+            BlendFunc::template apply<_impl, clampResult>(src_c1, dst_c1) * both;
+
+        const Vc::float_v result_c2 =
+            src_c2 * srcOnly + dst_c2 * dstOnly +
+            BlendFunc::template apply<_impl, clampResult>(src_c2, dst_c2) * both;
+
+        const Vc::float_v result_c3 =
+            src_c3 * srcOnly + dst_c3 * dstOnly +
+            BlendFunc::template apply<_impl, clampResult>(src_c3, dst_c3) * both;
+
+        PixelIO::write(dst,
+                       Vc::iif(emptyPixels, dst_c1, result_c1),
+                       Vc::iif(emptyPixels, dst_c2, result_c2),
+                       Vc::iif(emptyPixels, dst_c3, result_c3),
+                       new_alpha);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        typedef KoStreamedPixelIO<channels_type, _impl> PixelIO;
+
+        const channels_type *s = reinterpret_cast<const channels_type*>(src);
+        channels_type *d = reinterpret_cast<channels_type*>(dst);
+
+        float srcAlpha = PixelIO::scaleToFloat(s[alpha_pos]) * opacity;
+
+        if (haveMask) {
+            srcAlpha *= float(*mask) * (1.0f / 255.0f);
+        }
+
+        const float dstAlpha = PixelIO::scaleToFloat(d[alpha_pos]);
+
+        if (!allChannelsFlag && dstAlpha == 0.0f) {
+            memset(d, 0, 4 * sizeof(channels_type));
+        }
+
+        if (srcAlpha == 0.0f) return;
+
+        const QBitArray &channelFlags = oparams.channelFlags;
+
+        if (alphaLocked) {
+            if (dstAlpha != 0.0f) {
+                for (int i = 0; i < alpha_pos; i++) {
+                    if (allChannelsFlag || channelFlags.testBit(i)) {
+                        const float srcC = PixelIO::scaleToFloat(s[i]);
+                        const float dstC = PixelIO::scaleToFloat(d[i]);
+                        const float result = BlendFunc::template apply<_impl, clampResult>(srcC, dstC);
+
+                        d[i] = PixelIO::scaleFromFloat(dstC + (result - dstC) * srcAlpha);
+                    }
+                }
+            }
+        } else {
+            const float newAlpha = srcAlpha + dstAlpha - srcAlpha * dstAlpha;
+
+            if (newAlpha != 0.0f) {
+                const float newAlphaRec = 1.0f / newAlpha;
+                const float srcOnly = srcAlpha * (1.0f - dstAlpha) * newAlphaRec;
+                const float dstOnly = dstAlpha * (1.0f - srcAlpha) * newAlphaRec;
+                const float both = srcAlpha * dstAlpha * newAlphaRec;
+
+                for (int i = 0; i < alpha_pos; i++) {
+                    if (allChannelsFlag || channelFlags.testBit(i)) {
+                        const float srcC = PixelIO::scaleToFloat(s[i]);
+                        const float dstC = PixelIO::scaleToFloat(d[i]);
+                        const float result = BlendFunc::template apply<_impl, clampResult>(srcC, dstC);
+
+                        d[i] = PixelIO::scaleFromFloat(srcC * srcOnly + dstC * dstOnly + result * both);
+                    }
+                }
+            }
+
+            d[alpha_pos] = PixelIO::scaleFromFloat(newAlpha);
+        }
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in
+ * colorspaces with alpha channel placed at the end of the pixel:
+ * C1_C2_C3_A. The channels may be 8-bit, 16-bit integers or 32-bit
+ * floats.
+ */
+template<Vc::Implementation _impl, typename channels_type, class BlendFunc>
+class KoOptimizedCompositeOpGeneric : public KoCompositeOp
+{
+    static const int pixelSize = 4 * sizeof(channels_type);
+
+public:
+    KoOptimizedCompositeOpGeneric(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : KoCompositeOp(cs, id, description, category) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite<haveMask, false, GenericSCCompositor<channels_type, BlendFunc, false, true>, pixelSize>(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor<channels_type, BlendFunc, true, true>, pixelSize>(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor<channels_type, BlendFunc, false, false>, pixelSize>(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor<channels_type, BlendFunc, true, false>, pixelSize>(params);
+            }
+        }
+    }
+};
+
+/**
+ * Creates an optimized composite op for the separable blending mode
+ * \p param.id. Returns null if the mode has no vectorized version.
+ */
+template<Vc::Implementation _impl, typename channels_type>
+struct KoOptimizedCompositeOpGenericCreator
+{
+    typedef const KoOptimizedGenericOpParams& ParamType;
+
+    template<class BlendFunc>
+    static KoCompositeOp* create(ParamType param) {
+        return new KoOptimizedCompositeOpGeneric<_impl, channels_type, BlendFunc>(param.colorSpace, param.id, param.description, param.category);
+    }
+
+    static KoCompositeOp* create(ParamType param) {
+        const QString &id = param.id;
+
+        if (id == COMPOSITE_MULT) {
+            return create<KoStreamedBlendMultiply>(param);
+        } else if (id == COMPOSITE_SCREEN) {
+            return create<KoStreamedBlendScreen>(param);
+        } else if (id == COMPOSITE_OVERLAY) {
+            return create<KoStreamedBlendOverlay>(param);
+        } else if (id == COMPOSITE_HARD_LIGHT) {
+            return create<KoStreamedBlendHardLight>(param);
+        } else if (id == COMPOSITE_DODGE) {
+            return create<KoStreamedBlendColorDodge>(param);
+        } else if (id == COMPOSITE_BURN) {
+            return create<KoStreamedBlendColorBurn>(param);
+        } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+            return create<KoStreamedBlendAddition>(param);
+        } else if (id == COMPOSITE_SUBTRACT) {
+            return create<KoStreamedBlendSubtract>(param);
+        } else if (id == COMPOSITE_LINEAR_BURN) {
+            return create<KoStreamedBlendLinearBurn>(param);
+        } else if (id == COMPOSITE_DIFF) {
+            return create<KoStreamedBlendDifference>(param);
+        } else if (id == COMPOSITE_EXCLUSION) {
+            return create<KoStreamedBlendExclusion>(param);
+        } else if (id == COMPOSITE_DARKEN) {
+            return create<KoStreamedBlendDarken>(param);
+        } else if (id == COMPOSITE_LIGHTEN) {
+            return create<KoStreamedBlendLighten>(param);
+        }
+
+        return 0;
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
@@ -0,0 +1,252 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+#define KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+
+template<typename channels_type, typename pixel_type, bool alphaLocked, bool allChannelsFlag>
+struct OverCompositor64 {
+    struct OptionalParams {
+        OptionalParams(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    // \see docs in AlphaDarkenCompositor32
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        Vc::float_v src_alpha;
+        Vc::float_v dst_alpha;
+
+        src_alpha = KoStreamedMath<_impl>::fetch_alpha_64(src);
+
+        bool haveOpacity = opacity != 1.0;
+        Vc::float_v opacity_norm_vec(opacity);
+
+        Vc::float_v uint16Max((float)65535.0);
+        Vc::float_v uint16MaxRec1((float)1.0 / 65535.0);
+        Vc::float_v uint8MaxRec1((float)1.0 / 255.0);
+        Vc::float_v zeroValue(Vc::Zero);
+        Vc::float_v oneValue(Vc::One);
+
+        src_alpha *= opacity_norm_vec;
+
+        if (haveMask) {
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        dst_alpha = KoStreamedMath<_impl>::fetch_alpha_64(dst);
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+
+        KoStreamedMath<_impl>::fetch_colors_64(src, src_c1, src_c2, src_c3);
+        Vc::float_v src_blend;
+        Vc::float_v new_alpha;
+
+        if ((dst_alpha == uint16Max).isFull()) {
+            new_alpha = dst_alpha;
+            src_blend = src_alpha * uint16MaxRec1;
+        } else if ((dst_alpha == zeroValue).isFull()) {
+            new_alpha = src_alpha;
+            src_blend = oneValue;
+        } else {
+            /**
+             * The value of new_alpha can have *some* zero values,
+             * which will result in NaN values while division.
+             */
+            new_alpha = dst_alpha + (uint16Max - dst_alpha) * src_alpha * uint16MaxRec1;
+            Vc::float_m mask = (new_alpha == zeroValue);
+            src_blend = src_alpha / new_alpha;
+            src_blend.setZero(mask);
+        }
+
+        if (!(src_blend == oneValue).isFull()) {
+            KoStreamedMath<_impl>::fetch_colors_64(dst, dst_c1, dst_c2, dst_c3);
+
+            dst_c1 = src_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2 = src_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3 = src_blend * (src_c3 - dst_c3) + dst_c3;
+
+        } else {
+            if (!haveMask && !haveOpacity) {
+                memcpy(dst, src, 8 * Vc::float_v::size());
+                return;
+            } else {
+                // opacity has changed the alpha of the source,
+                // so we can't just memcpy the bytes
+                dst_c1 = src_c1;
+                dst_c2 = src_c2;
+                dst_c3 = src_c3;
+            }
+        }
+
+        KoStreamedMath<_impl>::write_channels_64(dst, new_alpha, dst_c1, dst_c2, dst_c3);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *srcPtr, quint8 *dstPtr, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const channels_type *src = reinterpret_cast<const channels_type*>(srcPtr);
+        channels_type *dst = reinterpret_cast<channels_type*>(dstPtr);
+
+        const float uint8Rec1 = 1.0 / 255.0;
+        const float uint16Rec1 = 1.0 / 65535.0;
+        const float uint16Max = 65535.0;
+
+        float srcAlpha = src[alpha_pos];
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha != 0.0) {
+
+            float dstAlpha = dst[alpha_pos];
+            float srcBlendNorm;
+
+            if (dstAlpha == uint16Max) {
+                srcBlendNorm = srcAlpha * uint16Rec1;
+            } else if (dstAlpha == 0.0) {
+                dstAlpha = srcAlpha;
+                srcBlendNorm = 1.0;
+
+                if (!allChannelsFlag) {
+                    pixel_type *d = reinterpret_cast<pixel_type*>(dst);
+                    *d = 0; // dstAlpha is already null
+                }
+            } else {
+                dstAlpha += (uint16Max - dstAlpha) * srcAlpha * uint16Rec1;
+                srcBlendNorm = srcAlpha / dstAlpha;
+            }
+
+            if(allChannelsFlag) {
+                if (srcBlendNorm == 1.0) {
+                    if (!alphaLocked) {
+                        const pixel_type *s = reinterpret_cast<const pixel_type*>(src);
+                        pixel_type *d = reinterpret_cast<pixel_type*>(dst);
+                        *d = *s;
+                    } else {
+                        dst[0] = src[0];
+                        dst[1] = src[1];
+                        dst[2] = src[2];
+                    }
+                } else if (srcBlendNorm != 0.0){
+                    dst[0] = KoStreamedMath<_impl>::lerp_mixed_u16_float(dst[0], src[0], srcBlendNorm);
+                    dst[1] = KoStreamedMath<_impl>::lerp_mixed_u16_float(dst[1], src[1], srcBlendNorm);
+                    dst[2] = KoStreamedMath<_impl>::lerp_mixed_u16_float(dst[2], src[2], srcBlendNorm);
+                }
+            } else {
+                const QBitArray &channelFlags = oparams.channelFlags;
+
+                if (srcBlendNorm == 1.0) {
+                    if(channelFlags.at(0)) dst[0] = src[0];
+                    if(channelFlags.at(1)) dst[1] = src[1];
+                    if(channelFlags.at(2)) dst[2] = src[2];
+                } else if (srcBlendNorm != 0.0) {
+                    if(channelFlags.at(0)) dst[0] = KoStreamedMath<_impl>::lerp_mixed_u16_float(dst[0], src[0], srcBlendNorm);
+                    if(channelFlags.at(1)) dst[1] = KoStreamedMath<_impl>::lerp_mixed_u16_float(dst[1], src[1], srcBlendNorm);
+                    if(channelFlags.at(2)) dst[2] = KoStreamedMath<_impl>::lerp_mixed_u16_float(dst[2], src[2], srcBlendNorm);
+                }
+            }
+
+            if (!alphaLocked) {
+                dst[alpha_pos] = KoStreamedMath<_impl>::round_float_to_u16(dstAlpha);
+            }
+        }
+    }
+};
+
+/**
+ * An optimized version of a composite op for the use in 8 byte
+ * colorspaces with alpha channel placed at the last word of
+ * the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpOver64(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_OVER, i18n("Normal"), KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor64<quint16, quint64, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor64<quint16, quint64, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor64<quint16, quint64, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor64<quint16, quint64, true, false> >(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPOVER64_H_
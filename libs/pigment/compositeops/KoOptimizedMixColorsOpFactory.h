@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOPFACTORY_H
+#define KOOPTIMIZEDMIXCOLORSOPFACTORY_H
+
+#include "kritapigment_export.h"
+
+class KoMixColorsOp;
+class KoConvolutionOp;
+
+/**
+ * Creates the vectorized versions of KoMixColorsOp and KoConvolutionOp
+ * for the colorspaces with four 8-bit, 16-bit or 32-bit float channels
+ * and alpha in the last one (RGBA, Lab, XYZ, etc.). The ops only care
+ * about the position of alpha, so the same op fits all of them.
+ *
+ * \return the op or null if the vectorization is not available on
+ *         this CPU. Then KoMixColorsOpImpl or KoConvolutionOpImpl
+ *         should be used.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedMixColorsOpFactory
+{
+public:
+    static KoMixColorsOp* createMixColorsOp32();
+    static KoMixColorsOp* createMixColorsOp64();
+    static KoMixColorsOp* createMixColorsOp128();
+
+    static KoConvolutionOp* createConvolutionOp32();
+    static KoConvolutionOp* createConvolutionOp64();
+    static KoConvolutionOp* createConvolutionOp128();
+};
+
+#endif /* KOOPTIMIZEDMIXCOLORSOPFACTORY_H */
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOPIMPL_H
+#define KOOPTIMIZEDMIXCOLORSOPIMPL_H
+
+#include "KoVcMultiArchBuildSupport.h"
+
+#include "KoMixColorsOpImpl.h"
+#include "KoConvolutionOpImpl.h"
+
+/**
+ * Loads all four channels of a pixel into one vector.
+ *
+ * The vector is made of doubles: they are wide enough to keep the
+ * integer sums of the 8- and 16-bit ops exact, so the optimized ops
+ * give exactly the same results as the generic ones.
+ */
+template<Vc::Implementation _impl, typename channels_type>
+inline Vc::SimdArray<double, 4> loadPixelAsDoubles(const channels_type *pixel)
+{
+    return Vc::SimdArray<double, 4>::generate([pixel] (int i) { return double(pixel[i]); });
+}
+
+/**
+ * Vectorized KoMixColorsOp for the colorspaces with four channels
+ * and alpha in the last one: all the channels of a pixel are
+ * accumulated in one SIMD operation.
+ */
+template<Vc::Implementation _impl, class _CSTrait>
+class KoOptimizedMixColorsOpImpl : public KoMixColorsOpImpl<_CSTrait>
+{
+    typedef KoMixColorsOpImpl<_CSTrait> BaseClass;
+    typedef typename _CSTrait::channels_type channels_type;
+    typedef typename BaseClass::compositetype compositetype;
+    typedef Vc::SimdArray<double, 4> pixel_v;
+
+    Q_STATIC_ASSERT(_CSTrait::channels_nb == 4 && _CSTrait::alpha_pos == 3);
+
+public:
+    virtual void mixColors(const quint8 * const* colors, const qint16 *weights, quint32 nColors, quint8 *dst) const {
+        mixColorsImpl(typename BaseClass::ArrayOfPointers(colors), weights, nColors, dst);
+    }
+
+    virtual void mixColors(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst) const {
+        mixColorsImpl(typename BaseClass::PointerToArray(colors, _CSTrait::pixelSize), weights, nColors, dst);
+    }
+
+    virtual void mixColorsRow(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, quint32 nPixels) const {
+        const int groupSize = nColors * _CSTrait::pixelSize;
+
+        for (quint32 i = 0; i < nPixels; i++) {
+            mixColorsImpl(typename BaseClass::PointerToArray(colors, _CSTrait::pixelSize), weights, nColors, dst);
+            colors += groupSize;
+            dst += _CSTrait::pixelSize;
+        }
+    }
+
+private:
+    template<class AbstractSource>
+    void mixColorsImpl(AbstractSource source, const qint16 *weights, quint32 nColors, quint8 *dst) const {
+        pixel_v totals(Vc::Zero);
+        double totalAlpha = 0;
+
+        while (nColors--) {
+            const channels_type *color = _CSTrait::nativeArray(source.getPixel());
+            const double alphaTimesWeight = compositetype(color[_CSTrait::alpha_pos]) * *weights;
+
+            // the alpha lane is accumulated as well, but never used
+            totals += loadPixelAsDoubles<_impl>(color) * pixel_v(alphaTimesWeight);
+            totalAlpha += alphaTimesWeight;
+
+            source.nextPixel();
+            weights++;
+        }
+
+        compositetype totalsArray[_CSTrait::channels_nb];
+        for (int i = 0; i < (int)_CSTrait::channels_nb; i++) {
+            totalsArray[i] = compositetype(totals[i]);
+        }
+
+        BaseClass::writeMixedPixel(totalsArray, compositetype(totalAlpha), dst);
+    }
+};
+
+/**
+ * Vectorized KoConvolutionOp for the colorspaces with four channels
+ * and alpha in the last one.
+ */
+template<Vc::Implementation _impl, class _CSTrait>
+class KoOptimizedConvolutionOpImpl : public KoConvolutionOpImpl<_CSTrait>
+{
+    typedef KoConvolutionOpImpl<_CSTrait> BaseClass;
+    typedef Vc::SimdArray<double, 4> pixel_v;
+
+    Q_STATIC_ASSERT(_CSTrait::channels_nb == 4 && _CSTrait::alpha_pos == 3);
+
+public:
+    virtual void convolveColors(const quint8* const* colors, const qreal* kernelValues, quint8 *dst, qreal factor, qreal offset, qint32 nPixels, const QBitArray & channelFlags) const {
+        pixel_v totals(Vc::Zero);
+
+        qreal totalWeight = 0;
+        qreal totalWeightTransparent = 0;
+
+        for (; nPixels--; colors++, kernelValues++) {
+            const qreal weight = *kernelValues;
+
+            if (weight != 0) {
+                if (_CSTrait::opacityU8(*colors) == 0) {
+                    totalWeightTransparent += weight;
+                } else {
+                    totals += loadPixelAsDoubles<_impl>(_CSTrait::nativeArray(*colors)) * pixel_v(weight);
+                }
+                totalWeight += weight;
+            }
+        }
+
+        qreal totalsArray[_CSTrait::channels_nb];
+        for (int i = 0; i < (int)_CSTrait::channels_nb; i++) {
+            totalsArray[i] = totals[i];
+        }
+
+        BaseClass::writeConvolvedPixel(totalsArray, totalWeight, totalWeightTransparent, dst, factor, offset, channelFlags);
+    }
+};
+
+#endif /* KOOPTIMIZEDMIXCOLORSOPIMPL_H */
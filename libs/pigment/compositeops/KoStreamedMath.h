@@ -96,6 +96,12 @@ template<bool useMask, bool useFlow, class Compositor>
     genericComposite_novector<useMask, useFlow, Compositor, 4>(params);
 }
 
+template<bool useMask, bool useFlow, class Compositor>
+    static void genericComposite64_novector(const KoCompositeOp::ParameterInfo& params)
+{
+    genericComposite_novector<useMask, useFlow, Compositor, 8>(params);
+}
+
 template<bool useMask, bool useFlow, class Compositor>
     static void genericComposite128_novector(const KoCompositeOp::ParameterInfo& params)
 {
@@ -110,6 +116,14 @@ static inline quint8 lerp_mixed_u8_float(quint8 a, quint8 b, float alpha) {
     return round_float_to_uint(qint16(b - a) * alpha + a);
 }
 
+static inline quint16 round_float_to_u16(float value) {
+    return quint16(value + float(0.5));
+}
+
+static inline quint16 lerp_mixed_u16_float(quint16 a, quint16 b, float alpha) {
+    return round_float_to_u16(qint32(b - a) * alpha + a);
+}
+
 /**
  * Get a vector containing first Vc::float_v::size() values of mask.
  * Each source mask element is considered to be a 8-bit integer
@@ -208,6 +222,70 @@ static inline void write_channels_32(quint8 *data,
     (v1 | v3).store((quint32*)data, Vc::Aligned);
 }
 
+/**
+ * Get an alpha values from Vc::float_v::size() pixels 64-bit each
+ * (4 channels, 16 bit per channel).  The alpha value is considered
+ * to be stored in the most significant word of the pixel.
+ *
+ * The pixels are gathered as pairs of 32-bit words, so unlike
+ * fetch_alpha_32() the \p data pointer needs no vector alignment.
+ */
+static inline Vc::float_v fetch_alpha_64(const quint8 *data) {
+    const quint32 *words = reinterpret_cast<const quint32*>(data);
+    const int_v indexes = int_v::IndexesFromZero() * 2 + 1;
+
+    uint_v data_i(words, indexes);
+    return Vc::float_v(int_v(data_i >> 16));
+}
+
+/**
+ * Get color values from Vc::float_v::size() pixels 64-bit each
+ * (4 channels, 16 bit per channel).  The color data is considered
+ * to be stored in the 3 least significant words of the pixel.
+ */
+static inline void fetch_colors_64(const quint8 *data,
+                                   Vc::float_v &c1,
+                                   Vc::float_v &c2,
+                                   Vc::float_v &c3) {
+    const quint32 *words = reinterpret_cast<const quint32*>(data);
+    const int_v indexes = int_v::IndexesFromZero() * 2;
+
+    uint_v low(words, indexes);
+    uint_v high(words, indexes + 1);
+
+    const quint32 lowWordMask = 0xFFFF;
+    uint_v mask(lowWordMask);
+
+    c1 = Vc::float_v(int_v(low & mask));
+    c2 = Vc::float_v(int_v(low >> 16));
+    c3 = Vc::float_v(int_v(high & mask));
+}
+
+/**
+ * Pack color and alpha values to Vc::float_v::size() pixels 64-bit each
+ * (4 channels, 16 bit per channel).  The layout is the same as the one
+ * read by fetch_colors_64() and fetch_alpha_64().
+ */
+static inline void write_channels_64(quint8 *data,
+                                     Vc::float_v::AsArg alpha,
+                                     Vc::float_v::AsArg c1,
+                                     Vc::float_v::AsArg c2,
+                                     Vc::float_v::AsArg c3) {
+    quint32 *words = reinterpret_cast<quint32*>(data);
+    const int_v indexes = int_v::IndexesFromZero() * 2;
+
+    const quint32 lowWordMask = 0xFFFF;
+    uint_v mask(lowWordMask);
+
+    uint_v v1 = uint_v(int_v(Vc::round(c1))) & mask;
+    uint_v v2 = (uint_v(int_v(Vc::round(c2))) & mask) << 16;
+    uint_v v3 = uint_v(int_v(Vc::round(c3))) & mask;
+    uint_v v4 = uint_v(int_v(Vc::round(alpha))) << 16;
+
+    (v1 | v2).scatter(words, indexes);
+    (v3 | v4).scatter(words, indexes + 1);
+}
+
 /**
  * Composes src pixels into dst pixles. Is optimized for 32-bit-per-pixel
  * colorspaces. Uses \p Compositor strategy parameter for doing actual
@@ -375,6 +453,12 @@ template<bool useMask, bool useFlow, class Compositor>
     genericComposite<useMask, useFlow, Compositor, 4>(params);
 }
 
+template<bool useMask, bool useFlow, class Compositor>
+    static void genericComposite64(const KoCompositeOp::ParameterInfo& params)
+{
+    genericComposite<useMask, useFlow, Compositor, 8>(params);
+}
+
 template<bool useMask, bool useFlow, class Compositor>
     static void genericComposite128(const KoCompositeOp::ParameterInfo& params)
 {
@@ -398,6 +482,13 @@ ALWAYS_INLINE void clearPixel<4>(quint8* dst)
     *d = 0;
 }
 
+template<>
+ALWAYS_INLINE void clearPixel<8>(quint8* dst)
+{
+    quint64 *d = reinterpret_cast<quint64*>(dst);
+    *d = 0;
+}
+
 template<>
 ALWAYS_INLINE void clearPixel<16>(quint8* dst)
 {
@@ -420,6 +511,14 @@ ALWAYS_INLINE void copyPixel<4>(const quint8 *src, quint8* dst)
     *d = *s;
 }
 
+template<>
+ALWAYS_INLINE void copyPixel<8>(const quint8 *src, quint8* dst)
+{
+    const quint64 *s = reinterpret_cast<const quint64*>(src);
+    quint64 *d = reinterpret_cast<quint64*>(dst);
+    *d = *s;
+}
+
 template<>
 ALWAYS_INLINE void copyPixel<16>(const quint8 *src, quint8* dst)
 {
@@ -20,9 +20,13 @@
 #include "TestConvolutionOpImpl.h"
 
 #include <QTest>
+#include <QVector>
 
 #include "../KoColorSpaceAbstract.h"
 #include "../KoColorSpaceTraits.h"
+#include "../KoBgrColorSpaceTraits.h"
+#include "../KoRgbColorSpaceTraits.h"
+#include "../compositeops/KoOptimizedMixColorsOpFactory.h"
 #include "../DebugPigment.h"
 
 void TestConvolutionOpImpl::testConvolutionOpImpl()
@@ -218,4 +222,64 @@ void TestConvolutionOpImpl::testOneFullyTransparent()
 }
 
 
+template <class Traits>
+void compareConvolutionOps(const KoConvolutionOp *optimizedOp)
+{
+    if (!optimizedOp) {
+        qWarning() << "No optimized convolution op for the current CPU, skipping";
+        return;
+    }
+
+    typedef typename Traits::channels_type channels_type;
+
+    const KoConvolutionOpImpl<Traits> op;
+    const int numColors = 9;
+
+    QVector<channels_type> pixels(numColors * Traits::channels_nb);
+    quint32 seed = 13;
+    for (int i = 0; i < pixels.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = KoColorSpaceMaths<qreal, channels_type>::scaleToA(qreal((seed >> 8) & 0xffff) / 0xffff);
+    }
+    pixels[3 * Traits::channels_nb + Traits::alpha_pos] = KoColorSpaceMathsTraits<channels_type>::zeroValue;
+
+    const quint8 *colors[numColors];
+    for (int i = 0; i < numColors; i++) {
+        colors[i] = reinterpret_cast<const quint8*>(pixels.constData() + i * Traits::channels_nb);
+    }
+
+    const qreal kernelValues[numColors] = {1, 2, 1, 2, 4, 2, 1, 2, 1};
+    const qreal sharpenValues[numColors] = {0, -1, 0, -1, 5, -1, 0, -1, 0};
+
+    QBitArray noAlphaFlags(Traits::channels_nb, true);
+    noAlphaFlags.clearBit(Traits::alpha_pos);
+
+    quint8 expected[Traits::pixelSize];
+    quint8 result[Traits::pixelSize];
+
+    op.convolveColors(colors, kernelValues, expected, 16, 0, numColors, QBitArray());
+    optimizedOp->convolveColors(colors, kernelValues, result, 16, 0, numColors, QBitArray());
+    QVERIFY(!memcmp(result, expected, Traits::pixelSize));
+
+    op.convolveColors(colors, sharpenValues, expected, 1, 0, numColors, QBitArray());
+    optimizedOp->convolveColors(colors, sharpenValues, result, 1, 0, numColors, QBitArray());
+    QVERIFY(!memcmp(result, expected, Traits::pixelSize));
+
+    memset(expected, 0, Traits::pixelSize);
+    memset(result, 0, Traits::pixelSize);
+    op.convolveColors(colors, kernelValues, expected, 16, 0.1, numColors, noAlphaFlags);
+    optimizedOp->convolveColors(colors, kernelValues, result, 16, 0.1, numColors, noAlphaFlags);
+    QVERIFY(!memcmp(result, expected, Traits::pixelSize));
+
+    delete optimizedOp;
+}
+
+void TestConvolutionOpImpl::testOptimizedConvolutionOp()
+{
+    compareConvolutionOps<KoBgrU8Traits>(KoOptimizedMixColorsOpFactory::createConvolutionOp32());
+    compareConvolutionOps<KoBgrU16Traits>(KoOptimizedMixColorsOpFactory::createConvolutionOp64());
+    compareConvolutionOps<KoRgbF32Traits>(KoOptimizedMixColorsOpFactory::createConvolutionOp128());
+}
+
+
 QTEST_GUILESS_MAIN(TestConvolutionOpImpl)
@@ -29,6 +29,7 @@ private Q_SLOTS:
     void testConvolutionOpImpl();
     void testOneSemiTransparent();
     void testOneFullyTransparent();
+    void testOptimizedConvolutionOp();
 };
 
 #endif
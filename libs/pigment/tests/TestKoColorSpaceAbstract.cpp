@@ -2,10 +2,16 @@
 
 #include "KoColorSpaceAbstract.h"
 #include "KoColorSpaceTraits.h"
+#include "KoBgrColorSpaceTraits.h"
+#include "KoRgbColorSpaceTraits.h"
+#include "KoOptimizedMixColorsOpFactory.h"
+#include "KoColorDepthConversion.h"
 
 #include <cfloat>
 
 #include <QTest>
+#include <QVector>
+#include <QDebug>
 
 template <class T>
 T mixOpExpectedAlpha(T alpha1, T alpha2, const qint16 *weights)
@@ -386,4 +392,209 @@ void TestKoColorSpaceAbstract::testMixColorsOpU8NoAlphaLinear()
 }
 
 
+template <class Traits>
+void fillRandomPixels(quint8 *pixels, int numPixels, quint32 seed)
+{
+    typedef typename Traits::channels_type channels_type;
+    channels_type *p = reinterpret_cast<channels_type*>(pixels);
+
+    for (int i = 0; i < numPixels * int(Traits::channels_nb); i++) {
+        seed = seed * 1103515245 + 12345;
+        const qreal value = qreal((seed >> 8) & 0xffff) / 0xffff;
+        p[i] = KoColorSpaceMaths<qreal, channels_type>::scaleToA(value);
+    }
+
+    // add a few fully transparent pixels
+    for (int i = 0; i < numPixels; i += 7) {
+        p[i * Traits::channels_nb + Traits::alpha_pos] = KoColorSpaceMathsTraits<channels_type>::zeroValue;
+    }
+}
+
+template <class Traits>
+void compareMixColorsOps(const KoMixColorsOp *optimizedOp)
+{
+    if (!optimizedOp) {
+        qWarning() << "No optimized mixColors op for the current CPU, skipping";
+        return;
+    }
+
+    const KoMixColorsOpImpl<Traits> op;
+
+    const int numColors = 9;
+    const int numGroups = 17;
+    const int pixelSize = Traits::pixelSize;
+
+    QVector<quint8> pixels(numColors * numGroups * pixelSize);
+    fillRandomPixels<Traits>(pixels.data(), numColors * numGroups, 17);
+
+    QVector<qint16> weights(numColors);
+    int weightsLeft = 255;
+    for (int i = 0; i < numColors - 1; i++) {
+        weights[i] = (i * 37 + 11) % 50;
+        weightsLeft -= weights[i];
+    }
+    weights[numColors - 1] = weightsLeft;
+
+    QVector<quint8> expected(numGroups * pixelSize);
+    QVector<quint8> result(numGroups * pixelSize);
+
+    for (int g = 0; g < numGroups; g++) {
+        const quint8 *colors = pixels.constData() + g * numColors * pixelSize;
+
+        const quint8 *pixelPtrs[numColors];
+        for (int i = 0; i < numColors; i++) {
+            pixelPtrs[i] = colors + i * pixelSize;
+        }
+
+        quint8 *expectedPixel = expected.data() + g * pixelSize;
+        op.mixColors(colors, weights.constData(), numColors, expectedPixel);
+
+        QVector<quint8> resultPixel(pixelSize);
+        optimizedOp->mixColors(colors, weights.constData(), numColors, resultPixel.data());
+        QVERIFY(!memcmp(resultPixel.constData(), expectedPixel, pixelSize));
+
+        optimizedOp->mixColors(pixelPtrs, weights.constData(), numColors, resultPixel.data());
+        QVERIFY(!memcmp(resultPixel.constData(), expectedPixel, pixelSize));
+    }
+
+    optimizedOp->mixColorsRow(pixels.constData(), weights.constData(), numColors, result.data(), numGroups);
+    QVERIFY(!memcmp(result.constData(), expected.constData(), numGroups * pixelSize));
+
+    op.mixColorsRow(pixels.constData(), weights.constData(), numColors, result.data(), numGroups);
+    QVERIFY(!memcmp(result.constData(), expected.constData(), numGroups * pixelSize));
+
+    delete optimizedOp;
+}
+
+void TestKoColorSpaceAbstract::testOptimizedMixColorsOp()
+{
+    compareMixColorsOps<KoBgrU8Traits>(KoOptimizedMixColorsOpFactory::createMixColorsOp32());
+    compareMixColorsOps<KoBgrU16Traits>(KoOptimizedMixColorsOpFactory::createMixColorsOp64());
+    compareMixColorsOps<KoRgbF32Traits>(KoOptimizedMixColorsOpFactory::createMixColorsOp128());
+}
+
+
+template <class Traits>
+void compareSpanAlphaOps()
+{
+    typedef typename Traits::channels_type channels_type;
+
+    const int numPixels = 37;
+    const int pixelSize = Traits::pixelSize;
+
+    QVector<quint8> pixels(numPixels * pixelSize);
+    fillRandomPixels<Traits>(pixels.data(), numPixels, 23);
+
+    QVector<quint8> mask(numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        mask[i] = (i * 53 + 7) % 256;
+    }
+
+    QVector<quint8> alpha(numPixels);
+    Traits::copyOpacityU8(pixels.constData(), alpha.data(), numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        QCOMPARE(alpha[i], Traits::opacityU8(pixels.constData() + i * pixelSize));
+    }
+
+    QVector<quint8> spanResult = pixels;
+    QVector<quint8> pixelResult = pixels;
+
+    Traits::applyAlphaU8Mask(spanResult.data(), mask.constData(), numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        Traits::applyAlphaU8Mask(pixelResult.data() + i * pixelSize, mask.constData() + i, 1);
+    }
+    QVERIFY(spanResult == pixelResult);
+
+    Traits::applyInverseAlphaU8Mask(spanResult.data(), mask.constData(), numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        Traits::applyInverseAlphaU8Mask(pixelResult.data() + i * pixelSize, mask.constData() + i, 1);
+    }
+    QVERIFY(spanResult == pixelResult);
+
+    Traits::multiplyAlpha(spanResult.data(), 123, numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        Traits::multiplyAlpha(pixelResult.data() + i * pixelSize, 123, 1);
+    }
+    QVERIFY(spanResult == pixelResult);
+
+    Traits::setOpacity(spanResult.data(), quint8(77), numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        QCOMPARE(Traits::nativeArray(spanResult.data() + i * pixelSize)[Traits::alpha_pos],
+                 KoColorSpaceMaths<quint8, channels_type>::scaleToA(77));
+    }
+}
+
+void TestKoColorSpaceAbstract::testSpanAlphaOps()
+{
+    compareSpanAlphaOps<KoBgrU8Traits>();
+    compareSpanAlphaOps<KoBgrU16Traits>();
+    compareSpanAlphaOps<KoRgbF32Traits>();
+}
+
+void TestKoColorSpaceAbstract::testDepthConversion()
+{
+    using namespace KoColorDepthConversion;
+
+    // the threshold matrix has every level exactly once
+    QVector<bool> levels(64, false);
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            const int level = int(orderedDitherThreshold(x, y) * 64);
+            QVERIFY(!levels[level]);
+            levels[level] = true;
+        }
+    }
+
+    // plain scaling matches the per-channel one
+    QVector<quint16> src16(65536);
+    QVector<quint8> dst8(65536);
+    for (int i = 0; i < src16.size(); i++) {
+        src16[i] = i;
+    }
+    scaleChannels(src16.constData(), dst8.data(), src16.size());
+    for (int i = 0; i < src16.size(); i++) {
+        QCOMPARE(dst8[i], KoColorSpaceMaths<quint16, quint8>::scaleToA(src16[i]));
+    }
+
+    typedef KoBgrU16Traits Traits;
+    const int numPixels = 64;
+    quint16 src[numPixels * Traits::channels_nb];
+    quint8 dst[numPixels * Traits::channels_nb];
+
+    // the values representable in 8 bits are not changed
+    for (int value = 0; value < 256; value++) {
+        for (int i = 0; i < numPixels * int(Traits::channels_nb); i++) {
+            src[i] = UINT8_TO_UINT16(value);
+        }
+
+        for (int y = 0; y < 8; y++) {
+            ditherChannels<quint16, quint8, Traits::channels_nb, Traits::alpha_pos>(src, dst, numPixels, 3, y);
+
+            for (int i = 0; i < numPixels * int(Traits::channels_nb); i++) {
+                QCOMPARE(int(dst[i]), value);
+            }
+        }
+    }
+
+    // a value between two levels is spread over both of them
+    const quint16 midValue = UINT8_TO_UINT16(100) + 128;
+    for (int i = 0; i < numPixels * int(Traits::channels_nb); i++) {
+        src[i] = midValue;
+    }
+
+    qreal sum = 0;
+    for (int y = 0; y < 8; y++) {
+        ditherChannels<quint16, quint8, Traits::channels_nb, Traits::alpha_pos>(src, dst, 8, 0, y);
+
+        for (int i = 0; i < 8; i++) {
+            const quint8 *pixel = dst + i * Traits::channels_nb;
+            QVERIFY(pixel[0] == 100 || pixel[0] == 101);
+            QCOMPARE(pixel[Traits::alpha_pos], KoColorSpaceMaths<quint16, quint8>::scaleToA(midValue));
+            sum += pixel[0];
+        }
+    }
+
+    QVERIFY(qAbs(sum / 64 - qreal(midValue) / 257) < 1.0 / 64);
+}
+
 QTEST_GUILESS_MAIN(TestKoColorSpaceAbstract)
@@ -11,6 +11,9 @@ private Q_SLOTS:
     void testMixColorsOpF32();
     void testMixColorsOpU8NoAlpha();
     void testMixColorsOpU8NoAlphaLinear();
+    void testOptimizedMixColorsOp();
+    void testSpanAlphaOps();
+    void testDepthConversion();
 };
 
 #endif
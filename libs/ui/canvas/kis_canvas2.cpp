@@ -81,6 +81,7 @@
 #include "kis_painting_assistants_decoration.h"
 
 #include "kis_canvas_updates_compressor.h"
+#include "kis_scheduler_tracer.h"
 
 class Q_DECL_HIDDEN KisCanvas2::KisCanvas2Private
 {
@@ -563,6 +564,8 @@ void KisCanvas2::finishResizingImage(qint32 w, qint32 h)
 
 void KisCanvas2::startUpdateCanvasProjection(const QRect & rc)
 {
+    KisSchedulerTraceScope traceScope("canvasConvert", rc);
+
     KisUpdateInfoSP info = m_d->canvasWidget->startUpdateCanvasProjection(rc, m_d->channelFlags);
     if (m_d->projectionUpdatesCompressor.putUpdateInfo(info)) {
         emit sigCanvasCacheUpdated();
@@ -572,6 +575,7 @@ void KisCanvas2::startUpdateCanvasProjection(const QRect & rc)
 void KisCanvas2::updateCanvasProjection()
 {
     while (KisUpdateInfoSP info = m_d->projectionUpdatesCompressor.takeUpdateInfo()) {
+        KisSchedulerTraceScope traceScope("canvasUpload", info->dirtyImageRect());
         QRect vRect = m_d->canvasWidget->updateCanvasProjection(info);
         if (!vRect.isEmpty()) {
             updateCanvasWidgetImpl(m_d->coordinatesConverter->viewportToWidget(vRect).toAlignedRect());
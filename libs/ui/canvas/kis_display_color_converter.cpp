@@ -342,7 +342,8 @@ KoColorConversionTransformation::ConversionFlags
 KisDisplayColorConverter::conversionFlags()
 {
     KoColorConversionTransformation::ConversionFlags conversionFlags =
-        KoColorConversionTransformation::HighQuality;
+        KoColorConversionTransformation::HighQuality |
+        KoColorConversionTransformation::LutApproximation;
 
     KisConfig cfg;
 
@@ -43,6 +43,7 @@
 #include "kis_layer.h"
 #include <kis_signal_compressor.h>
 #include "kis_paint_device.h"
+#include "kis_tile_histogram_cache.h"
 
 KisHistogramView::KisHistogramView(QWidget *parent, const char *name, Qt::WFlags f)
         : QLabel(parent, f),
@@ -94,6 +95,17 @@ void KisHistogramView::setPaintDevice(KisPaintDeviceSP dev, KoHistogramProducer*
     updateHistogramCalculation();
 }
 
+void KisHistogramView::setHistogramCache(KisTileHistogramCacheSP cache, KoHistogramProducer *producer)
+{
+    m_currentProducer = producer;
+    m_channels = m_currentProducer->channels();
+    m_currentDev = cache->device();
+    m_currentBounds = cache->bounds();
+    m_histogram = new KisHistogram(cache, m_currentProducer, m_histogram_type);
+
+    updateHistogramCalculation();
+}
+
 void KisHistogramView::setView(double from, double size)
 {
     double m_from = from;
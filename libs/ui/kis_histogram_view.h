@@ -65,6 +65,12 @@ public:
 
     void setPaintDevice(KisPaintDeviceSP dev, KoHistogramProducer *producer, const QRect &bounds);
 
+    /**
+     * Shows the histogram of the device and the bounds of \p cache. On
+     * updates only the cells marked dirty in the cache are rescanned.
+     */
+    void setHistogramCache(KisTileHistogramCacheSP cache, KoHistogramProducer *producer);
+
     void setView(double from, double size);
 
     KoHistogramProducer *currentProducer();
@@ -21,6 +21,7 @@
 #include "kis_canvas_resource_provider.h"
 #include <brushengine/kis_paintop_preset.h>
 #include <brushengine/kis_paintop_settings.h>
+#include <brushengine/kis_paintop.h>
 #include "kis_painter.h"
 
 #include "kis_update_time_monitor.h"
@@ -91,6 +92,15 @@ void FreehandStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
     KisUpdateTimeMonitor::instance()->reportPaintOpPreset(info->painter->preset());
     KisRandomSourceSP rnd = m_d->randomSource.source();
 
+    /**
+     * The paintop may render the dabs of the job asynchronously, they
+     * must all be composited before we take the dirty region
+     */
+    KisPaintOp *paintOp = info->painter->paintOp();
+    if (paintOp) {
+        paintOp->beginDabBatch();
+    }
+
     switch(d->type) {
     case Data::POINT:
         d->pi1.setRandomSource(rnd);
@@ -126,6 +136,10 @@ void FreehandStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
         info->painter->paintPainterPath(d->path);
     };
 
+    if (paintOp) {
+        paintOp->endDabBatch();
+    }
+
     QVector<QRect> dirtyRects = info->painter->takeDirtyRegion();
     KisUpdateTimeMonitor::instance()->reportJobFinished(data, dirtyRects);
     d->node->setDirty(dirtyRects);
@@ -25,6 +25,7 @@
 #include <klocalizedstring.h>
 
 #include "LcmsColorSpace.h"
+#include "LcmsParallelTransform.h"
 
 #include <QDebug>
 
@@ -39,6 +40,7 @@ public:
                                         ConversionFlags conversionFlags)
         : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
         , m_transform(0)
+        , m_alphaCopiedByLcms(false)
     {
         Q_ASSERT(srcCs);
         Q_ASSERT(dstCs);
@@ -59,9 +61,12 @@ public:
                                          dstProfile->lcmsProfile(),
                                          dstColorSpaceType,
                                          renderingIntent,
-                                         conversionFlags);
+                                         cmsUInt32Number(conversionFlags & ~(KoColorConversionTransformation::LutApproximation | KoColorConversionTransformation::Dither)) |
+                                         lcmsCopyAlphaFlag());
 
         Q_ASSERT(m_transform);
+
+        m_alphaCopiedByLcms = lcmsCopyAlphaFlag();
     }
 
     ~KoLcmsColorConversionTransformation()
@@ -78,9 +83,11 @@ public:
         qint32 srcPixelSize = srcColorSpace()->pixelSize();
         qint32 dstPixelSize = dstColorSpace()->pixelSize();
 
-        cmsDoTransform(m_transform, const_cast<quint8 *>(src), dst, numPixels);
+        lcmsDoTransform(m_transform, src, dst, srcPixelSize, dstPixelSize, numPixels);
+
+        if (m_alphaCopiedByLcms) return;
 
-        // Lcms does nothing to the destination alpha channel so we must convert that manually.
+        // Old Lcms does nothing to the destination alpha channel so we must convert that manually.
         while (numPixels > 0) {
             qreal alpha = srcColorSpace()->opacityF(src);
             dstColorSpace()->setOpacity(dst, alpha, 1);
@@ -93,6 +100,7 @@ public:
     }
 private:
     mutable cmsHTRANSFORM m_transform;
+    bool m_alphaCopiedByLcms;
 };
 
 struct IccColorSpaceEngine::Private {
@@ -25,6 +25,8 @@
 #include <colorprofiles/LcmsColorProfileContainer.h>
 #include <KoColorSpaceAbstract.h>
 
+#include "LcmsParallelTransform.h"
+
 class LcmsColorProfileContainer;
 
 class KoLcmsInfo
@@ -85,6 +87,7 @@ class LcmsColorSpace : public KoColorSpaceAbstract<_CSTraits>, public KoLcmsInfo
             csProfile = 0;
             cmstransform = 0;
             cmsAlphaTransform = 0;
+            alphaCopiedByLcms = false;
             profiles[0] = 0;
             profiles[1] = 0;
             profiles[2] = 0;
@@ -96,6 +99,9 @@ class LcmsColorSpace : public KoColorSpaceAbstract<_CSTraits>, public KoLcmsInfo
             if (cmstransform) {
                 cmsDeleteTransform(cmstransform);
             }
+            if (cmsAlphaTransform) {
+                cmsDeleteTransform(cmsAlphaTransform);
+            }
             if (profiles[0] && profiles[0] != csProfile) {
                 cmsCloseProfile(profiles[0]);
             }
@@ -109,37 +115,41 @@ class LcmsColorSpace : public KoColorSpaceAbstract<_CSTraits>, public KoLcmsInfo
 
         virtual void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
         {
-            cmsDoTransform(cmstransform, const_cast<quint8 *>(src), dst, nPixels);
-
-            qint32 numPixels = nPixels;
             qint32 pixelSize = m_colorSpace->pixelSize();
-            int index = 0;
+
+            lcmsDoTransform(cmstransform, src, dst, pixelSize, pixelSize, nPixels);
 
             if (cmsAlphaTransform) {
-                qreal *alpha = new qreal[nPixels];
-                qreal *dstalpha = new qreal[nPixels];
+                // process the alpha channel in blocks to avoid
+                // allocating buffers on every call
+                const int blockSize = 256;
+                qreal alpha[blockSize];
+                qreal dstAlpha[blockSize];
 
-                while (index < nPixels) {
-                    alpha[index] = m_colorSpace->opacityF(src);
-                    src += pixelSize;
-                    index++;
-                }
+                while (nPixels > 0) {
+                    const int numPixels = qMin(nPixels, blockSize);
 
-                cmsDoTransform(cmsAlphaTransform, const_cast<qreal *>(alpha), static_cast<qreal *>(dstalpha), nPixels);
-                for (int i = 0; i < numPixels; i++) {
-                    m_colorSpace->setOpacity(dst, dstalpha[i], 1);
-                    dst += pixelSize;
-                }
+                    for (int i = 0; i < numPixels; i++) {
+                        alpha[i] = m_colorSpace->opacityF(src);
+                        src += pixelSize;
+                    }
+
+                    cmsDoTransform(cmsAlphaTransform, alpha, dstAlpha, numPixels);
+
+                    for (int i = 0; i < numPixels; i++) {
+                        m_colorSpace->setOpacity(dst, dstAlpha[i], 1);
+                        dst += pixelSize;
+                    }
 
-                delete [] alpha;
-                delete [] dstalpha;
-            } else {
-                while (numPixels > 0) {
+                    nPixels -= numPixels;
+                }
+            } else if (!alphaCopiedByLcms) {
+                while (nPixels > 0) {
                     qreal alpha = m_colorSpace->opacityF(src);
                     m_colorSpace->setOpacity(dst, alpha, 1);
                     src += pixelSize;
                     dst += pixelSize;
-                    numPixels--;
+                    nPixels--;
                 }
             }
         }
@@ -149,6 +159,7 @@ class LcmsColorSpace : public KoColorSpaceAbstract<_CSTraits>, public KoLcmsInfo
         cmsHPROFILE profiles[3];
         cmsHTRANSFORM cmstransform;
         cmsHTRANSFORM cmsAlphaTransform;
+        bool alphaCopiedByLcms;
     };
 
     struct Private {
@@ -312,7 +323,8 @@ public:
         adj->profiles[2] = d->profile->lcmsProfile();
         adj->cmstransform  = cmsCreateMultiprofileTransform(adj->profiles, 3, this->colorSpaceType(), this->colorSpaceType(),
                              KoColorConversionTransformation::adjustmentRenderingIntent(),
-                             KoColorConversionTransformation::adjustmentConversionFlags());
+                             cmsUInt32Number(KoColorConversionTransformation::adjustmentConversionFlags()) | lcmsCopyAlphaFlag());
+        adj->alphaCopiedByLcms = lcmsCopyAlphaFlag();
         adj->csProfile = d->profile->lcmsProfile();
         return adj;
     }
@@ -377,6 +389,51 @@ public:
         }
     }
 
+    /**
+     * Converts the pixels into Lab in blocks, so that LCMS is called
+     * once per block instead of twice per pixel
+     */
+    virtual void differences(const quint8 *src, const quint8 *pixels, quint8 *diffs, qint32 nPixels) const
+    {
+        const qint32 blockSize = 64;
+        const qint32 pixelSize = this->pixelSize();
+
+        quint16 srcLab[4];
+        quint16 lab[4 * blockSize];
+        cmsCIELab srcLabF;
+        cmsCIELab labF;
+
+        Q_ASSERT(this->toLabA16Converter());
+        this->toLabA16Converter()->transform(src, reinterpret_cast<quint8*>(srcLab), 1);
+        cmsLabEncoded2Float(&srcLabF, srcLab);
+
+        const quint8 srcOpacity = _CSTraits::opacityU8(src);
+
+        while (nPixels > 0) {
+            const qint32 numPixels = qMin(nPixels, blockSize);
+
+            this->toLabA16Converter()->transform(pixels, reinterpret_cast<quint8*>(lab), numPixels);
+
+            for (qint32 i = 0; i < numPixels; i++) {
+                const quint8 opacity = _CSTraits::opacityU8(pixels + i * pixelSize);
+
+                if (srcOpacity == OPACITY_TRANSPARENT_U8 ||
+                    opacity == OPACITY_TRANSPARENT_U8) {
+
+                    diffs[i] = srcOpacity == opacity ? 0 : 255;
+                } else {
+                    cmsLabEncoded2Float(&labF, lab + 4 * i);
+                    const qreal diff = cmsDeltaE(&srcLabF, &labF);
+                    diffs[i] = diff > 255.0 ? 255 : quint8(diff);
+                }
+            }
+
+            pixels += numPixels * pixelSize;
+            diffs += numPixels;
+            nPixels -= numPixels;
+        }
+    }
+
     virtual quint8 differenceA(const quint8 *src1, const quint8 *src2) const
     {
         quint8 lab1[8];
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "LcmsParallelTransform.h"
+
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+namespace {
+
+/**
+ * Smaller chunks are not worth the overhead of the thread
+ * synchronization (a tile is 4096 pixels)
+ */
+const qint32 MIN_PIXELS_PER_CHUNK = 65536;
+
+struct TransformChunk {
+    const quint8 *src;
+    quint8 *dst;
+    qint32 numPixels;
+};
+
+}
+
+cmsUInt32Number lcmsCopyAlphaFlag()
+{
+#ifdef cmsFLAGS_COPY_ALPHA
+    static const cmsUInt32Number flag =
+        cmsGetEncodedCMMversion() >= 2080 ? cmsFLAGS_COPY_ALPHA : 0;
+    return flag;
+#else
+    return 0;
+#endif
+}
+
+void lcmsDoTransform(cmsHTRANSFORM transform,
+                     const quint8 *src, quint8 *dst,
+                     qint32 srcPixelSize, qint32 dstPixelSize,
+                     qint32 numPixels)
+{
+    const int numChunks = qMin(QThread::idealThreadCount(), numPixels / MIN_PIXELS_PER_CHUNK);
+
+    if (numChunks <= 1) {
+        cmsDoTransform(transform, const_cast<quint8 *>(src), dst, numPixels);
+        return;
+    }
+
+    QVector<TransformChunk> chunks(numChunks);
+    const qint32 pixelsPerChunk = numPixels / numChunks;
+
+    for (int i = 0; i < numChunks; i++) {
+        TransformChunk &chunk = chunks[i];
+
+        chunk.src = src + i * pixelsPerChunk * srcPixelSize;
+        chunk.dst = dst + i * pixelsPerChunk * dstPixelSize;
+        chunk.numPixels = i < numChunks - 1 ? pixelsPerChunk : numPixels - i * pixelsPerChunk;
+    }
+
+    QtConcurrent::blockingMap(chunks,
+        [transform] (const TransformChunk &chunk) {
+            cmsDoTransform(transform, const_cast<quint8 *>(chunk.src), chunk.dst, chunk.numPixels);
+        });
+}
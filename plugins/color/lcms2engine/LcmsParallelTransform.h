@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef LCMSPARALLELTRANSFORM_H
+#define LCMSPARALLELTRANSFORM_H
+
+#include <QtGlobal>
+#include <lcms2.h>
+
+/**
+ * Extra transform flags that make LCMS copy the alpha channel (and
+ * other extra channels) from the source to the destination, converting
+ * it to the destination depth. This avoids a separate pass over the
+ * pixels after cmsDoTransform().
+ *
+ * Returns 0 if the LCMS library (the one actually loaded, not the
+ * one the headers came from) doesn't support it. Then the caller
+ * should copy the alpha channel itself.
+ */
+cmsUInt32Number lcmsCopyAlphaFlag();
+
+/**
+ * Runs cmsDoTransform() on \p numPixels pixels. Big requests (the
+ * whole-image conversions) are split into chunks processed by the
+ * global thread pool; the calling thread takes part in the processing
+ * as well. Tile-sized requests are processed in the calling thread.
+ *
+ * LCMS transforms are safe to be used from several threads at once.
+ */
+void lcmsDoTransform(cmsHTRANSFORM transform,
+                     const quint8 *src, quint8 *dst,
+                     qint32 srcPixelSize, qint32 dstPixelSize,
+                     qint32 numPixels);
+
+#endif // LCMSPARALLELTRANSFORM_H
@@ -0,0 +1,93 @@
+#include "TestKoLcmsColorSpace.h"
+
+#include <QTest>
+#include <QColor>
+
+#include "KoColorSpaceRegistry.h"
+#include "KoColorSpace.h"
+#include "KoLutColorConversionTransformation.h"
+
+void testDifferencesImpl(const KoColorSpace *cs)
+{
+    const int numPixels = 150; // more than one conversion block
+    const int pixelSize = cs->pixelSize();
+
+    QByteArray pixels(numPixels * pixelSize, 0);
+    quint8 *ptr = reinterpret_cast<quint8*>(pixels.data());
+
+    for (int i = 0; i < numPixels; i++) {
+        const int value = (i * 37) % 256;
+        cs->fromQColor(QColor(value, 255 - value, (value * 3) % 256, i % 10 ? 255 - i : 0), ptr + i * pixelSize);
+    }
+
+    QByteArray src(pixelSize, 0);
+    cs->fromQColor(QColor(100, 150, 200, 255), reinterpret_cast<quint8*>(src.data()));
+
+    QVector<quint8> diffs(numPixels);
+    cs->differences(reinterpret_cast<const quint8*>(src.constData()), ptr, diffs.data(), numPixels);
+
+    for (int i = 0; i < numPixels; i++) {
+        QCOMPARE(diffs[i], cs->difference(reinterpret_cast<const quint8*>(src.constData()), ptr + i * pixelSize));
+    }
+}
+
+void TestKoLcmsColorSpace::testDifferences()
+{
+    testDifferencesImpl(KoColorSpaceRegistry::instance()->rgb8());
+    testDifferencesImpl(KoColorSpaceRegistry::instance()->rgb16());
+    testDifferencesImpl(KoColorSpaceRegistry::instance()->colorSpace("GRAYA", "U8", ""));
+    testDifferencesImpl(KoColorSpaceRegistry::instance()->lab16());
+}
+
+void TestKoLcmsColorSpace::testLutConversion()
+{
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *rgb16 = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *lab16 = KoColorSpaceRegistry::instance()->lab16();
+    const KoColorSpace *alpha = KoColorSpaceRegistry::instance()->alpha8();
+
+    QVERIFY(KoLutColorConversionTransformation::isSupported(rgb16, rgb8));
+    QVERIFY(KoLutColorConversionTransformation::isSupported(rgb8, lab16));
+    QVERIFY(!KoLutColorConversionTransformation::isSupported(alpha, rgb8));
+    QVERIFY(!KoLutColorConversionTransformation::isSupported(rgb8, alpha));
+
+    // the profiles are the same, so the table is exact up to rounding
+    KoColorConversionTransformation *exact =
+        rgb16->createColorConverter(rgb8,
+                                    KoColorConversionTransformation::internalRenderingIntent(),
+                                    KoColorConversionTransformation::internalConversionFlags());
+
+    KoLutColorConversionTransformation lut(exact, 9);
+    QCOMPARE(lut.gridSize(), 9);
+    QVERIFY(lut.maxError() <= 1.0 / 255.0);
+
+    const int numPixels = 1000;
+    QVector<quint16> src(numPixels * 4);
+    QVector<quint8> exactPixels(numPixels * 4);
+    QVector<quint8> lutPixels(numPixels * 4);
+
+    for (int i = 0; i < src.size(); i++) {
+        src[i] = (i * 7919) % 65536;
+    }
+
+    exact->transform(reinterpret_cast<const quint8*>(src.constData()), exactPixels.data(), numPixels);
+    lut.transform(reinterpret_cast<const quint8*>(src.constData()), lutPixels.data(), numPixels);
+
+    for (int i = 0; i < exactPixels.size(); i++) {
+        QVERIFY(qAbs(int(exactPixels[i]) - int(lutPixels[i])) <= 1);
+    }
+
+    delete exact;
+
+    // the display flag makes the conversion system use the table
+    KoColorConversionTransformation *converter =
+        rgb16->createColorConverter(rgb8,
+                                    KoColorConversionTransformation::internalRenderingIntent(),
+                                    KoColorConversionTransformation::internalConversionFlags() |
+                                    KoColorConversionTransformation::LutApproximation);
+
+    QVERIFY(dynamic_cast<KoLutColorConversionTransformation*>(converter));
+    delete converter;
+}
+
+QTEST_GUILESS_MAIN(TestKoLcmsColorSpace)
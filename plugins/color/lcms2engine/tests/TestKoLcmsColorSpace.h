@@ -0,0 +1,14 @@
+#ifndef TESTKOLCMSCOLORSPACE_H
+#define TESTKOLCMSCOLORSPACE_H
+
+#include <QObject>
+
+class TestKoLcmsColorSpace : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDifferences();
+    void testLutConversion();
+};
+
+#endif
@@ -28,6 +28,7 @@
 #include "kis_paint_device.h"
 #include "kis_signal_compressor.h"
 #include "kis_histogram_view.h"
+#include "kis_tile_histogram_cache.h"
 
 HistogramDockerDock::HistogramDockerDock( )
     : QDockWidget(i18n("Histogram")),
@@ -60,14 +61,9 @@ void HistogramDockerDock::setCanvas(KoCanvasBase * canvas)
     m_canvas = dynamic_cast<KisCanvas2*>(canvas);
     if (m_canvas && m_canvas->imageView() && m_canvas->imageView()->image() ) {
 
-        KisPaintDeviceSP dev = m_canvas->image()->projection();
-        auto cs = m_canvas->image()->colorSpace();
+        resetHistogram(m_canvas->image()->colorSpace());
 
-        QList<QString> producers = KoHistogramProducerFactoryRegistry::instance()->keysCompatibleWith(cs,true);
-        m_producer = KoHistogramProducerFactoryRegistry::instance()->get(producers.at(0))->generate();
-        m_histogramWidget->setPaintDevice( dev, m_producer, m_canvas->image()->bounds() );
-
-        connect(m_canvas->image(), SIGNAL(sigImageUpdated(QRect)), m_compressor, SLOT(start()), Qt::UniqueConnection);
+        connect(m_canvas->image(), SIGNAL(sigImageUpdated(QRect)), this, SLOT(slotImageUpdated(QRect)), Qt::UniqueConnection);
         connect(m_canvas->image(), SIGNAL(sigColorSpaceChanged(const KoColorSpace*)), this, SLOT(sigColorSpaceChanged(const KoColorSpace*)), Qt::UniqueConnection);
 
         m_compressor->start();
@@ -78,17 +74,47 @@ void HistogramDockerDock::unsetCanvas()
 {
     setEnabled(false);
     m_canvas = 0;
+    m_histogramCache = 0;
+}
+
+void HistogramDockerDock::resetHistogram(const KoColorSpace *cs)
+{
+    QList<QString> producers = KoHistogramProducerFactoryRegistry::instance()->keysCompatibleWith(cs,true);
+    KoHistogramProducerFactory *factory = KoHistogramProducerFactoryRegistry::instance()->get(producers.at(0));
+
+    m_producer = factory->generate();
+    m_histogramCache =
+        KisTileHistogramCache::sharedCache(m_canvas->image()->projection(),
+                                           factory->id(),
+                                           [factory] () { return factory->generate(); },
+                                           m_canvas->image()->bounds());
+    m_histogramWidget->setHistogramCache(m_histogramCache, m_producer);
+}
+
+void HistogramDockerDock::slotImageUpdated(const QRect &rc)
+{
+    if (m_histogramCache) {
+        m_histogramCache->setDirty(rc);
+    }
+    m_compressor->start();
 }
 
 void HistogramDockerDock::startUpdateCanvasProjection()
 {
+    if (!m_canvas || !m_histogramCache) return;
+
+    const QRect imageBounds = m_canvas->image()->bounds();
+    if (m_histogramCache->bounds() != imageBounds) {
+        m_histogramCache->setBounds(imageBounds);
+    }
+
     m_histogramWidget->startUpdateCanvasProjection();
 }
 
 void HistogramDockerDock::sigColorSpaceChanged(const KoColorSpace *cs)
 {
-    QList<QString> producers = KoHistogramProducerFactoryRegistry::instance()->keysCompatibleWith(cs,true);
-    m_producer = KoHistogramProducerFactoryRegistry::instance()->get(producers.at(0))->generate();
-    m_histogramWidget->setProducer(m_producer);
+    if (!m_canvas) return;
+
+    resetHistogram(cs);
 }
 
@@ -42,12 +42,19 @@ public Q_SLOTS:
     //virtual void sigProfileChanged(const KoColorProfile* cp);
     virtual void sigColorSpaceChanged(const KoColorSpace* cs);
 
+private Q_SLOTS:
+    void slotImageUpdated(const QRect &rc);
+
+private:
+    void resetHistogram(const KoColorSpace *cs);
+
 private:
     QVBoxLayout *m_layout;
     KisSignalCompressor *m_compressor;
     KisHistogramView *m_histogramWidget;
     KisCanvas2 *m_canvas;
     KoHistogramProducer *m_producer;
+    KisTileHistogramCacheSP m_histogramCache;
 };
 
 
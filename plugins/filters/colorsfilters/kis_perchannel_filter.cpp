@@ -48,6 +48,7 @@
 #include <kis_processing_information.h>
 
 #include "kis_histogram.h"
+#include "kis_tile_histogram_cache.h"
 #include "kis_painter.h"
 #include "widgets/kis_curve_widget.h"
 
@@ -122,7 +123,14 @@ KisPerChannelConfigWidget::KisPerChannelConfigWidget(QWidget * parent, KisPaintD
     if(keys.size() > 0) {
         KoHistogramProducerFactory *hpf;
         hpf = KoHistogramProducerFactoryRegistry::instance()->get(keys.at(0));
-	m_histogram = new KisHistogram(m_dev, m_dev->exactBounds(), hpf->generate(), LINEAR);
+
+        KisTileHistogramCacheSP histogramCache =
+            KisTileHistogramCache::sharedCache(m_dev,
+                                               hpf->id(),
+                                               [hpf] () { return hpf->generate(); },
+                                               m_dev->exactBounds());
+
+        m_histogram = new KisHistogram(histogramCache, hpf->generate(), LINEAR);
     }
 
     connect(m_page->curveWidget, SIGNAL(modified()), this, SIGNAL(sigConfigurationItemChanged()));
@@ -36,6 +36,7 @@
 
 #include "kis_paint_device.h"
 #include "kis_histogram.h"
+#include "kis_tile_histogram_cache.h"
 #include "kis_painter.h"
 #include "kis_gradient_slider.h"
 #include "kis_processing_information.h"
@@ -137,7 +138,14 @@ KisLevelConfigWidget::KisLevelConfigWidget(QWidget * parent, KisPaintDeviceSP de
     connect((QObject*)(m_page.chkLogarithmic), SIGNAL(toggled(bool)), this, SLOT(slotDrawHistogram(bool)));
 
     KoHistogramProducer *producer = new KoGenericLabHistogramProducer();
-    m_histogram.reset( new KisHistogram(dev, dev->exactBounds(), producer, LINEAR) );
+
+    KisTileHistogramCacheSP histogramCache =
+        KisTileHistogramCache::sharedCache(dev,
+                                           producer->id().id(),
+                                           [] () { return new KoGenericLabHistogramProducer(); },
+                                           dev->exactBounds());
+
+    m_histogram.reset( new KisHistogram(histogramCache, producer, LINEAR) );
     m_histlog = false;
     m_page.histview->resize(288,100);
     slotDrawHistogram();
@@ -418,7 +418,9 @@ KisImageBuilder_Result CSVSaver::getLayer(CSVLayerRecord* layer, KisDocument* ex
 
     if (!KisPNGConverter::isColorSpaceSupported(cs)) {
         device = new KisPaintDevice(*device.data());
-        KUndo2Command *cmd= device->convertTo(KoColorSpaceRegistry::instance()->rgb8());
+        KUndo2Command *cmd= device->convertTo(KoColorSpaceRegistry::instance()->rgb8(),
+                                                KoColorConversionTransformation::internalRenderingIntent(),
+                                                KoColorConversionTransformation::internalConversionFlags() | KoColorConversionTransformation::Dither);
         delete cmd;
     }
     KisPNGOptions options;
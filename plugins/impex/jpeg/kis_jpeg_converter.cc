@@ -486,7 +486,7 @@ KisImageBuilder_Result KisJPEGConverter::buildFile(const QString &filename, KisP
         if (!m_d->batchMode) {
             QMessageBox::information(0, i18nc("@title:window", "Krita"), i18n("Cannot export images in %1.\nWill save as RGB.", cs->name()));
         }
-        KUndo2Command *tmp = layer->paintDevice()->convertTo(KoColorSpaceRegistry::instance()->rgb8(), KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
+        KUndo2Command *tmp = layer->paintDevice()->convertTo(KoColorSpaceRegistry::instance()->rgb8(), KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags() | KoColorConversionTransformation::Dither);
         delete tmp;
         cs = KoColorSpaceRegistry::instance()->rgb8();
         color_type = JCS_RGB;
@@ -653,6 +653,16 @@ KisImageBuilder_Result KisJPEGConverter::buildFile(const QString &filename, KisP
     gc.bitBlt(QPoint(0, 0), layer->paintDevice(), QRect(0, 0, width, height));
     gc.end();
 
+    // flatten deeper images to 8 bits with dithering, otherwise smooth gradients band
+    if (dev->colorSpace()->colorDepthId() != Integer8BitsColorDepthID) {
+        const KoColorSpace *dst8 = KoColorSpaceRegistry::instance()->colorSpace(cs->colorModelId().id(), Integer8BitsColorDepthID.id(), cs->profile());
+        if (dst8) {
+            KUndo2Command *tmp = dev->convertTo(dst8, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags() | KoColorConversionTransformation::Dither);
+            delete tmp;
+            cs = dst8;
+        }
+    }
+
 
     if (options.saveProfile) {
         const KoColorProfile* colorProfile = layer->colorSpace()->profile();
@@ -663,7 +673,7 @@ KisImageBuilder_Result KisJPEGConverter::buildFile(const QString &filename, KisP
     // Write data information
 
     JSAMPROW row_pointer = new JSAMPLE[width*cinfo.input_components];
-    int color_nb_bits = 8 * layer->paintDevice()->pixelSize() / layer->paintDevice()->channelCount();
+    int color_nb_bits = 8 * dev->pixelSize() / dev->channelCount();
 
     for (; cinfo.next_scanline < height;) {
         KisHLineConstIteratorSP it = dev->createHLineConstIteratorNG(0, cinfo.next_scanline, width);
@@ -77,7 +77,9 @@ bool KisSpriterExport::savePaintDevice(KisPaintDeviceSP dev, const QString &file
 
     if (!KisPNGConverter::isColorSpaceSupported(dev->colorSpace())) {
         dev = new KisPaintDevice(*dev.data());
-        KUndo2Command *cmd = dev->convertTo(KoColorSpaceRegistry::instance()->rgb8());
+        KUndo2Command *cmd = dev->convertTo(KoColorSpaceRegistry::instance()->rgb8(),
+                                             KoColorConversionTransformation::internalRenderingIntent(),
+                                             KoColorConversionTransformation::internalConversionFlags() | KoColorConversionTransformation::Dither);
         delete cmd;
     }
 
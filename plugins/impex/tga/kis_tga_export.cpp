@@ -65,7 +65,7 @@ KisImportExportFilter::ConversionStatus KisTGAExport::convert(const QByteArray&
     KIS_SAFE_ASSERT_RECOVER_NOOP(input->image()->locked());
 
     QRect rc = input->image()->bounds();
-    QImage image = input->image()->projection()->convertToQImage(0, 0, 0, rc.width(), rc.height(), KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
+    QImage image = input->image()->projection()->convertToQImage(0, 0, 0, rc.width(), rc.height(), KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags() | KoColorConversionTransformation::Dither);
 
     QFile f(filename);
     f.open(QIODevice::WriteOnly);
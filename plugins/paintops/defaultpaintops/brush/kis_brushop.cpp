@@ -24,8 +24,10 @@
 #include "kis_brushop.h"
 
 #include <QRect>
+#include <QThread>
 
 #include <kis_image.h>
+#include <kis_image_config.h>
 #include <kis_vec.h>
 #include <kis_debug.h>
 
@@ -41,10 +43,12 @@
 #include <kis_pressure_sharpness_option.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_lod_transform.h>
+#include <kis_dab_rendering_queue.h>
 
 
 KisBrushOp::KisBrushOp(const KisBrushBasedPaintOpSettings *settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
-    : KisBrushBasedPaintOp(settings, painter), m_opacityOption(node), m_hsvTransformation(0)
+    : KisBrushBasedPaintOp(settings, painter), m_opacityOption(node), m_hsvTransformation(0),
+      m_dabQueue(0), m_dabBatchActive(false)
 {
     Q_UNUSED(image);
     Q_ASSERT(settings);
@@ -87,10 +91,28 @@ KisBrushOp::KisBrushOp(const KisBrushBasedPaintOpSettings *settings, KisPainter
 
     m_dabCache->setSharpnessPostprocessing(&m_sharpnessOption);
     m_rotationOption.applyFanCornersInfo(this);
+
+    /**
+     * The dabs can be rendered on the worker threads only when they
+     * need no post-processing and the brush has no per-dab state
+     */
+    KisImageConfig cfg(true);
+    const int numWorkers = QThread::idealThreadCount() - 1;
+
+    if (cfg.asyncDabRendering() &&
+        numWorkers > 0 &&
+        m_brush->brushType() != PIPE_MASK &&
+        m_brush->brushType() != PIPE_IMAGE &&
+        !m_mirrorOption.isChecked() &&
+        !m_dabCache->needSeparateOriginal()) {
+
+        m_dabQueue = new KisDabRenderingQueue(m_brush, &m_precisionOption, numWorkers);
+    }
 }
 
 KisBrushOp::~KisBrushOp()
 {
+    delete m_dabQueue;
     qDeleteAll(m_hsvOptions);
     delete m_colorSource;
     delete m_hsvTransformation;
@@ -123,10 +145,24 @@ KisSpacingInformation KisBrushOp::paintAt(const KisPaintInformation& info)
                               brush->maskWidth(scale, rotation, 0, 0, info),
                               brush->maskHeight(scale, rotation, 0, 0, info));
 
+    const bool renderAsynchronously =
+        m_dabQueue && m_dabBatchActive && m_colorSource->isUniformColor();
+
+    if (!renderAsynchronously && m_dabQueue) {
+        compositePendingDabs(true);
+    }
+
     quint8 origOpacity = painter()->opacity();
+    quint8 dabOpacity = OPACITY_OPAQUE_U8;
 
     m_opacityOption.setFlow(m_flowOption.apply(info));
-    m_opacityOption.apply(painter(), info);
+
+    if (renderAsynchronously) {
+        dabOpacity = m_opacityOption.getOpacityU8(info);
+    } else {
+        m_opacityOption.apply(painter(), info);
+    }
+
     m_colorSource->selectColor(m_mixOption.apply(info), info);
     m_darkenOption.apply(m_colorSource, info);
 
@@ -137,6 +173,25 @@ KisSpacingInformation KisBrushOp::paintAt(const KisPaintInformation& info)
         m_colorSource->applyColorTransformation(m_hsvTransformation);
     }
 
+    if (renderAsynchronously) {
+        KisDabRenderingQueue::Request request;
+        request.colorSpace = device->compositionSourceColorSpace();
+        request.color = m_colorSource->uniformColor();
+        request.cursorPoint = cursorPos;
+        request.scale = scale;
+        request.rotation = rotation;
+        request.softness = m_softnessOption.apply(info);
+        request.info = KisDabRenderingQueue::detachedPaintInformation(info);
+        request.opacity = dabOpacity;
+        request.flow = m_opacityOption.getFlowU8();
+
+        m_dabQueue->addDab(request);
+        compositePendingDabs(false);
+
+        return effectiveSpacing(scale, rotation,
+                                m_spacingOption, info);
+    }
+
     QRect dabRect;
     KisFixedPaintDeviceSP dab = m_dabCache->fetchDab(device->compositionSourceColorSpace(),
                                 m_colorSource,
@@ -163,6 +218,38 @@ KisSpacingInformation KisBrushOp::paintAt(const KisPaintInformation& info)
                             m_spacingOption, info);
 }
 
+void KisBrushOp::beginDabBatch()
+{
+    m_dabBatchActive = true;
+}
+
+void KisBrushOp::endDabBatch()
+{
+    if (m_dabQueue) {
+        compositePendingDabs(true);
+    }
+    m_dabBatchActive = false;
+}
+
+void KisBrushOp::compositePendingDabs(bool waitForAll)
+{
+    while (m_dabQueue->hasPendingDabs() &&
+           (waitForAll || m_dabQueue->isFull() || m_dabQueue->isFirstDabReady())) {
+
+        KisDabRenderingQueue::RenderedDab dab = m_dabQueue->takeFirstDab();
+
+        quint8 origOpacity = painter()->opacity();
+        painter()->setOpacityUpdateAverage(dab.opacity);
+        painter()->setFlow(dab.flow);
+
+        painter()->bltFixed(dab.rect.topLeft(), dab.device, dab.device->bounds());
+
+        // the dab is a private copy, so it can be mirrored in place
+        painter()->renderMirrorMaskSafe(dab.rect, dab.device, false);
+        painter()->setOpacity(origOpacity);
+    }
+}
+
 void KisBrushOp::paintLine(const KisPaintInformation& pi1, const KisPaintInformation& pi2, KisDistanceInformation *currentDistance)
 {
     if (m_sharpnessOption.isChecked() && m_brush && (m_brush->width() == 1) && (m_brush->height() == 1)) {
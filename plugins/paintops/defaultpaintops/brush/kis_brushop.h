@@ -42,6 +42,7 @@ class KisBrushBasedPaintOpSettings;
 
 class KisPainter;
 class KisColorSource;
+class KisDabRenderingQueue;
 
 
 class KisBrushOp : public KisBrushBasedPaintOp
@@ -55,6 +56,12 @@ public:
     KisSpacingInformation paintAt(const KisPaintInformation& info);
     void paintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, KisDistanceInformation *currentDistance);
 
+    void beginDabBatch();
+    void endDabBatch();
+
+private:
+    void compositePendingDabs(bool waitForAll);
+
 private:
     KisColorSource *m_colorSource;
     KisPressureSizeOption m_sizeOption;
@@ -72,6 +79,9 @@ private:
     KoColorTransformation *m_hsvTransformation;
     KisPaintDeviceSP m_lineCacheDevice;
     KisPaintDeviceSP m_colorSourceDevice;
+
+    KisDabRenderingQueue *m_dabQueue;
+    bool m_dabBatchActive;
 };
 
 #endif // KIS_BRUSHOP_H_
@@ -25,8 +25,10 @@
 #include <kis_canvas_resource_provider.h>
 #include <brushengine/kis_paintop_preset.h>
 #include <brushengine/kis_paintop_settings.h>
+#include <brushengine/kis_paintop.h>
 #include <kis_pressure_mirror_option.h>
 #include <kis_pressure_rotation_option.h>
+#include <kis_image_config.h>
 
 class TestBrushOp : public TestUtil::QImageBasedTest
 {
@@ -208,6 +210,67 @@ public:
     }
 };
 
+class TestBrushOpBatchedPressureLines : public TestBrushOpPressureLines
+{
+public:
+    TestBrushOpBatchedPressureLines(const QString &presetFileName, const QString &prefix)
+        : TestBrushOpPressureLines(presetFileName, prefix) {
+    }
+
+    void doPaint(KisPainter &gc) {
+        gc.paintOp()->beginDabBatch();
+        TestBrushOpPressureLines::doPaint(gc);
+        gc.paintOp()->endDabBatch();
+    }
+};
+
+class TestBrushOpAsyncRendering : public TestBrushOpBatchedPressureLines
+{
+public:
+    TestBrushOpAsyncRendering(const QString &presetFileName)
+        : TestBrushOpBatchedPressureLines(presetFileName, "async") {
+    }
+
+    void test() {
+        KisPaintDeviceSP serialDevice = paint(false);
+        KisPaintDeviceSP asyncDevice = paint(true);
+
+        KisImageConfig cfg;
+        cfg.setAsyncDabRendering(false);
+
+        QPoint pt;
+        QVERIFY2(TestUtil::comparePaintDevices(pt, serialDevice, asyncDevice),
+                 QString("The devices differ at (%1, %2)").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+
+    KisPaintDeviceSP paint(bool asyncDabRendering) {
+        KisImageConfig cfg;
+        cfg.setAsyncDabRendering(asyncDabRendering);
+
+        KisSurrogateUndoStore *undoStore = new KisSurrogateUndoStore();
+        KisImageSP image = createTrivialImage(undoStore);
+        image->initialRefreshGraph();
+
+        KisNodeSP paint1 = findNode(image->root(), "paint1");
+
+        KisPainter gc(paint1->paintDevice());
+
+        QScopedPointer<KoCanvasResourceManager> manager(
+            utils::createResourceManager(image, 0, m_presetFileName));
+
+        KisResourcesSnapshotSP resources =
+            new KisResourcesSnapshot(image,
+                                     paint1,
+                                     image->postExecutionUndoAdapter(),
+                                     manager.data());
+
+        resources->setupPainter(&gc);
+
+        doPaint(gc);
+
+        return paint1->paintDevice();
+    }
+};
 
 void KisBrushOpTest::testRotationMirroring()
 {
@@ -235,4 +298,27 @@ void KisBrushOpTest::testMagicSeven()
     t.test();
 }
 
+void KisBrushOpTest::testDabBatching()
+{
+    /**
+     * The preset uses the highest precision level, so the dabs
+     * rendered on the worker threads should be exactly the same as
+     * the ones of testMagicSeven
+     */
+
+    KisImageConfig cfg;
+    cfg.setAsyncDabRendering(true);
+
+    TestBrushOpBatchedPressureLines t("magic_seven.kpp", "magicseven");
+    t.test();
+
+    cfg.setAsyncDabRendering(false);
+}
+
+void KisBrushOpTest::testAsyncDabRendering()
+{
+    TestBrushOpAsyncRendering t("magic_seven.kpp");
+    t.test();
+}
+
 QTEST_MAIN(KisBrushOpTest)
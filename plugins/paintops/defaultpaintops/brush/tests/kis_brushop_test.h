@@ -28,6 +28,8 @@ private Q_SLOTS:
     void testRotationMirroring();
     void testRotationMirroringDrawingAngle();
     void testMagicSeven();
+    void testDabBatching();
+    void testAsyncDabRendering();
 };
 
 #endif /* __KIS_BRUSHOP_TEST_H */
@@ -31,11 +31,61 @@
 #include <kis_random_accessor_ng.h>
 #include <kis_cross_device_color_picker.h>
 #include <kis_fixed_paint_device.h>
+#include <kis_pixel_selection.h>
+#include <kis_sequential_iterator.h>
 
+#include <QtConcurrent>
 
 #include <cmath>
 #include <ctime>
 
+/**
+ * The number of bristles painted by a single worker thread. The
+ * bristles are split into chunks of a fixed size, so the result
+ * depends only on the brush, not on the number of cores.
+ */
+static const int BRISTLES_PER_CHUNK = 512;
+
+/**
+ * The path of a bristle between two dabs, computed serially
+ * before the painting
+ */
+struct HairyBrush::BristleSegment {
+    Bristle *bristle;
+    QPointF start;
+    QPointF end;
+};
+
+/**
+ * Everything a bristle needs for painting. The serial path paints
+ * directly into the dab, the parallel one gives every chunk its own
+ * device, so the workers never share any writable state.
+ */
+struct HairyBrush::PaintContext {
+    PaintContext()
+        : transfo(0),
+          ownsTransfo(false)
+    {}
+
+    ~PaintContext() {
+        if (ownsTransfo) {
+            delete transfo;
+        }
+    }
+
+    KisPaintDeviceSP dab;
+    KisRandomAccessorSP dabAccessor;
+    // the pixels painted by a chunk, null for the serial path
+    KisPixelSelectionSP touched;
+    KisRandomAccessorSP touchedAccessor;
+    // scratch color for the wu particles
+    KoColor color;
+    KoColorTransformation *transfo;
+    bool ownsTransfo;
+    // used for interpolation the path of bristles
+    Trajectory trajectory;
+};
+
 
 HairyBrush::HairyBrush()
 {
@@ -45,10 +95,15 @@ HairyBrush::HairyBrush()
 
     m_saturationId = -1;
     m_transfo = 0;
+
+    m_mainContext = new PaintContext();
+    m_parallelPainting = true;
 }
 
 HairyBrush::~HairyBrush()
 {
+    delete m_mainContext;
+    qDeleteAll(m_chunkContexts);
     delete m_transfo;
     qDeleteAll(m_bristles.begin(), m_bristles.end());
     m_bristles.clear();
@@ -66,6 +121,9 @@ void HairyBrush::initAndCache()
             m_saturationId = m_transfo->parameterId("s");
         }
     }
+
+    m_mainContext->color = KoColor(m_dab->colorSpace());
+    m_mainContext->transfo = m_transfo;
 }
 
 void HairyBrush::fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density)
@@ -134,9 +192,6 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     qreal pressure = mousePressure * (pi2.pressure() * 2);
 
     Bristle *bristle = 0;
-    KoColor bristleColor(dab->colorSpace());
-
-    m_dabAccessor = dab->createRandomAccessorNG((int)x1, (int)y1);
 
     m_dab = dab;
 
@@ -161,11 +216,17 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     qreal randomX, randomY;
     qreal shear;
 
-    float inkDeplation = 0.0;
-    int inkDepletionSize = m_properties->inkDepletionCurve.size();
     int bristleCount = m_bristles.size();
-    int bristlePathSize;
     qreal treshold = 1.0 - pi2.pressure();
+
+    /**
+     * All the random values are generated here, bristle by bristle,
+     * so the painting below may run in any order without changing
+     * the result for the given random source
+     */
+    QVector<BristleSegment> segments;
+    segments.reserve(bristleCount);
+
     for (int i = 0; i < bristleCount; i++) {
 
         if (!m_bristles.at(i)->enabled()) continue;
@@ -206,39 +267,171 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         fy2 += y2;
 
         if (m_properties->threshold && (bristle->length() < treshold)) continue;
-        // paint between first and last dab
-        const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
-        bristlePathSize = m_trajectory.size();
 
-        memcpy(bristleColor.data(), bristle->color().data() , m_pixelSize);
-        for (int i = 0; i < bristlePathSize ; i++) {
+        BristleSegment segment;
+        segment.bristle = bristle;
+        segment.start = QPointF(fx1, fy1);
+        segment.end = QPointF(fx2, fy2);
+        segments.append(segment);
+    }
 
-            if (m_properties->inkDepletionEnabled) {
-                inkDeplation = fetchInkDepletion(bristle, inkDepletionSize);
+    /**
+     * Compositing the chunks one over another is not the same as
+     * compositing every pixel in the order of the bristles, so the
+     * compositing mode is always painted serially
+     */
+    if (m_parallelPainting &&
+        !m_properties->useCompositing &&
+        segments.size() > BRISTLES_PER_CHUNK) {
+        paintSegmentsParallel(segments, pressure, dab);
+    } else {
+        m_mainContext->dab = dab;
+        m_mainContext->dabAccessor = dab->createRandomAccessorNG((int)x1, (int)y1);
 
-                if (m_properties->useSaturation && m_transfo != 0) {
-                    saturationDepletion(bristle, bristleColor, pressure, inkDeplation);
-                }
+        Q_FOREACH (const BristleSegment &segment, segments) {
+            paintBristleSegment(segment, pressure, m_mainContext);
+        }
 
-                if (m_properties->useOpacity) {
-                    opacityDepletion(bristle, bristleColor, pressure, inkDeplation);
-                }
+        m_mainContext->dab = 0;
+        m_mainContext->dabAccessor = 0;
+    }
+
+    m_dab = 0;
+}
+
+void HairyBrush::paintBristleSegment(const BristleSegment &segment, qreal pressure, PaintContext *context)
+{
+    Bristle *bristle = segment.bristle;
+
+    KoColor bristleColor(context->dab->colorSpace());
+    float inkDeplation = 0.0;
+    int inkDepletionSize = m_properties->inkDepletionCurve.size();
 
+    // paint between first and last dab
+    const QVector<QPointF> bristlePath = context->trajectory.getLinearTrajectory(segment.start, segment.end, 1.0);
+    int bristlePathSize = context->trajectory.size();
+
+    memcpy(bristleColor.data(), bristle->color().data() , m_pixelSize);
+    for (int i = 0; i < bristlePathSize ; i++) {
+
+        if (m_properties->inkDepletionEnabled) {
+            inkDeplation = fetchInkDepletion(bristle, inkDepletionSize);
+
+            if (m_properties->useSaturation && context->transfo != 0) {
+                saturationDepletion(bristle, bristleColor, pressure, inkDeplation, context->transfo);
             }
-            else {
-                if (bristleColor.opacityU8() != 0) {
-                    bristleColor.setOpacity(bristle->length());
-                }
+
+            if (m_properties->useOpacity) {
+                opacityDepletion(bristle, bristleColor, pressure, inkDeplation);
             }
 
-            addBristleInk(bristle, bristlePath.at(i), bristleColor);
-            bristle->setInkAmount(1.0 - inkDeplation);
-            bristle->upIncrement();
+        }
+        else {
+            if (bristleColor.opacityU8() != 0) {
+                bristleColor.setOpacity(bristle->length());
+            }
         }
 
+        addBristleInk(bristle, bristlePath.at(i), bristleColor, context);
+        bristle->setInkAmount(1.0 - inkDeplation);
+        bristle->upIncrement();
     }
-    m_dab = 0;
-    m_dabAccessor = 0;
+}
+
+void HairyBrush::paintSegmentsParallel(const QVector<BristleSegment> &segments, qreal pressure, KisPaintDeviceSP dab)
+{
+    const KoColorSpace *cs = dab->colorSpace();
+    const int numChunks = (segments.size() + BRISTLES_PER_CHUNK - 1) / BRISTLES_PER_CHUNK;
+
+    while (m_chunkContexts.size() < numChunks) {
+        m_chunkContexts.append(new PaintContext());
+    }
+
+    QVector<int> chunks;
+
+    for (int i = 0; i < numChunks; i++) {
+        PaintContext *context = m_chunkContexts[i];
+
+        if (!context->dab || !(*context->dab->colorSpace() == *cs)) {
+            context->dab = new KisPaintDevice(cs);
+            context->touched = new KisPixelSelection();
+            context->color = KoColor(cs);
+
+            if (context->ownsTransfo) {
+                delete context->transfo;
+            }
+
+            context->transfo = m_transfo ?
+                cs->createColorTransformation("hsv_adjustment", m_params) : 0;
+            context->ownsTransfo = true;
+        } else {
+            context->dab->clear();
+            context->touched->clear();
+        }
+
+        context->dabAccessor = context->dab->createRandomAccessorNG(0, 0);
+        context->touchedAccessor = context->touched->createRandomAccessorNG(0, 0);
+        chunks.append(i);
+    }
+
+    QtConcurrent::blockingMap(chunks,
+        [this, &segments, pressure] (int chunk) {
+            PaintContext *context = m_chunkContexts[chunk];
+
+            const int begin = chunk * BRISTLES_PER_CHUNK;
+            const int end = qMin(begin + BRISTLES_PER_CHUNK, segments.size());
+
+            for (int i = begin; i < end; i++) {
+                paintBristleSegment(segments[i], pressure, context);
+            }
+
+            context->dabAccessor = 0;
+            context->touchedAccessor = 0;
+        });
+
+    // the chunks are merged in the order of the bristles
+    for (int i = 0; i < numChunks; i++) {
+        mergeChunk(m_chunkContexts[i], dab);
+    }
+}
+
+void HairyBrush::mergeChunk(PaintContext *context, KisPaintDeviceSP dab)
+{
+    const QRect rc = context->dab->extent();
+    if (rc.isEmpty()) return;
+
+    const KoColorSpace *cs = dab->colorSpace();
+
+    KisSequentialConstIterator srcIt(context->dab, rc);
+    KisSequentialConstIterator touchedIt(context->touched, rc);
+    KisSequentialIterator dstIt(dab, rc);
+
+    do {
+        /**
+         * A pixel painted with the opacity rounded to zero may
+         * still look like an untouched one, so the painted pixels
+         * are tracked explicitly
+         */
+        if (!*touchedIt.rawDataConst()) continue;
+
+        const quint8 *src = srcIt.rawDataConst();
+        quint8 *dst = dstIt.rawData();
+
+        if (m_properties->antialias) {
+            // the wu particles accumulate the opacity and keep the color of the last one
+            const quint16 opacity = cs->opacityU8(src) + cs->opacityU8(dst);
+            memcpy(dst, src, m_pixelSize);
+            cs->setOpacity(dst, quint8(qMin<quint16>(opacity, OPACITY_OPAQUE_U8)), 1);
+        } else if (cs->opacityU8(dst) < cs->opacityU8(src)) {
+            // the same as darkenPixel()
+            memcpy(dst, src, m_pixelSize);
+        }
+    } while (srcIt.nextPixel() && touchedIt.nextPixel() && dstIt.nextPixel());
+}
+
+void HairyBrush::testingSetParallelPainting(bool value)
+{
+    m_parallelPainting = value;
 }
 
 
@@ -252,7 +445,7 @@ inline qreal HairyBrush::fetchInkDepletion(Bristle* bristle, int inkDepletionSiz
 }
 
 
-void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation)
+void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation, KoColorTransformation *transfo)
 {
     qreal saturation;
     if (m_properties->useWeights) {
@@ -272,12 +465,12 @@ void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, q
                          (1.0 - inkDeplation)) - 1.0;
 
     }
-	m_transfo->setParameter(m_transfo->parameterId("h"), 0.0);
-	m_transfo->setParameter(m_transfo->parameterId("v"), 0.0);
-    m_transfo->setParameter(m_saturationId, saturation);
-	m_transfo->setParameter(3, 1);//sets the type to
-	m_transfo->setParameter(4, false);//sets the colorize to none.
-    m_transfo->transform(bristleColor.data(), bristleColor.data() , 1);
+	transfo->setParameter(transfo->parameterId("h"), 0.0);
+	transfo->setParameter(transfo->parameterId("v"), 0.0);
+    transfo->setParameter(m_saturationId, saturation);
+	transfo->setParameter(3, 1);//sets the type to
+	transfo->setParameter(4, false);//sets the colorize to none.
+    transfo->transform(bristleColor.data(), bristleColor.data() , 1);
 }
 
 void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal pressure, qreal inkDeplation)
@@ -299,29 +492,29 @@ void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal
     bristleColor.setOpacity(opacity);
 }
 
-inline void HairyBrush::addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color)
+inline void HairyBrush::addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color, PaintContext *context)
 {
     Q_UNUSED(bristle);
     if (m_properties->antialias) {
         if (m_properties->useCompositing) {
-            paintParticle(pos, color);
+            paintParticle(pos, color, context);
         } else {
-            paintParticle(pos, color, 1.0);
+            paintParticle(pos, color, 1.0, context);
         }
     }
     else {
         int ix = qRound(pos.x());
         int iy = qRound(pos.y());
         if (m_properties->useCompositing) {
-            plotPixel(ix, iy, color);
+            plotPixel(ix, iy, color, context);
         }
         else {
-            darkenPixel(ix, iy, color);
+            darkenPixel(ix, iy, color, context);
         }
     }
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
+void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight, PaintContext *context)
 {
     // opacity top left, right, bottom left, right
     quint8 opacity = color.opacityU8();
@@ -337,33 +530,39 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    const KoColorSpace * cs = m_dab->colorSpace();
-
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
-
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    const KoColorSpace * cs = context->dab->colorSpace();
+    KisRandomAccessorNG *dabAccessor = context->dabAccessor.data();
+
+    dabAccessor->moveTo(ipx  , ipy);
+    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(dabAccessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(dabAccessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(dabAccessor->rawData(), btl, 1);
+    markTouched(ipx, ipy, context);
+
+    dabAccessor->moveTo(ipx + 1, ipy);
+    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(dabAccessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(dabAccessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(dabAccessor->rawData(), btr, 1);
+    markTouched(ipx + 1, ipy, context);
+
+    dabAccessor->moveTo(ipx, ipy + 1);
+    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(dabAccessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(dabAccessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(dabAccessor->rawData(), bbl, 1);
+    markTouched(ipx, ipy + 1, context);
+
+    dabAccessor->moveTo(ipx + 1, ipy + 1);
+    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(dabAccessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(dabAccessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(dabAccessor->rawData(), bbr, 1);
+    markTouched(ipx + 1, ipy + 1, context);
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
+void HairyBrush::paintParticle(QPointF pos, const KoColor& color, PaintContext *context)
 {
     // opacity top left, right, bottom left, right
-    memcpy(m_color.data(), color.data(), m_pixelSize);
+    KoColor &particleColor = context->color;
+    memcpy(particleColor.data(), color.data(), m_pixelSize);
     quint8 opacity = color.opacityU8();
 
     int ipx = int (pos.x());
@@ -376,34 +575,43 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    m_color.setOpacity(btl);
-    plotPixel(ipx  , ipy, m_color);
+    particleColor.setOpacity(btl);
+    plotPixel(ipx  , ipy, particleColor, context);
 
-    m_color.setOpacity(btr);
-    plotPixel(ipx + 1  , ipy, m_color);
+    particleColor.setOpacity(btr);
+    plotPixel(ipx + 1  , ipy, particleColor, context);
 
-    m_color.setOpacity(bbl);
-    plotPixel(ipx  , ipy + 1, m_color);
+    particleColor.setOpacity(bbl);
+    plotPixel(ipx  , ipy + 1, particleColor, context);
 
-    m_color.setOpacity(bbr);
-    plotPixel(ipx + 1 , ipy + 1, m_color);
+    particleColor.setOpacity(bbr);
+    plotPixel(ipx + 1 , ipy + 1, particleColor, context);
 }
 
 
-inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color, PaintContext *context)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
+    context->dabAccessor->moveTo(wx, wy);
+    m_compositeOp->composite(context->dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
 }
 
-inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color, PaintContext *context)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
+    context->dabAccessor->moveTo(wx, wy);
+    if (context->dab->colorSpace()->opacityU8(context->dabAccessor->rawData()) < color.opacityU8()) {
+        memcpy(context->dabAccessor->rawData(), color.data(), m_pixelSize);
+        markTouched(wx, wy, context);
     }
 }
 
+inline void HairyBrush::markTouched(int wx, int wy, PaintContext *context)
+{
+    if (!context->touchedAccessor) return;
+
+    context->touchedAccessor->moveTo(wx, wy);
+    *context->touchedAccessor->rawData() = MAX_SELECTED;
+}
+
 double HairyBrush::computeMousePressure(double distance)
 {
     static const double scale = 20.0;
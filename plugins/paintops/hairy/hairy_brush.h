@@ -85,17 +85,32 @@ public:
     /// set the shape of the bristles according the dab
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
 
+    /// lets the tests compare the parallel painting with the serial one
+    void testingSetParallelPainting(bool value);
+
 private:
+    struct BristleSegment;
+    struct PaintContext;
+
+    /// paints the path of a single bristle between two dabs
+    void paintBristleSegment(const BristleSegment &segment, qreal pressure, PaintContext *context);
+    /// paints the segments in chunks on the worker threads and merges the results into the dab
+    void paintSegmentsParallel(const QVector<BristleSegment> &segments, qreal pressure, KisPaintDeviceSP dab);
+    /// merges a chunk painted separately into the dab the same way the pixels would have been painted
+    void mergeChunk(PaintContext *context, KisPaintDeviceSP dab);
+
     /// paints single bristle
-    void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
+    void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color, PaintContext *context);
     /// composite single pixel to dab
-    void plotPixel(int wx, int wy, const KoColor &color);
+    void plotPixel(int wx, int wy, const KoColor &color, PaintContext *context);
     /// check the opacity of dab pixel and if the opacity is less then color, it will copy color to dab
-    void darkenPixel(int wx, int wy, const KoColor &color);
+    void darkenPixel(int wx, int wy, const KoColor &color, PaintContext *context);
+    /// remembers the pixel painted by a chunk of the parallel painting
+    void markTouched(int wx, int wy, PaintContext *context);
     /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
-    void paintParticle(QPointF pos, const KoColor& color, qreal weight);
+    void paintParticle(QPointF pos, const KoColor& color, qreal weight, PaintContext *context);
     /// paint wu particle using composite operation
-    void paintParticle(QPointF pos, const KoColor& color);
+    void paintParticle(QPointF pos, const KoColor& color, PaintContext *context);
     /// similar to sample input color in spray
     void colorifyBristles(KisPaintDeviceSP source, QPointF point);
 
@@ -104,7 +119,7 @@ private:
     double computeMousePressure(double distance);
 
     /// simulate running out of saturation
-    void saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation);
+    void saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation, KoColorTransformation *transfo);
     /// simulate running out of ink through opacity decreasing
     void opacityDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation);
     /// fetch actaul ink status according depletion curve
@@ -118,12 +133,13 @@ private:
     QVector<Bristle*> m_bristles;
     QTransform m_transform;
 
-    // used for interpolation the path of bristles
-    Trajectory m_trajectory;
     QHash<QString, QVariant> m_params;
     // temporary device
     KisPaintDeviceSP m_dab;
-    KisRandomAccessorSP m_dabAccessor;
+    // painting state of the serial path and of every chunk of the parallel one
+    PaintContext *m_mainContext;
+    QVector<PaintContext*> m_chunkContexts;
+    bool m_parallelPainting;
     const KoCompositeOp * m_compositeOp;
     quint32 m_pixelSize;
 
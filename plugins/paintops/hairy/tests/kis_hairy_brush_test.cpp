@@ -0,0 +1,219 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_hairy_brush_test.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_random_source.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+
+#include "hairy_brush.h"
+
+/**
+ * The bristles are taken from a 40x40 dab, so the brush has 1600
+ * of them and paints in several chunks on the worker threads
+ */
+static const int DAB_SIZE = 40;
+
+KisFixedPaintDeviceSP createBristlesDab(const KoColorSpace *cs, bool mixedColors)
+{
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, DAB_SIZE, DAB_SIZE));
+    dab->initialize();
+    dab->fill(0, 0, DAB_SIZE, DAB_SIZE, KoColor(Qt::red, cs).data());
+
+    const KoColor black(Qt::black, cs);
+
+    // the opacity of the dab pixels defines the length of the bristles
+    quint8 *pixel = dab->data();
+    for (int y = 0; y < DAB_SIZE; y++) {
+        for (int x = 0; x < DAB_SIZE; x++) {
+            if (mixedColors && (x + y) % 2) {
+                memcpy(pixel, black.data(), cs->pixelSize());
+            }
+            cs->setOpacity(pixel, quint8(1 + (x * 7 + y * 13) % 255), 1);
+            pixel += cs->pixelSize();
+        }
+    }
+
+    return dab;
+}
+
+KisHairyProperties createProperties(bool antialias)
+{
+    KisHairyProperties properties;
+
+    properties.radius = DAB_SIZE / 2;
+    properties.inkAmount = 256;
+    properties.sigma = 1.0;
+    properties.inkDepletionEnabled = true;
+    for (int i = 0; i < properties.inkAmount; i++) {
+        properties.inkDepletionCurve << qreal(i) / properties.inkAmount;
+    }
+    properties.isbrushDimension1D = false;
+    properties.useMousePressure = false;
+    properties.useSaturation = false;
+    properties.useOpacity = true;
+    properties.useWeights = false;
+
+    properties.useSoakInk = false;
+    properties.connectedPath = true;
+    properties.antialias = antialias;
+    properties.useCompositing = false;
+
+    properties.pressureWeight = 50;
+    properties.bristleLengthWeight = 50;
+    properties.bristleInkAmountWeight = 50;
+    properties.inkDepletionWeight = 50;
+
+    properties.shearFactor = 0.3;
+    properties.randomFactor = 2.0;
+    properties.scaleFactor = 1.0;
+    properties.threshold = false;
+
+    return properties;
+}
+
+KisPaintDeviceSP paintStroke(KisHairyProperties *properties, bool parallel, int seed,
+                             bool mixedColors = false)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    HairyBrush brush;
+    brush.fromDabWithDensity(createBristlesDab(cs, mixedColors), 1.0);
+    brush.setInkColor(KoColor(Qt::red, cs));
+    brush.setProperties(properties);
+    brush.testingSetParallelPainting(parallel);
+
+    KisPaintDeviceSP dab = new KisPaintDevice(cs);
+    KisRandomSourceSP randomSource = new KisRandomSource(seed);
+
+    QPointF pos(100.0, 100.0);
+
+    for (int i = 0; i < 10; i++) {
+        KisPaintInformation pi1(pos, 0.7);
+        pos += QPointF(7.0, 3.0);
+        KisPaintInformation pi2(pos, 0.7);
+
+        pi1.setRandomSource(randomSource);
+        pi2.setRandomSource(randomSource);
+
+        brush.paintLine(dab, KisPaintDeviceSP(), pi1, pi2, 1.0, 0.1 * i);
+    }
+
+    return dab;
+}
+
+bool compareDevices(QPoint &pt, KisPaintDeviceSP dev1, KisPaintDeviceSP dev2)
+{
+    const QRect rc = dev1->extent() | dev2->extent();
+    const int pixelSize = dev1->pixelSize();
+
+    KisSequentialConstIterator it1(dev1, rc);
+    KisSequentialConstIterator it2(dev2, rc);
+
+    do {
+        if (memcmp(it1.rawDataConst(), it2.rawDataConst(), pixelSize)) {
+            pt = QPoint(it1.x(), it1.y());
+            return false;
+        }
+    } while (it1.nextPixel() && it2.nextPixel());
+
+    return true;
+}
+
+void KisHairyBrushTest::testDeterminism()
+{
+    KisHairyProperties properties = createProperties(true);
+
+    KisPaintDeviceSP dev1 = paintStroke(&properties, true, 1);
+    KisPaintDeviceSP dev2 = paintStroke(&properties, true, 1);
+
+    QVERIFY(!dev1->exactBounds().isEmpty());
+    QPoint pt;
+    QVERIFY2(compareDevices(pt, dev1, dev2),
+             QString("Devices differ at (%1, %2)").arg(pt.x()).arg(pt.y()).toLatin1());
+}
+
+void KisHairyBrushTest::testParallelDarken()
+{
+    KisHairyProperties properties = createProperties(false);
+
+    KisPaintDeviceSP serial = paintStroke(&properties, false, 1);
+    KisPaintDeviceSP parallel = paintStroke(&properties, true, 1);
+
+    QVERIFY(!serial->exactBounds().isEmpty());
+    QPoint pt;
+    QVERIFY2(compareDevices(pt, serial, parallel),
+             QString("Devices differ at (%1, %2)").arg(pt.x()).arg(pt.y()).toLatin1());
+}
+
+void KisHairyBrushTest::testParallelWuParticles()
+{
+    KisHairyProperties properties = createProperties(true);
+
+    KisPaintDeviceSP serial = paintStroke(&properties, false, 1);
+    KisPaintDeviceSP parallel = paintStroke(&properties, true, 1);
+
+    QVERIFY(!serial->exactBounds().isEmpty());
+    QPoint pt;
+    QVERIFY2(compareDevices(pt, serial, parallel),
+             QString("Devices differ at (%1, %2)").arg(pt.x()).arg(pt.y()).toLatin1());
+}
+
+void KisHairyBrushTest::testParallelWuParticlesMixedColors()
+{
+    /**
+     * Some of the particles get the opacity rounded to zero. With the
+     * black bristles such a pixel looks exactly like an untouched one,
+     * but it still changes the color of the pixel
+     */
+    KisHairyProperties properties = createProperties(true);
+
+    KisPaintDeviceSP serial = paintStroke(&properties, false, 1, true);
+    KisPaintDeviceSP parallel = paintStroke(&properties, true, 1, true);
+
+    QVERIFY(!serial->exactBounds().isEmpty());
+    QPoint pt;
+    QVERIFY2(compareDevices(pt, serial, parallel),
+             QString("Devices differ at (%1, %2)").arg(pt.x()).arg(pt.y()).toLatin1());
+}
+
+void KisHairyBrushTest::testParallelCompositing()
+{
+    KisHairyProperties properties = createProperties(true);
+    properties.useCompositing = true;
+
+    KisPaintDeviceSP serial = paintStroke(&properties, false, 1);
+    KisPaintDeviceSP parallel = paintStroke(&properties, true, 1);
+
+    QVERIFY(!serial->exactBounds().isEmpty());
+    QPoint pt;
+    QVERIFY2(compareDevices(pt, serial, parallel),
+             QString("Devices differ at (%1, %2)").arg(pt.x()).arg(pt.y()).toLatin1());
+}
+
+QTEST_MAIN(KisHairyBrushTest)
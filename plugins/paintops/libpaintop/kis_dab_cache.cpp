@@ -19,6 +19,7 @@
 #include "kis_dab_cache.h"
 
 #include <KoColor.h>
+#include <KoColorSpace.h>
 #include "kis_color_source.h"
 #include "kis_paint_device.h"
 #include "kis_brush.h"
@@ -27,10 +28,15 @@
 #include <kis_texture_option.h>
 #include <kis_precision_option.h>
 #include <kis_fixed_paint_device.h>
+#include <kis_global.h>
 #include <brushengine/kis_paintop.h>
 
 #include <kundo2command.h>
 
+#include <list>
+#include <cmath>
+#include <QHash>
+
 struct PrecisionValues {
     qreal angle;
     qreal sizeFrac;
@@ -74,6 +80,78 @@ struct KisDabCache::SavedDabParameters {
     }
 };
 
+/**
+ * The key of the LRU cache: the dab parameters quantized with the
+ * steps of the precision level \p level (-1 stands for the custom
+ * steps)
+ */
+struct DabCacheKey {
+    KoColor color;
+    int level;
+    qint64 angle;
+    int width;
+    int height;
+    qint64 subPixelX;
+    qint64 subPixelY;
+    qint64 softnessFactor;
+    int index;
+    bool horizontalMirror;
+    bool verticalMirror;
+
+    bool operator==(const DabCacheKey &rhs) const {
+        return color == rhs.color &&
+               level == rhs.level &&
+               angle == rhs.angle &&
+               width == rhs.width &&
+               height == rhs.height &&
+               subPixelX == rhs.subPixelX &&
+               subPixelY == rhs.subPixelY &&
+               softnessFactor == rhs.softnessFactor &&
+               index == rhs.index &&
+               horizontalMirror == rhs.horizontalMirror &&
+               verticalMirror == rhs.verticalMirror;
+    }
+};
+
+inline uint qHash(const DabCacheKey &key)
+{
+    uint colorHash = 0;
+    if (key.color.colorSpace()) {
+        colorHash = qHash(QByteArray::fromRawData(reinterpret_cast<const char*>(key.color.data()),
+                                                  key.color.colorSpace()->pixelSize()));
+    }
+
+    return colorHash ^
+        qHash(key.angle) ^
+        (qHash(key.width) << 8) ^
+        (qHash(key.height) << 16) ^
+        (qHash(key.subPixelX) << 4) ^
+        (qHash(key.subPixelY) << 12) ^
+        (qHash(key.softnessFactor) << 20) ^
+        (qHash(key.index) << 24) ^
+        (uint(key.level) << 28) ^
+        (uint(key.horizontalMirror) << 30) ^
+        (uint(key.verticalMirror) << 31);
+}
+
+inline qint64 quantizeValue(qreal value, qreal step)
+{
+    return qint64(std::floor(value / qMax(step, eps)));
+}
+
+inline int quantizeSize(int size, qreal sizeFrac)
+{
+    return sizeFrac > 0 ?
+        int(std::floor(std::log(qreal(qMax(size, 1))) / std::log(1.0 + sizeFrac))) :
+        size;
+}
+
+struct DabCacheEntry {
+    DabCacheKey key;
+    KisFixedPaintDeviceSP dab;
+    qint64 bytes;
+};
+
 struct KisDabCache::Private {
 
     Private(KisBrushSP brush)
@@ -83,10 +161,28 @@ struct KisDabCache::Private {
           textureOption(0),
           precisionOption(0),
           subPixelPrecisionDisabled(false),
-          cachedDabParameters(new SavedDabParameters)
+          cachedDabParameters(new SavedDabParameters),
+          useCustomSteps(false),
+          cacheColorSpace(0),
+          memoryBudget(32 * 1024 * 1024),
+          memoryUsed(0),
+          numRequests(0),
+          numHits(0)
     {}
+
+    typedef std::list<DabCacheEntry> EntriesList;
+
+    /**
+     * The working device for the dabs that are post-processed or
+     * colorized by a non-uniform color source. It is never shared
+     * with the cache.
+     */
     KisFixedPaintDeviceSP dab;
-    KisFixedPaintDeviceSP dabOriginal;
+
+    /**
+     * The last generated or fetched dab, not post-processed
+     */
+    KisFixedPaintDeviceSP lastDab;
 
     KisBrushSP brush;
     KisPaintDeviceSP colorSourceDevice;
@@ -98,6 +194,57 @@ struct KisDabCache::Private {
     bool subPixelPrecisionDisabled;
 
     SavedDabParameters *cachedDabParameters;
+
+    bool useCustomSteps;
+    QuantizationSteps customSteps;
+
+    const KoColorSpace *cacheColorSpace;
+
+    // the most recently used entries go first
+    EntriesList entries;
+    QHash<DabCacheKey, EntriesList::iterator> entriesHash;
+
+    qint64 memoryBudget;
+    qint64 memoryUsed;
+
+    qint64 numRequests;
+    qint64 numHits;
+
+    int precisionLevel() const {
+        return precisionOption ? precisionOption->precisionLevel() - 1 : 3;
+    }
+
+    DabCacheKey cacheKey(const SavedDabParameters &params) const {
+        const int level = precisionLevel();
+        const PrecisionValues &prec = precisionLevels[level];
+
+        const qreal angleStep = useCustomSteps ? customSteps.angle : prec.angle;
+        const qreal sizeFrac = useCustomSteps ? customSteps.sizeFrac : prec.sizeFrac;
+        const qreal subPixelStep = useCustomSteps ? customSteps.subPixel : prec.subPixel;
+        const qreal softnessStep = useCustomSteps ? customSteps.softnessFactor : prec.softnessFactor;
+
+        DabCacheKey key;
+        key.color = params.color;
+        key.level = useCustomSteps ? -1 : level;
+        key.angle = quantizeValue(normalizeAngle(params.angle), angleStep);
+        key.width = quantizeSize(params.width, sizeFrac);
+        key.height = quantizeSize(params.height, sizeFrac);
+        key.subPixelX = quantizeValue(params.subPixelX, subPixelStep);
+        key.subPixelY = quantizeValue(params.subPixelY, subPixelStep);
+        key.softnessFactor = quantizeValue(params.softnessFactor, softnessStep);
+        key.index = params.index;
+        key.horizontalMirror = params.mirrorProperties.horizontalMirror;
+        key.verticalMirror = params.mirrorProperties.verticalMirror;
+
+        return key;
+    }
+
+    void clearCache() {
+        entries.clear();
+        entriesHash.clear();
+        memoryUsed = 0;
+        lastDab = 0;
+    }
 };
 
 
@@ -138,6 +285,28 @@ void KisDabCache::disableSubpixelPrecision()
     m_d->subPixelPrecisionDisabled = true;
 }
 
+void KisDabCache::setQuantizationSteps(const QuantizationSteps &steps)
+{
+    m_d->useCustomSteps = true;
+    m_d->customSteps = steps;
+}
+
+void KisDabCache::setMemoryBudget(qint64 bytes)
+{
+    m_d->memoryBudget = bytes;
+    evictCachedDabs(0);
+}
+
+qint64 KisDabCache::memoryBudget() const
+{
+    return m_d->memoryBudget;
+}
+
+qreal KisDabCache::hitRate() const
+{
+    return m_d->numRequests ? qreal(m_d->numHits) / m_d->numRequests : 0.0;
+}
+
 inline KisDabCache::SavedDabParameters
 KisDabCache::getDabParameters(const KoColor& color,
                               double scaleX, double scaleY,
@@ -228,27 +397,77 @@ QRect KisDabCache::correctDabRectWhenFetchedFromCache(const QRect &dabRect,
 }
 
 inline
-KisFixedPaintDeviceSP KisDabCache::tryFetchFromCache(const SavedDabParameters &params,
-        const KisPaintInformation& info,
-        QRect *dstDabRect)
+KisFixedPaintDeviceSP KisDabCache::findCachedDab(const SavedDabParameters &params)
 {
-    int precisionLevel = m_d->precisionOption ? m_d->precisionOption->precisionLevel() - 1 : 3;
+    const int precisionLevel = m_d->precisionLevel();
 
-    if (!params.compare(*m_d->cachedDabParameters, precisionLevel)) {
-        return 0;
+    if (m_d->lastDab && params.compare(*m_d->cachedDabParameters, precisionLevel)) {
+        return m_d->lastDab;
     }
 
-    if (needSeparateOriginal()) {
-        *m_d->dab = *m_d->dabOriginal;
-        *dstDabRect = correctDabRectWhenFetchedFromCache(*dstDabRect, m_d->dab->bounds().size());
-        postProcessDab(m_d->dab, dstDabRect->topLeft(), info);
-    }
-    else {
-        *dstDabRect = correctDabRectWhenFetchedFromCache(*dstDabRect, m_d->dab->bounds().size());
+    if (m_d->entries.empty()) return 0;
+
+    DabCacheKey key = m_d->cacheKey(params);
+
+    QHash<DabCacheKey, Private::EntriesList::iterator>::iterator it =
+        m_d->entriesHash.find(key);
+
+    if (it == m_d->entriesHash.end()) return 0;
+
+    // move the entry to the head of the list
+    m_d->entries.splice(m_d->entries.begin(), m_d->entries, it.value());
+
+    *m_d->cachedDabParameters = params;
+    m_d->lastDab = it.value()->dab;
+
+    return m_d->lastDab;
+}
+
+inline
+void KisDabCache::addCachedDab(const SavedDabParameters &params, KisFixedPaintDeviceSP dab)
+{
+    *m_d->cachedDabParameters = params;
+    m_d->lastDab = dab;
+
+    const QRect bounds = dab->bounds();
+    const qint64 bytes = qint64(bounds.width()) * bounds.height() * dab->pixelSize();
+
+    if (bytes > m_d->memoryBudget) return;
+
+    DabCacheKey key = m_d->cacheKey(params);
+
+    QHash<DabCacheKey, Private::EntriesList::iterator>::iterator it =
+        m_d->entriesHash.find(key);
+
+    if (it != m_d->entriesHash.end()) {
+        m_d->memoryUsed -= it.value()->bytes;
+        m_d->entries.erase(it.value());
+        m_d->entriesHash.erase(it);
     }
 
-    m_d->brush->notifyCachedDabPainted(info);
-    return m_d->dab;
+    evictCachedDabs(bytes);
+
+    DabCacheEntry entry;
+    entry.key = key;
+    entry.dab = dab;
+    entry.bytes = bytes;
+
+    m_d->entries.push_front(entry);
+    m_d->entriesHash.insert(key, m_d->entries.begin());
+    m_d->memoryUsed += bytes;
+}
+
+inline
+void KisDabCache::evictCachedDabs(qint64 bytesNeeded)
+{
+    while (!m_d->entries.empty() &&
+           m_d->memoryUsed + bytesNeeded > m_d->memoryBudget) {
+
+        const DabCacheEntry &entry = m_d->entries.back();
+        m_d->memoryUsed -= entry.bytes;
+        m_d->entriesHash.remove(entry.key);
+        m_d->entries.pop_back();
+    }
 }
 
 qreal positiveFraction(qreal x) {
@@ -359,21 +578,47 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
     if (!m_d->dab || !(*m_d->dab->colorSpace() == *cs)) {
         m_d->dab = new KisFixedPaintDevice(cs);
     }
-    else if (cachingIsPossible) {
-        KisFixedPaintDeviceSP cachedDab =
-            tryFetchFromCache(newParams, info, dstDabRect);
 
-        if (cachedDab) return cachedDab;
+    if (!m_d->cacheColorSpace || !(*m_d->cacheColorSpace == *cs)) {
+        m_d->clearCache();
+        m_d->cacheColorSpace = cs;
     }
 
+    if (cachingIsPossible) {
+        m_d->numRequests++;
+
+        KisFixedPaintDeviceSP cachedDab = findCachedDab(newParams);
+
+        if (cachedDab) {
+            m_d->numHits++;
+
+            *dstDabRect = correctDabRectWhenFetchedFromCache(*dstDabRect, cachedDab->bounds().size());
+            m_d->brush->notifyCachedDabPainted(info);
+
+            if (!needSeparateOriginal()) {
+                return cachedDab;
+            }
+
+            *m_d->dab = *cachedDab;
+            postProcessDab(m_d->dab, dstDabRect->topLeft(), info);
+            return m_d->dab;
+        }
+    }
+
+    KisFixedPaintDeviceSP dab;
+
     if (m_d->brush->brushType() == IMAGE || m_d->brush->brushType() == PIPE_IMAGE) {
-        m_d->dab = m_d->brush->paintDevice(cs, scaleX, position.realAngle, info,
-                                           position.subPixel.x(),
-                                           position.subPixel.y());
+        dab = m_d->brush->paintDevice(cs, scaleX, position.realAngle, info,
+                                      position.subPixel.x(),
+                                      position.subPixel.y());
     }
     else if (cachingIsPossible) {
-        *m_d->cachedDabParameters = newParams;
-        m_d->brush->mask(m_d->dab, paintColor, scaleX, scaleY, position.realAngle,
+        /**
+         * The cached dabs are shared with the callers, so every
+         * new dab gets its own device
+         */
+        dab = new KisFixedPaintDevice(cs);
+        m_d->brush->mask(dab, paintColor, scaleX, scaleY, position.realAngle,
                          info,
                          position.subPixel.x(), position.subPixel.y(),
                          softnessFactor);
@@ -390,28 +635,30 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
         colorSource->colorize(m_d->colorSourceDevice, maskRect, info.pos().toPoint());
         delete m_d->colorSourceDevice->convertTo(cs);
 
-        m_d->brush->mask(m_d->dab, m_d->colorSourceDevice, scaleX, scaleY, position.realAngle,
+        dab = m_d->dab;
+        m_d->brush->mask(dab, m_d->colorSourceDevice, scaleX, scaleY, position.realAngle,
                          info,
                          position.subPixel.x(), position.subPixel.y(),
                          softnessFactor);
     }
 
     if (!mirrorProperties.isEmpty()) {
-        m_d->dab->mirror(mirrorProperties.horizontalMirror,
-                         mirrorProperties.verticalMirror);
+        dab->mirror(mirrorProperties.horizontalMirror,
+                    mirrorProperties.verticalMirror);
     }
 
-    if (needSeparateOriginal()) {
-        if (!m_d->dabOriginal || !(*cs == *m_d->dabOriginal->colorSpace())) {
-            m_d->dabOriginal = new KisFixedPaintDevice(cs);
-        }
+    if (cachingIsPossible) {
+        addCachedDab(newParams, dab);
 
-        *m_d->dabOriginal = *m_d->dab;
+        if (needSeparateOriginal()) {
+            *m_d->dab = *dab;
+            dab = m_d->dab;
+        }
     }
 
-    postProcessDab(m_d->dab, position.rect.topLeft(), info);
+    postProcessDab(dab, position.rect.topLeft(), info);
 
-    return m_d->dab;
+    return dab;
 }
 
 void KisDabCache::postProcessDab(KisFixedPaintDeviceSP dab,
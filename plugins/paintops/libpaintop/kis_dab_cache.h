@@ -48,6 +48,12 @@ struct MirrorProperties;
  *  level.
  *
  *  The texturing and mirroring problems are solved.
+ *
+ *  Apart from the last dab, the cache keeps a bounded LRU list of
+ *  recently generated dabs. Their parameters are quantized with the
+ *  steps of the current precision level (or the ones passed to
+ *  setQuantizationSteps()), so the dabs with jittering size or
+ *  rotation can be reused instead of being regenerated every time.
  */
 class PAINTOP_EXPORT KisDabCache
 {
@@ -70,6 +76,39 @@ public:
 
     bool needSeparateOriginal();
 
+    /**
+     * Quantization steps for the keys of the LRU cache. \p sizeFrac
+     * is relative to the size of the dab, zero steps mean the value
+     * should match exactly.
+     */
+    struct QuantizationSteps {
+        QuantizationSteps()
+            : angle(0), sizeFrac(0), subPixel(0), softnessFactor(0) {}
+
+        qreal angle;
+        qreal sizeFrac;
+        qreal subPixel;
+        qreal softnessFactor;
+    };
+
+    /**
+     * Overrides the quantization steps derived from the precision level
+     */
+    void setQuantizationSteps(const QuantizationSteps &steps);
+
+    /**
+     * Sets the maximum amount of memory the cached dabs may occupy.
+     * Zero disables the LRU cache, only the last dab is reused then.
+     */
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+
+    /**
+     * @return the portion of the requests for cacheable dabs that were
+     *         served from the cache
+     */
+    qreal hitRate() const;
+
     KisFixedPaintDeviceSP fetchDab(const KoColorSpace *cs,
                                    const KisColorSource *colorSource,
                                    const QPointF &cursorPoint,
@@ -111,9 +150,9 @@ private:
     QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
             const QSize &realDabSize);
 
-    inline KisFixedPaintDeviceSP tryFetchFromCache(const SavedDabParameters &params,
-            const KisPaintInformation& info,
-            QRect *dstDabRect);
+    inline KisFixedPaintDeviceSP findCachedDab(const SavedDabParameters &params);
+    inline void addCachedDab(const SavedDabParameters &params, KisFixedPaintDeviceSP dab);
+    inline void evictCachedDabs(qint64 bytesNeeded);
 
     inline KisFixedPaintDeviceSP fetchDabCommon(const KoColorSpace *cs,
             const KisColorSource *colorSource,
@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_dab_rendering_queue.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QVector>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "kis_dab_cache.h"
+
+
+namespace {
+
+struct Job {
+    Job(const KisDabRenderingQueue::Request &_request)
+        : request(_request),
+          isFinished(false)
+    {
+    }
+
+    KisDabRenderingQueue::Request request;
+    KisDabRenderingQueue::RenderedDab result;
+    bool isFinished;
+};
+
+typedef QSharedPointer<Job> JobSP;
+
+struct Worker {
+    Worker(KisBrushSP _brush, KisPrecisionOption *precisionOption, int numWorkers)
+        : brush(_brush),
+          dabCache(new KisDabCache(_brush)),
+          isRunning(false)
+    {
+        dabCache->setPrecisionOption(precisionOption);
+
+        /**
+         * The workers share the memory a single cache would use
+         */
+        dabCache->setMemoryBudget(dabCache->memoryBudget() / numWorkers);
+    }
+
+    ~Worker() {
+        delete dabCache;
+    }
+
+    KisBrushSP brush;
+    KisDabCache *dabCache;
+    QQueue<JobSP> jobs;
+    bool isRunning;
+};
+
+}
+
+struct KisDabRenderingQueue::Private
+{
+    Private() : nextWorker(0) {}
+
+    QVector<Worker*> workers;
+    int nextWorker;
+
+    /**
+     * All the jobs in the order of the stroke. Accessed by the stroke
+     * thread only, the workers see the jobs through their own queues.
+     */
+    QQueue<JobSP> jobs;
+
+    /**
+     * Guards the worker queues and the state of the jobs
+     */
+    QMutex mutex;
+    QWaitCondition jobFinished;
+
+    void processJobs(Worker *worker);
+};
+
+KisDabRenderingQueue::KisDabRenderingQueue(KisBrushSP brush, KisPrecisionOption *precisionOption, int numWorkers)
+    : m_d(new Private)
+{
+    numWorkers = qMax(1, numWorkers);
+
+    for (int i = 0; i < numWorkers; i++) {
+        KisBrushSP workerBrush(brush->clone());
+        workerBrush->notifyStrokeStarted();
+        m_d->workers << new Worker(workerBrush, precisionOption, numWorkers);
+    }
+}
+
+KisDabRenderingQueue::~KisDabRenderingQueue()
+{
+    {
+        /**
+         * The workers run in the global thread pool, so we cannot
+         * wait for the pool itself, only for our own workers
+         */
+        QMutexLocker l(&m_d->mutex);
+
+        Q_FOREACH (Worker *worker, m_d->workers) {
+            while (worker->isRunning) {
+                m_d->jobFinished.wait(&m_d->mutex);
+            }
+        }
+    }
+
+    qDeleteAll(m_d->workers);
+    delete m_d;
+}
+
+void KisDabRenderingQueue::addDab(const Request &request)
+{
+    JobSP job(new Job(request));
+    m_d->jobs.enqueue(job);
+
+    Worker *worker = m_d->workers[m_d->nextWorker];
+    m_d->nextWorker = (m_d->nextWorker + 1) % m_d->workers.size();
+
+    QMutexLocker l(&m_d->mutex);
+    worker->jobs.enqueue(job);
+
+    if (!worker->isRunning) {
+        worker->isRunning = true;
+        QtConcurrent::run(QThreadPool::globalInstance(), m_d, &Private::processJobs, worker);
+    }
+}
+
+bool KisDabRenderingQueue::hasPendingDabs() const
+{
+    return !m_d->jobs.isEmpty();
+}
+
+bool KisDabRenderingQueue::isFirstDabReady() const
+{
+    if (m_d->jobs.isEmpty()) return false;
+
+    QMutexLocker l(&m_d->mutex);
+    return m_d->jobs.head()->isFinished;
+}
+
+bool KisDabRenderingQueue::isFull() const
+{
+    return m_d->jobs.size() >= 2 * m_d->workers.size();
+}
+
+KisDabRenderingQueue::RenderedDab KisDabRenderingQueue::takeFirstDab()
+{
+    Q_ASSERT(!m_d->jobs.isEmpty());
+    JobSP job = m_d->jobs.dequeue();
+
+    QMutexLocker l(&m_d->mutex);
+    while (!job->isFinished) {
+        m_d->jobFinished.wait(&m_d->mutex);
+    }
+
+    return job->result;
+}
+
+KisPaintInformation KisDabRenderingQueue::detachedPaintInformation(const KisPaintInformation &info)
+{
+    KisPaintInformation result(info.pos(),
+                               info.pressure(),
+                               info.xTilt(),
+                               info.yTilt(),
+                               info.rotation(),
+                               info.tangentialPressure(),
+                               info.perspective(),
+                               info.currentTime(),
+                               info.drawingSpeed());
+
+    result.setCanvasRotation(info.canvasRotation());
+    result.setCanvasHorizontalMirrorState(info.canvasMirroredH());
+
+    return result;
+}
+
+void KisDabRenderingQueue::Private::processJobs(Worker *worker)
+{
+    QMutexLocker l(&mutex);
+
+    while (!worker->jobs.isEmpty()) {
+        JobSP job = worker->jobs.dequeue();
+        l.unlock();
+
+        const Request &request = job->request;
+
+        QRect dabRect;
+        KisFixedPaintDeviceSP dab =
+            worker->dabCache->fetchDab(request.colorSpace,
+                                       request.color,
+                                       request.cursorPoint,
+                                       request.scale, request.scale,
+                                       request.rotation,
+                                       request.info,
+                                       request.softness,
+                                       &dabRect);
+
+        /**
+         * The cache reuses its device for the next dab of the worker,
+         * so the result should get a copy of it
+         */
+        job->result.device = new KisFixedPaintDevice(*dab);
+        job->result.rect = dabRect;
+        job->result.opacity = request.opacity;
+        job->result.flow = request.flow;
+
+        l.relock();
+        job->isFinished = true;
+        jobFinished.wakeAll();
+    }
+
+    worker->isRunning = false;
+    jobFinished.wakeAll();
+}
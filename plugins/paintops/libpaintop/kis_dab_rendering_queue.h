@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_DAB_RENDERING_QUEUE_H
+#define __KIS_DAB_RENDERING_QUEUE_H
+
+#include <QPointF>
+#include <QRect>
+
+#include <KoColor.h>
+
+#include "kritapaintop_export.h"
+#include "kis_brush.h"
+#include <kis_fixed_paint_device.h>
+#include <brushengine/kis_paint_information.h>
+
+class KisPrecisionOption;
+
+
+/**
+ * @brief The KisDabRenderingQueue class renders the dabs of a brush
+ * based paintop on worker threads
+ *
+ * The paintop computes all the parameters of a dab on the stroke
+ * thread and adds it to the queue. The dab is then generated by one
+ * of the workers, while the stroke thread takes the finished dabs
+ * from the head of the queue and composites them in the original
+ * order.
+ *
+ * The workers run in the global thread pool. Every worker owns a clone
+ * of the brush and a separate KisDabCache with its share of the memory
+ * budget of a single cache.
+ * The dabs are assigned to the workers in a round-robin manner, each
+ * worker processes its dabs in order, so the reuse of the cached dabs
+ * does not depend on the scheduling of the threads.
+ *
+ * The workers do not do any dab post-processing, so the queue can
+ * only be used when mirroring, sharpness and texturing are disabled
+ * and the paint color is uniform. The paint information of the
+ * request should be detached from the stroke, see
+ * detachedPaintInformation().
+ *
+ * The queue is used only if enabled in KisImageConfig.
+ */
+class PAINTOP_EXPORT KisDabRenderingQueue
+{
+public:
+    struct Request {
+        const KoColorSpace *colorSpace;
+        KoColor color;
+        QPointF cursorPoint;
+        qreal scale;
+        qreal rotation;
+        qreal softness;
+        KisPaintInformation info;
+        quint8 opacity;
+        quint8 flow;
+    };
+
+    struct RenderedDab {
+        KisFixedPaintDeviceSP device;
+        QRect rect;
+        quint8 opacity;
+        quint8 flow;
+    };
+
+public:
+    KisDabRenderingQueue(KisBrushSP brush, KisPrecisionOption *precisionOption, int numWorkers);
+    ~KisDabRenderingQueue();
+
+    /**
+     * Starts the rendering of a dab
+     */
+    void addDab(const Request &request);
+
+    bool hasPendingDabs() const;
+    bool isFirstDabReady() const;
+
+    /**
+     * The queue should not run too far ahead of the compositing,
+     * otherwise all the memory will be eaten by the finished dabs
+     */
+    bool isFull() const;
+
+    /**
+     * Takes the first dab from the queue, blocks until it is
+     * rendered if needed
+     */
+    RenderedDab takeFirstDab();
+
+    /**
+     * Returns a copy of \p info that can be used on a worker thread.
+     * A plain copy would share the random source and the distance
+     * information with the stroke.
+     */
+    static KisPaintInformation detachedPaintInformation(const KisPaintInformation &info);
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* __KIS_DAB_RENDERING_QUEUE_H */
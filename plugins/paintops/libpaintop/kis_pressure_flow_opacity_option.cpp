@@ -80,12 +80,21 @@ void KisFlowOpacityOption::setOpacity(qreal opacity)
     setValue(opacity);
 }
 
-void KisFlowOpacityOption::apply(KisPainter* painter, const KisPaintInformation& info)
+quint8 KisFlowOpacityOption::getOpacityU8(const KisPaintInformation& info) const
 {
     if (m_paintActionType == WASH && m_nodeHasIndirectPaintingSupport)
-        painter->setOpacityUpdateAverage(quint8(getDynamicOpacity(info) * 255.0));
+        return quint8(getDynamicOpacity(info) * 255.0);
     else
-        painter->setOpacityUpdateAverage(quint8(getStaticOpacity() * getDynamicOpacity(info) * 255.0));
+        return quint8(getStaticOpacity() * getDynamicOpacity(info) * 255.0);
+}
 
-    painter->setFlow(quint8(getFlow() * 255.0));
+quint8 KisFlowOpacityOption::getFlowU8() const
+{
+    return quint8(getFlow() * 255.0);
+}
+
+void KisFlowOpacityOption::apply(KisPainter* painter, const KisPaintInformation& info)
+{
+    painter->setOpacityUpdateAverage(getOpacityU8(info));
+    painter->setFlow(getFlowU8());
 }
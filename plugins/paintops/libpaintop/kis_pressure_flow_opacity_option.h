@@ -45,6 +45,13 @@ public:
     qreal getStaticOpacity() const;
     qreal getDynamicOpacity(const KisPaintInformation& info) const;
 
+    /**
+     * The opacity and flow apply() would set on the painter. Used by
+     * the paintops that composite their dabs later.
+     */
+    quint8 getOpacityU8(const KisPaintInformation& info) const;
+    quint8 getFlowU8() const;
+
 protected:
     qreal m_flow;
     int   m_paintActionType;
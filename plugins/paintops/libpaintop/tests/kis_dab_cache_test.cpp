@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_dab_cache_test.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <brushengine/kis_paint_information.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_auto_brush.h>
+#include <kis_circle_mask_generator.h>
+
+#include "kis_dab_cache.h"
+
+
+KisBrushSP createTestBrush()
+{
+    KisCircleMaskGenerator *generator =
+        new KisCircleMaskGenerator(30, 1.0, 0.5, 0.5, 2, true);
+
+    return new KisAutoBrush(generator, 0.0, 0.0);
+}
+
+KisFixedPaintDeviceSP fetchTestDab(KisDabCache *cache, qreal scale, qreal angle = 0.0)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoColor color(Qt::black, cs);
+
+    KisPaintInformation info(QPointF(100.0, 100.0), 1.0);
+
+    QRect dstRect;
+    return cache->fetchDab(cs, color, info.pos(),
+                           scale, scale, angle,
+                           info, 1.0, &dstRect);
+}
+
+void KisDabCacheTest::testLastDabReuse()
+{
+    KisDabCache cache(createTestBrush());
+
+    KisFixedPaintDeviceSP dab1 = fetchTestDab(&cache, 1.0);
+    KisFixedPaintDeviceSP dab2 = fetchTestDab(&cache, 1.0);
+
+    QCOMPARE(dab1.data(), dab2.data());
+    QCOMPARE(cache.hitRate(), 0.5);
+}
+
+void KisDabCacheTest::testLruReuse()
+{
+    KisDabCache cache(createTestBrush());
+
+    KisFixedPaintDeviceSP dab1 = fetchTestDab(&cache, 1.0);
+    KisFixedPaintDeviceSP dab2 = fetchTestDab(&cache, 0.5);
+
+    QVERIFY(dab1.data() != dab2.data());
+
+    // the sizes alternate, so only the LRU cache can serve them
+    for (int i = 0; i < 4; i++) {
+        QCOMPARE(fetchTestDab(&cache, 1.0).data(), dab1.data());
+        QCOMPARE(fetchTestDab(&cache, 0.5).data(), dab2.data());
+    }
+
+    QCOMPARE(cache.hitRate(), 0.8);
+}
+
+void KisDabCacheTest::testMemoryBudget()
+{
+    KisDabCache cache(createTestBrush());
+    cache.setMemoryBudget(0);
+
+    for (int i = 0; i < 4; i++) {
+        fetchTestDab(&cache, 1.0);
+        fetchTestDab(&cache, 0.5);
+    }
+
+    QCOMPARE(cache.hitRate(), 0.0);
+    QCOMPARE(cache.memoryBudget(), qint64(0));
+}
+
+void KisDabCacheTest::testQuantizationSteps()
+{
+    KisDabCache cache(createTestBrush());
+
+    KisDabCache::QuantizationSteps steps;
+    steps.angle = M_PI / 18;
+    steps.sizeFrac = 0.05;
+    steps.subPixel = 1.0;
+    steps.softnessFactor = 0.01;
+    cache.setQuantizationSteps(steps);
+
+    KisFixedPaintDeviceSP dab1 = fetchTestDab(&cache, 1.0, 0.0);
+    fetchTestDab(&cache, 0.5, 0.0);
+
+    // a slightly jittered dab falls into the same bin as the first one
+    QCOMPARE(fetchTestDab(&cache, 1.0, 0.01).data(), dab1.data());
+}
+
+QTEST_MAIN(KisDabCacheTest)
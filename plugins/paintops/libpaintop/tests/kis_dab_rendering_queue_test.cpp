@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_dab_rendering_queue_test.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <brushengine/kis_paint_information.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_auto_brush.h>
+#include <kis_circle_mask_generator.h>
+
+#include "kis_dab_cache.h"
+#include "kis_dab_rendering_queue.h"
+
+
+void KisDabRenderingQueueTest::testSameAsSerial()
+{
+    KisCircleMaskGenerator *generator =
+        new KisCircleMaskGenerator(30, 1.0, 0.5, 0.5, 2, true);
+    KisBrushSP brush = new KisAutoBrush(generator, 0.0, 0.0);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColor color(Qt::black, cs);
+
+    KisDabRenderingQueue queue(brush, 0, 3);
+
+    KisBrushSP serialBrush(brush->clone());
+    serialBrush->notifyStrokeStarted();
+    KisDabCache serialCache(serialBrush);
+
+    KisDistanceInformation dist;
+
+    QVector<KisFixedPaintDeviceSP> serialDabs;
+    QVector<QRect> serialRects;
+
+    const int numDabs = 20;
+
+    for (int i = 0; i < numDabs; i++) {
+        KisPaintInformation info(QPointF(100.0 + 3.3 * i, 100.0 + 1.7 * i), 0.5);
+        KisPaintInformation::DistanceInformationRegistrar registrar =
+            info.registerDistanceInformation(&dist);
+
+        KisDabRenderingQueue::Request request;
+        request.colorSpace = cs;
+        request.color = color;
+        request.cursorPoint = info.pos();
+        request.scale = 0.5 + 0.1 * (i % 5);
+        request.rotation = 0.3 * (i % 3);
+        request.softness = 1.0;
+        request.info = KisDabRenderingQueue::detachedPaintInformation(info);
+        request.opacity = OPACITY_OPAQUE_U8;
+        request.flow = OPACITY_OPAQUE_U8;
+
+        queue.addDab(request);
+
+        QRect rect;
+        KisFixedPaintDeviceSP dab =
+            serialCache.fetchDab(cs, color, request.cursorPoint,
+                                 request.scale, request.scale,
+                                 request.rotation, info,
+                                 request.softness, &rect);
+
+        // the cache reuses its device for the next dab
+        serialDabs << new KisFixedPaintDevice(*dab);
+        serialRects << rect;
+    }
+
+    for (int i = 0; i < numDabs; i++) {
+        KisDabRenderingQueue::RenderedDab dab = queue.takeFirstDab();
+        KisFixedPaintDeviceSP serialDab = serialDabs[i];
+
+        QCOMPARE(dab.rect, serialRects[i]);
+        QCOMPARE(dab.device->bounds(), serialDab->bounds());
+
+        const int dataSize = serialDab->bounds().width() *
+            serialDab->bounds().height() * serialDab->pixelSize();
+
+        QVERIFY2(!memcmp(dab.device->data(), serialDab->data(), dataSize),
+                 QString("Dab %1 differs from the serial one").arg(i).toLatin1());
+    }
+
+    QVERIFY(!queue.hasPendingDabs());
+}
+
+QTEST_MAIN(KisDabRenderingQueueTest)
@@ -136,6 +136,7 @@ void KisSketchPaintOp::paintLine(const KisPaintInformation &pi1, const KisPaintI
 
     QPointF prevMouse = pi1.pos();
     QPointF mousePosition = pi2.pos();
+    m_pointsGrid.addPoint(mousePosition, m_points.size());
     m_points.append(mousePosition);
 
 
@@ -193,9 +194,25 @@ void KisSketchPaintOp::paintLine(const KisPaintInformation &pi1, const KisPaintI
     QPoint  positionInMask;
     QPointF diff;
 
-    int size = m_points.size();
+    /**
+     * Only the points lying in the neighbourhood of the cursor can be
+     * connected, so fetch them from the grid instead of walking through
+     * the whole stroke history. The indexes come in the order the points
+     * were added, which keeps the usage of the random source unchanged.
+     */
+    QRectF searchRect = m_brushBoundingBox;
+
+    if (m_sketchProperties.simpleMode) {
+        const qreal searchRadius = std::sqrt(thresholdDistance);
+        searchRect = QRectF(mousePosition.x() - searchRadius,
+                            mousePosition.y() - searchRadius,
+                            2 * searchRadius, 2 * searchRadius);
+    }
+
+    m_pointsGrid.queryRect(searchRect, &m_nearbyPoints);
+
     // MAIN LOOP
-    for (int i = 0; i < size; i++) {
+    Q_FOREACH (int i, m_nearbyPoints) {
         diff = m_points.at(i) - mousePosition;
         distance = diff.x() * diff.x() + diff.y() * diff.y();
 
@@ -32,6 +32,7 @@
 #include <kis_pressure_rotation_option.h>
 #include "kis_linewidth_option.h"
 #include "kis_offset_scale_option.h"
+#include "kis_sketch_points_grid.h"
 
 class KisDabCache;
 
@@ -70,6 +71,8 @@ private:
     SketchProperties m_sketchProperties;
 
     QVector<QPointF> m_points;
+    KisSketchPointsGrid m_pointsGrid;
+    QVector<int> m_nearbyPoints;
     int m_count;
     KisPainter * m_painter;
     KisBrushSP m_brush;
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_sketch_points_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+KisSketchPointsGrid::KisSketchPointsGrid(qreal cellSize)
+    : m_cellSize(cellSize)
+{
+}
+
+inline int KisSketchPointsGrid::cellCoordinate(qreal value) const
+{
+    return static_cast<int>(std::floor(value / m_cellSize));
+}
+
+inline quint64 KisSketchPointsGrid::cellKey(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint64(quint32(y));
+}
+
+void KisSketchPointsGrid::addPoint(const QPointF &pt, int index)
+{
+    m_cells[cellKey(cellCoordinate(pt.x()), cellCoordinate(pt.y()))].append(index);
+}
+
+void KisSketchPointsGrid::queryRect(const QRectF &rect, QVector<int> *indexes) const
+{
+    indexes->clear();
+
+    const int left = cellCoordinate(rect.left());
+    const int right = cellCoordinate(rect.right());
+    const int top = cellCoordinate(rect.top());
+    const int bottom = cellCoordinate(rect.bottom());
+
+    /**
+     * A huge query rect may cover more cells than there are in the
+     * grid, in such a case just walk through the existing cells
+     */
+    const qint64 numQueryCells = qint64(right - left + 1) * (bottom - top + 1);
+
+    if (numQueryCells > m_cells.size()) {
+        QHash<quint64, QVector<int> >::const_iterator it = m_cells.constBegin();
+        QHash<quint64, QVector<int> >::const_iterator end = m_cells.constEnd();
+
+        for (; it != end; ++it) {
+            const int x = int(quint32(it.key() >> 32));
+            const int y = int(quint32(it.key()));
+
+            if (x >= left && x <= right && y >= top && y <= bottom) {
+                *indexes += it.value();
+            }
+        }
+    } else {
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++) {
+                QHash<quint64, QVector<int> >::const_iterator it = m_cells.constFind(cellKey(x, y));
+                if (it != m_cells.constEnd()) {
+                    *indexes += it.value();
+                }
+            }
+        }
+    }
+
+    std::sort(indexes->begin(), indexes->end());
+}
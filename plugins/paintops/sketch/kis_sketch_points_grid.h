@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_SKETCH_POINTS_GRID_H
+#define __KIS_SKETCH_POINTS_GRID_H
+
+#include <QHash>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+
+/**
+ * A uniform grid over the points of the sketch stroke history. It
+ * lets the paintop fetch the points lying near the cursor without
+ * iterating through the whole history, which otherwise makes long
+ * strokes quadratic in their length.
+ *
+ * The grid stores only the indexes of the points, the points
+ * themselves are owned by the caller.
+ */
+class KisSketchPointsGrid
+{
+public:
+    KisSketchPointsGrid(qreal cellSize = 64.0);
+
+    void addPoint(const QPointF &pt, int index);
+
+    /**
+     * Fetches the indexes of all the points that might lie inside \p rect.
+     * The result is a superset of the matching points, the caller should
+     * check them itself. The indexes are sorted in ascending order, so the
+     * points are visited in the same order they were added to the stroke.
+     */
+    void queryRect(const QRectF &rect, QVector<int> *indexes) const;
+
+private:
+    inline int cellCoordinate(qreal value) const;
+    inline static quint64 cellKey(int x, int y);
+
+private:
+    qreal m_cellSize;
+    QHash<quint64, QVector<int> > m_cells;
+};
+
+#endif /* __KIS_SKETCH_POINTS_GRID_H */
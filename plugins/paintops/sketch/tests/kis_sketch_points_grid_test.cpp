@@ -0,0 +1,166 @@
+/*
+ *  Copyright (c) 2016 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_sketch_points_grid_test.h"
+
+#include <QTest>
+
+#include <algorithm>
+
+#include "kis_sketch_points_grid.h"
+
+static const qreal CELL_SIZE = 16.0;
+
+QVector<QPointF> randomPoints(int count, const QRectF &area)
+{
+    QVector<QPointF> points;
+
+    qsrand(1);
+    for (int i = 0; i < count; i++) {
+        points << QPointF(area.left() + area.width() * qrand() / RAND_MAX,
+                          area.top() + area.height() * qrand() / RAND_MAX);
+    }
+
+    return points;
+}
+
+void fillGrid(KisSketchPointsGrid *grid, const QVector<QPointF> &points)
+{
+    for (int i = 0; i < points.size(); i++) {
+        grid->addPoint(points[i], i);
+    }
+}
+
+/**
+ * Checks that the indexes returned by the grid are sorted and
+ * contain all the points the brute-force search finds in \p rect
+ */
+bool checkQuery(const KisSketchPointsGrid &grid, const QVector<QPointF> &points,
+                const QRectF &rect, QString *error)
+{
+    QVector<int> indexes;
+    grid.queryRect(rect, &indexes);
+
+    if (!std::is_sorted(indexes.begin(), indexes.end())) {
+        *error = QString("Indexes are not sorted");
+        return false;
+    }
+
+    for (int i = 0; i < points.size(); i++) {
+        const QPointF &pt = points[i];
+
+        if (pt.x() >= rect.left() && pt.x() <= rect.right() &&
+            pt.y() >= rect.top() && pt.y() <= rect.bottom() &&
+            !std::binary_search(indexes.begin(), indexes.end(), i)) {
+
+            *error = QString("Point %1 (%2, %3) is missing from the result")
+                .arg(i).arg(pt.x()).arg(pt.y());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void KisSketchPointsGridTest::testQueryRect()
+{
+    const QVector<QPointF> points = randomPoints(1000, QRectF(0, 0, 300, 200));
+
+    KisSketchPointsGrid grid(CELL_SIZE);
+    fillGrid(&grid, points);
+
+    QString error;
+    for (int i = 0; i < 100; i++) {
+        const QRectF rect(points[i] - QPointF(20, 20), QSizeF(40, 40));
+        QVERIFY2(checkQuery(grid, points, rect, &error), error.toLatin1());
+    }
+
+    QVERIFY2(checkQuery(grid, points, QRectF(150, 100, 5, 5), &error), error.toLatin1());
+    QVERIFY2(checkQuery(grid, points, QRectF(-50, -50, 10, 10), &error), error.toLatin1());
+}
+
+void KisSketchPointsGridTest::testNegativeCoordinates()
+{
+    const QVector<QPointF> points = randomPoints(1000, QRectF(-150, -100, 300, 200));
+
+    KisSketchPointsGrid grid(CELL_SIZE);
+    fillGrid(&grid, points);
+
+    QString error;
+    for (int i = 0; i < 100; i++) {
+        const QRectF rect(points[i] - QPointF(20, 20), QSizeF(40, 40));
+        QVERIFY2(checkQuery(grid, points, rect, &error), error.toLatin1());
+    }
+
+    QVERIFY2(checkQuery(grid, points, QRectF(-10, -10, 20, 20), &error), error.toLatin1());
+    QVERIFY2(checkQuery(grid, points, QRectF(-100, -80, 30, 30), &error), error.toLatin1());
+}
+
+void KisSketchPointsGridTest::testCellBorders()
+{
+    QVector<QPointF> points;
+
+    for (int y = -3; y <= 3; y++) {
+        for (int x = -3; x <= 3; x++) {
+            points << QPointF(x * CELL_SIZE, y * CELL_SIZE);
+        }
+    }
+
+    KisSketchPointsGrid grid(CELL_SIZE);
+    fillGrid(&grid, points);
+
+    QString error;
+
+    // the borders of the rects lie exactly on the borders of the cells
+    QVERIFY2(checkQuery(grid, points, QRectF(0, 0, CELL_SIZE, CELL_SIZE), &error), error.toLatin1());
+    QVERIFY2(checkQuery(grid, points, QRectF(-CELL_SIZE, -CELL_SIZE, CELL_SIZE, CELL_SIZE), &error), error.toLatin1());
+    QVERIFY2(checkQuery(grid, points, QRectF(-2 * CELL_SIZE, CELL_SIZE, 3 * CELL_SIZE, CELL_SIZE), &error), error.toLatin1());
+
+    // the rects end just before or start just after the border
+    const qreal eps = 1e-3;
+    QVERIFY2(checkQuery(grid, points, QRectF(eps, eps, CELL_SIZE - 2 * eps, CELL_SIZE - 2 * eps), &error), error.toLatin1());
+    QVERIFY2(checkQuery(grid, points, QRectF(-CELL_SIZE - eps, -CELL_SIZE - eps, 2 * eps, 2 * eps), &error), error.toLatin1());
+}
+
+void KisSketchPointsGridTest::testHugeQueryRect()
+{
+    const QVector<QPointF> points = randomPoints(100, QRectF(-1000, -1000, 2000, 2000));
+
+    KisSketchPointsGrid grid(CELL_SIZE);
+    fillGrid(&grid, points);
+
+    QString error;
+
+    /**
+     * These rects cover more cells than the grid has, so the grid
+     * walks through its own cells instead of the cells of the rect
+     */
+    const QRectF wholeRect(-1e6, -1e6, 2e6, 2e6);
+    QVERIFY2(checkQuery(grid, points, wholeRect, &error), error.toLatin1());
+    QVERIFY2(checkQuery(grid, points, QRectF(0, -1e6, 1e6, 2e6), &error), error.toLatin1());
+    QVERIFY2(checkQuery(grid, points, QRectF(-1e6, -1e6, 1e6, 1e6), &error), error.toLatin1());
+
+    QVector<int> indexes;
+    grid.queryRect(wholeRect, &indexes);
+    QCOMPARE(indexes.size(), points.size());
+
+    grid.queryRect(QRectF(0, -1e6, 1e6, 2e6), &indexes);
+    QVERIFY(indexes.size() < points.size());
+}
+
+QTEST_MAIN(KisSketchPointsGridTest)
@@ -57,16 +57,28 @@ void selectByColor(KisPaintDeviceSP dev, KisPixelSelectionSP selection, const qu
     KisHLineConstIteratorSP hiter = dev->createHLineConstIteratorNG(x, y, w);
     KisHLineIteratorSP selIter = selection->createHLineIteratorNG(x, y, w);
 
+    QVector<quint8> differences(w);
+
     for (int row = y; row < y + h; ++row) {
-        do {
-            //if (dev->colorSpace()->hasAlpha())
-            //    opacity = dev->colorSpace()->alpha(hiter->rawData());
-            quint8 match = cs->difference(c, hiter->oldRawData());
-            if (match <= fuzziness) {
-                *(selIter->rawData()) = MAX_SELECTED;
+        qint32 columnsLeft = w;
+
+        while (columnsLeft > 0) {
+            const qint32 numPixels = qMin(columnsLeft, qMin(hiter->nConseqPixels(), selIter->nConseqPixels()));
+
+            cs->differences(c, hiter->oldRawData(), differences.data(), numPixels);
+
+            quint8 *selPtr = selIter->rawData();
+            for (qint32 i = 0; i < numPixels; i++) {
+                if (differences[i] <= fuzziness) {
+                    selPtr[i] = MAX_SELECTED;
+                }
             }
+
+            hiter->nextPixels(numPixels);
+            selIter->nextPixels(numPixels);
+            columnsLeft -= numPixels;
         }
-        while (hiter->nextPixel() && selIter->nextPixel());
+
         hiter->nextRow();
         selIter->nextRow();
     }